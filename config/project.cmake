@@ -275,6 +275,13 @@ if(ENABLE_CALIPER)
   endif(ENABLE_MPI)
 endif(ENABLE_CALIPER)
 
+#------------------------------------------------------------------------------#
+# Task instrumentation
+#------------------------------------------------------------------------------#
+
+option(ENABLE_INSTRUMENTATION
+  "Enable the per-task counters and timers reported at finalization" OFF)
+
 #------------------------------------------------------------------------------#
 # Boost Program Options
 #------------------------------------------------------------------------------#
@@ -332,6 +339,19 @@ if (ENABLE_KOKKOS)
   set (FLECSI_ENABLE_KOKKOS TRUE)
 endif()
 
+#------------------------------------------------------------------------------#
+# Add option for OpenMP
+#------------------------------------------------------------------------------#
+
+option(ENABLE_OPENMP "Enable OpenMP tasks and kernels" OFF)
+
+if(ENABLE_OPENMP)
+  find_package(OpenMP REQUIRED)
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS}")
+  list(APPEND FLECSI_LIBRARY_DEPENDENCIES ${OpenMP_CXX_LIBRARIES})
+  set(FLECSI_ENABLE_OPENMP TRUE)
+endif()
+
 #------------------------------------------------------------------------------#
 # Runtime models
 #------------------------------------------------------------------------------#
@@ -488,6 +508,7 @@ set(FLECSI_ENABLE_METIS ENABLE_METIS)
 set(FLECSI_ENABLE_PARMETIS ENABLE_PARMETIS)
 set(FLECSI_ENABLE_GRAPHVIZ ${ENABLE_GRAPHVIZ})
 set(FLECSI_ENABLE_DYNAMIC_CONTROL_MODEL ${ENABLE_DYNAMIC_CONTROL_MODEL})
+set(FLECSI_ENABLE_INSTRUMENTATION ${ENABLE_INSTRUMENTATION})
 
 configure_file(${PROJECT_SOURCE_DIR}/config/flecsi-config.h.in
   ${CMAKE_BINARY_DIR}/flecsi-config.h @ONLY)
@@ -15,11 +15,44 @@
 
 /*! @file */
 
+#include <set>
+#include <vector>
+
 #include <flecsi/coloring/crs.h>
 
 namespace flecsi {
 namespace coloring {
 
+/*!
+ Tuning options for colorers. Vertex and edge weights are attached to the
+ graph itself, see \ref dcrs_t.
+
+ @ingroup coloring
+ */
+
+struct colorer_options_t {
+
+  //! The allowed load imbalance for each balance constraint, e.g., 1.05
+  //! allows the heaviest color to be 5% above the average. If empty, or
+  //! shorter than the number of constraints, 1.05 is used.
+  std::vector<double> imbalance_tolerance;
+
+  //! The seed for the random number generator of the colorer. If negative,
+  //! the colorer's default seed is used.
+  int seed = -1;
+
+  /*!
+   Return the imbalance tolerance for the given constraint.
+   */
+
+  double tolerance(size_t constraint) const {
+    return constraint < imbalance_tolerance.size()
+             ? imbalance_tolerance[constraint]
+             : 1.05;
+  } // tolerance
+
+}; // struct colorer_options_t
+
 /*!
  The colorer_t type provides an interface for creating distributed-memory
  colorings from a distributed, compressed-row storage graph representation.
@@ -43,6 +76,26 @@ struct colorer_t {
   virtual std::set<size_t> color(const dcrs_t & dcrs) = 0;
   virtual std::vector<size_t> new_color(const dcrs_t & dcrs) = 0;
 
+  /*!
+   Set the tuning options used by subsequent calls to \ref color and
+   \ref new_color.
+   */
+
+  void set_options(const colorer_options_t & options) {
+    options_ = options;
+  } // set_options
+
+  /*!
+   Return the current tuning options.
+   */
+
+  const colorer_options_t & options() const {
+    return options_;
+  } // options
+
+protected:
+  colorer_options_t options_;
+
 }; // class colorer_t
 
 } // namespace coloring
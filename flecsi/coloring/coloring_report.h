@@ -0,0 +1,325 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <flecsi/coloring/box_types.h>
+#include <flecsi/coloring/coloring_types.h>
+
+namespace flecsi {
+namespace coloring {
+
+/*!
+  Per-color quality metrics for a single index space.
+ */
+
+struct color_quality_t {
+
+  //! The color id.
+  size_t color = 0;
+
+  //! The number of exclusive indices.
+  size_t exclusive = 0;
+
+  //! The number of shared indices.
+  size_t shared = 0;
+
+  //! The number of ghost indices, i.e., the ghost volume of this color.
+  size_t ghost = 0;
+
+  //! The number of distinct colors this color communicates with.
+  size_t neighbors = 0;
+
+  /*!
+    Return the number of indices owned by this color.
+   */
+
+  size_t owned() const {
+    return exclusive + shared;
+  } // owned
+
+}; // struct color_quality_t
+
+/*!
+  Aggregate quality metrics for the coloring of a single index space.
+  The load imbalance is defined as the ratio of the maximum to the
+  average number of owned indices, so that a perfectly balanced coloring
+  has an imbalance of one.
+ */
+
+struct coloring_quality_t {
+
+  //! Per-color metrics, sorted by color id.
+  std::vector<color_quality_t> colors;
+
+  //! The total number of owned indices over all colors.
+  size_t owned = 0;
+
+  //! The total number of ghost indices over all colors.
+  size_t ghost = 0;
+
+  //! The maximum number of owned indices on any color.
+  size_t max_owned = 0;
+
+  //! The minimum number of owned indices on any color.
+  size_t min_owned = 0;
+
+  //! The average number of owned indices per color.
+  double avg_owned = 0.0;
+
+  //! The ratio of maximum to average owned indices.
+  double load_imbalance = 0.0;
+
+  //! The maximum ghost volume on any color.
+  size_t max_ghost = 0;
+
+  //! The average ghost volume per color.
+  double avg_ghost = 0.0;
+
+  //! The maximum number of neighbor colors for any color.
+  size_t max_neighbors = 0;
+
+  //! The average number of neighbor colors per color.
+  double avg_neighbors = 0.0;
+
+  //! The number of cut graph edges, if it was computed (see \ref edge_cut).
+  size_t edge_cut = std::numeric_limits<size_t>::max();
+
+  /*!
+    Return true if the edge cut has been set.
+   */
+
+  bool has_edge_cut() const {
+    return edge_cut != std::numeric_limits<size_t>::max();
+  } // has_edge_cut
+
+}; // struct coloring_quality_t
+
+/*!
+  Compute the quality metrics of a coloring from the per-color coloring
+  information, e.g., as returned by
+  \ref communicator_t::gather_coloring_info or stored in the context.
+
+  @param coloring_info A map of color id to coloring information.
+
+  @ingroup coloring
+ */
+
+inline coloring_quality_t
+analyze_coloring(
+  const std::unordered_map<size_t, coloring_info_t> & coloring_info) {
+  coloring_quality_t quality;
+
+  if(coloring_info.empty()) {
+    return quality;
+  } // if
+
+  quality.colors.reserve(coloring_info.size());
+  quality.min_owned = std::numeric_limits<size_t>::max();
+
+  size_t total_neighbors(0);
+
+  for(auto & ci : coloring_info) {
+    color_quality_t cq;
+    cq.color = ci.first;
+    cq.exclusive = ci.second.exclusive;
+    cq.shared = ci.second.shared;
+    cq.ghost = ci.second.ghost;
+
+    // The neighbors of a color are all of the colors that either
+    // consume our shared indices or own one of our ghosts.
+    std::set<size_t> neighbors(ci.second.shared_users);
+    neighbors.insert(
+      ci.second.ghost_owners.begin(), ci.second.ghost_owners.end());
+    neighbors.erase(ci.first);
+    cq.neighbors = neighbors.size();
+
+    quality.owned += cq.owned();
+    quality.ghost += cq.ghost;
+    quality.max_owned = std::max(quality.max_owned, cq.owned());
+    quality.min_owned = std::min(quality.min_owned, cq.owned());
+    quality.max_ghost = std::max(quality.max_ghost, cq.ghost);
+    quality.max_neighbors = std::max(quality.max_neighbors, cq.neighbors);
+    total_neighbors += cq.neighbors;
+
+    quality.colors.push_back(cq);
+  } // for
+
+  std::sort(quality.colors.begin(), quality.colors.end(),
+    [](const color_quality_t & a, const color_quality_t & b) {
+      return a.color < b.color;
+    });
+
+  const double colors = quality.colors.size();
+
+  quality.avg_owned = quality.owned / colors;
+  quality.avg_ghost = quality.ghost / colors;
+  quality.avg_neighbors = total_neighbors / colors;
+  quality.load_imbalance =
+    quality.avg_owned > 0.0 ? quality.max_owned / quality.avg_owned : 0.0;
+
+  return quality;
+} // analyze_coloring
+
+/*!
+  Return the number of indices contained in a box.
+ */
+
+template<size_t D>
+inline size_t
+box_size(const box_t<D> & box) {
+  size_t count(1);
+  for(size_t d(0); d < D; ++d) {
+    if(box.upperbnd[d] < box.lowerbnd[d]) {
+      return 0;
+    } // if
+
+    count *= box.upperbnd[d] - box.lowerbnd[d] + 1;
+  } // for
+  return count;
+} // box_size
+
+/*!
+  Convert a box coloring, e.g., as produced by \ref simple_box_colorer_t,
+  into the aggregate coloring information used by the unstructured
+  colorers so that both can be analyzed with \ref analyze_coloring.
+
+  @param colbox The box coloring of the calling color.
+
+  @ingroup coloring
+ */
+
+template<size_t D>
+inline coloring_info_t
+box_coloring_info(const box_coloring_info_t<D> & colbox) {
+  coloring_info_t info;
+
+  info.exclusive = box_size(colbox.exclusive.box);
+  info.shared = 0;
+  info.ghost = 0;
+
+  for(auto & s : colbox.shared) {
+    info.shared += box_size(s.box);
+    info.shared_users.insert(s.colors.begin(), s.colors.end());
+  } // for
+
+  for(auto & g : colbox.ghost) {
+    info.ghost += box_size(g.box);
+    info.ghost_owners.insert(g.colors.begin(), g.colors.end());
+  } // for
+
+  return info;
+} // box_coloring_info
+
+/*!
+  Write the quality metrics of a single coloring as a JSON object.
+
+  @param stream  The output stream.
+  @param quality The coloring quality to write.
+  @param indent  The indentation prefix for each line.
+
+  @ingroup coloring
+ */
+
+inline std::ostream &
+write_json(std::ostream & stream,
+  const coloring_quality_t & quality,
+  const std::string & indent = "") {
+  const std::string in1 = indent + "  ";
+  const std::string in2 = in1 + "  ";
+
+  stream << "{" << std::endl;
+  stream << in1 << "\"colors\": " << quality.colors.size() << "," << std::endl;
+  stream << in1 << "\"owned\": " << quality.owned << "," << std::endl;
+  stream << in1 << "\"ghost\": " << quality.ghost << "," << std::endl;
+  stream << in1 << "\"min_owned\": " << quality.min_owned << "," << std::endl;
+  stream << in1 << "\"max_owned\": " << quality.max_owned << "," << std::endl;
+  stream << in1 << "\"avg_owned\": " << quality.avg_owned << "," << std::endl;
+  stream << in1 << "\"load_imbalance\": " << quality.load_imbalance << ","
+         << std::endl;
+  stream << in1 << "\"max_ghost\": " << quality.max_ghost << "," << std::endl;
+  stream << in1 << "\"avg_ghost\": " << quality.avg_ghost << "," << std::endl;
+  stream << in1 << "\"max_neighbors\": " << quality.max_neighbors << ","
+         << std::endl;
+  stream << in1 << "\"avg_neighbors\": " << quality.avg_neighbors << ","
+         << std::endl;
+
+  if(quality.has_edge_cut()) {
+    stream << in1 << "\"edge_cut\": " << quality.edge_cut << "," << std::endl;
+  } // if
+
+  stream << in1 << "\"per_color\": [";
+
+  bool first(true);
+  for(auto & c : quality.colors) {
+    stream << (first ? "" : ",") << std::endl;
+    stream << in2 << "{ \"color\": " << c.color
+           << ", \"exclusive\": " << c.exclusive
+           << ", \"shared\": " << c.shared << ", \"ghost\": " << c.ghost
+           << ", \"neighbors\": " << c.neighbors << " }";
+    first = false;
+  } // for
+
+  stream << std::endl << in1 << "]" << std::endl;
+  stream << indent << "}";
+
+  return stream;
+} // write_json
+
+/*!
+  Write the quality metrics of several colorings, e.g., one per index
+  space, as a single JSON object keyed by index space id.
+
+  @param stream    The output stream.
+  @param qualities A map of index space id to coloring quality.
+
+  @ingroup coloring
+ */
+
+inline std::ostream &
+write_json(std::ostream & stream,
+  const std::map<size_t, coloring_quality_t> & qualities) {
+  stream << "{";
+
+  bool first(true);
+  for(auto & q : qualities) {
+    stream << (first ? "" : ",") << std::endl;
+    stream << "  \"" << q.first << "\": ";
+    write_json(stream, q.second, "  ");
+    first = false;
+  } // for
+
+  stream << std::endl << "}" << std::endl;
+
+  return stream;
+} // write_json
+
+inline std::ostream &
+operator<<(std::ostream & stream, const coloring_quality_t & quality) {
+  return write_json(stream, quality);
+} // operator <<
+
+} // namespace coloring
+} // namespace flecsi
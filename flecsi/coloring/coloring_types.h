@@ -18,6 +18,8 @@
 #include <set>
 #include <vector>
 
+#include <flecsi/utils/flat_set.h>
+
 namespace flecsi {
 namespace coloring {
 
@@ -73,7 +75,7 @@ struct entity_info_t {
   size_t id;
   size_t rank;
   size_t offset;
-  std::set<size_t> shared;
+  utils::flat_set_u<size_t> shared;
 
   /*!
    Constructor.
@@ -88,8 +90,8 @@ struct entity_info_t {
   entity_info_t(size_t id_ = 0,
     size_t rank_ = 0,
     size_t offset_ = 0,
-    std::set<size_t> shared_ = {})
-    : id(id_), rank(rank_), offset(offset_), shared(shared_) {}
+    utils::flat_set_u<size_t> shared_ = {})
+    : id(id_), rank(rank_), offset(offset_), shared(std::move(shared_)) {}
 
   /*!
    Constructor.
@@ -244,20 +244,83 @@ operator<<(std::ostream & stream, const crs_t & crs) {
 /*!
  This type is a container for distrinuted compressed-storage of sparse data.
 
- @var distribution The index ranges for each color.
+ @var distribution    The index ranges for each color.
+ @var vertex_weights  Optional vertex weights with \ref num_constraints
+                      entries per local row, stored row by row. If empty,
+                      all vertices have unit weight.
+ @var edge_weights    Optional edge weights with one entry for each
+                      entry of \ref indices. If empty, all edges have unit
+                      weight.
+ @var num_constraints The number of weights per vertex, i.e., the number
+                      of balance constraints. This must be the same on
+                      all colors.
 
  @ingroup coloring
  */
 
 struct dcrs_t : public crs_t {
   std::vector<size_t> distribution;
+  std::vector<size_t> vertex_weights;
+  std::vector<size_t> edge_weights;
+  size_t num_constraints = 1;
 
-  define_as(distribution)
+  define_as(distribution);
+  define_as(vertex_weights);
+  define_as(edge_weights);
 
-    /// \brief clears the current storage
-    void clear() {
+  bool has_vertex_weights() const {
+    return !vertex_weights.empty();
+  } // has_vertex_weights
+
+  bool has_edge_weights() const {
+    return !edge_weights.empty();
+  } // has_edge_weights
+
+  /// \brief erase a bunch of ids, along with their weights
+  void erase(const std::vector<size_t> & ids) {
+
+    if(ids.empty())
+      return;
+
+    if(has_vertex_weights() || has_edge_weights()) {
+      std::vector<size_t> new_vertex_weights;
+      std::vector<size_t> new_edge_weights;
+      auto delete_it = ids.begin();
+
+      for(size_t i = 0; i < size(); ++i) {
+
+        // skip deleted items
+        if(delete_it != ids.end() && *delete_it == i) {
+          delete_it++;
+          continue;
+        }
+
+        if(has_vertex_weights()) {
+          auto w = vertex_weights.begin() + i * num_constraints;
+          new_vertex_weights.insert(
+            new_vertex_weights.end(), w, w + num_constraints);
+        }
+
+        if(has_edge_weights()) {
+          new_edge_weights.insert(new_edge_weights.end(),
+            edge_weights.begin() + offsets[i],
+            edge_weights.begin() + offsets[i + 1]);
+        }
+      }
+
+      std::swap(vertex_weights, new_vertex_weights);
+      std::swap(edge_weights, new_edge_weights);
+    }
+
+    crs_t::erase(ids);
+  }
+
+  /// \brief clears the current storage
+  void clear() {
     crs_t::clear();
     distribution.clear();
+    vertex_weights.clear();
+    edge_weights.clear();
   }
 
 }; // struct dcrs_t
@@ -275,6 +338,20 @@ operator<<(std::ostream & stream, const dcrs_t & dcrs) {
     stream << i << " ";
   } // for
 
+  if(dcrs.has_vertex_weights()) {
+    stream << std::endl << "vertex weights: ";
+    for(auto i : dcrs.vertex_weights) {
+      stream << i << " ";
+    } // for
+  } // if
+
+  if(dcrs.has_edge_weights()) {
+    stream << std::endl << "edge weights: ";
+    for(auto i : dcrs.edge_weights) {
+      stream << i << " ";
+    } // for
+  } // if
+
   return stream;
 } // operator <<
 
@@ -23,7 +23,9 @@
 
 #include <mpi.h>
 
+#include <cstring>
 #include <map>
+#include <vector>
 
 #include <flecsi/coloring/crs.h>
 #include <flecsi/topology/closure_utils.h>
@@ -349,6 +351,80 @@ alltoallv(const SEND_TYPE & sendbuf,
   return ret;
 }
 
+/*!
+  Exchange variable-length byte buffers with all other ranks.
+
+  @param sendbufs One buffer per destination rank.
+
+  @return One buffer per source rank.
+ */
+
+inline std::vector<std::vector<unsigned char>>
+exchange(const std::vector<std::vector<unsigned char>> & sendbufs) {
+  const size_t comm_size = sendbufs.size();
+  const auto mpi_size_t = utils::mpi_typetraits_u<size_t>::type();
+
+  std::vector<size_t> sendcounts(comm_size);
+  std::vector<size_t> senddispls(comm_size + 1, 0);
+
+  for(size_t r = 0; r < comm_size; ++r) {
+    sendcounts[r] = sendbufs[r].size();
+    senddispls[r + 1] = senddispls[r] + sendcounts[r];
+  } // for
+
+  std::vector<unsigned char> sendbuf;
+  sendbuf.reserve(senddispls[comm_size]);
+  for(auto & b : sendbufs)
+    sendbuf.insert(sendbuf.end(), b.begin(), b.end());
+
+  std::vector<size_t> recvcounts(comm_size);
+  auto ret = MPI_Alltoall(sendcounts.data(), 1, mpi_size_t, recvcounts.data(),
+    1, mpi_size_t, MPI_COMM_WORLD);
+  if(ret != MPI_SUCCESS)
+    clog_error("Error communicating buffer sizes");
+
+  std::vector<size_t> recvdispls(comm_size + 1, 0);
+  for(size_t r = 0; r < comm_size; ++r)
+    recvdispls[r + 1] = recvdispls[r] + recvcounts[r];
+
+  std::vector<unsigned char> recvbuf(recvdispls[comm_size]);
+
+  ret = alltoallv(sendbuf, sendcounts, senddispls, recvbuf, recvcounts,
+    recvdispls, MPI_COMM_WORLD);
+  if(ret != MPI_SUCCESS)
+    clog_error("Error communicating buffers");
+
+  std::vector<std::vector<unsigned char>> recvbufs(comm_size);
+  for(size_t r = 0; r < comm_size; ++r)
+    recvbufs[r].assign(
+      recvbuf.begin() + recvdispls[r], recvbuf.begin() + recvdispls[r + 1]);
+
+  return recvbufs;
+} // exchange
+
+/*!
+  Exchange lists of ids with all other ranks.
+ */
+
+inline std::vector<std::vector<size_t>>
+exchange(const std::vector<std::vector<size_t>> & sendids) {
+  std::vector<std::vector<unsigned char>> sendbufs(sendids.size());
+
+  for(size_t r = 0; r < sendids.size(); ++r)
+    topology::cast_insert(sendids[r].data(), sendids[r].size(), sendbufs[r]);
+
+  auto recvbufs = exchange(sendbufs);
+
+  std::vector<std::vector<size_t>> recvids(recvbufs.size());
+  for(size_t r = 0; r < recvbufs.size(); ++r) {
+    recvids[r].resize(recvbufs[r].size() / sizeof(size_t));
+    if(recvids[r].size())
+      std::memcpy(recvids[r].data(), recvbufs[r].data(), recvbufs[r].size());
+  } // for
+
+  return recvids;
+} // exchange
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \brief Simple utility for determining which rank owns an id
 ////////////////////////////////////////////////////////////////////////////////
@@ -756,6 +832,16 @@ migrate(size_t dimension,
   senddispls[0] = 0;
   auto num_elements = dcrs.size();
 
+  // the mpi data type for size_t
+  const auto mpi_size_t = utils::mpi_typetraits_u<size_t>::type();
+
+  // Weights travel with their entities. Since a rank may have no entities
+  // left, everyone needs to agree on whether there are any weights.
+  int has_weights[2] = {dcrs.has_vertex_weights(), dcrs.has_edge_weights()};
+  MPI_Allreduce(
+    MPI_IN_PLACE, has_weights, 2, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+  const auto ncon = dcrs.num_constraints;
+
   // Find the indices we need torequest.
   for(size_t rank(0); rank < comm_size; ++rank) {
 
@@ -786,6 +872,13 @@ migrate(size_t dimension,
         auto num_offsets = dcrs.offsets[local_id + 1] - start;
         topology::cast_insert(&num_offsets, 1, sendbuf);
         topology::cast_insert(&dcrs.indices[start], num_offsets, sendbuf);
+        // weights
+        if(has_weights[0])
+          topology::cast_insert(
+            &dcrs.vertex_weights[local_id * ncon], ncon, sendbuf);
+        if(has_weights[1])
+          topology::cast_insert(
+            &dcrs.edge_weights[start], num_offsets, sendbuf);
         // now specific info related to mesh
         md.pack(dimension, local_id, sendbuf);
       }
@@ -822,9 +915,6 @@ migrate(size_t dimension,
   // Send information.
   //----------------------------------------------------------------------------
 
-  // the mpi data type for size_t
-  const auto mpi_size_t = utils::mpi_typetraits_u<size_t>::type();
-
   std::vector<size_t> recvcounts(comm_size, 0);
   auto ret = MPI_Alltoall(sendcounts.data(), 1, mpi_size_t, recvcounts.data(),
     1, mpi_size_t, MPI_COMM_WORLD);
@@ -882,6 +972,16 @@ migrate(size_t dimension,
       dcrs.indices.resize(dcrs.indices.size() + num_offsets);
       topology::uncast(buffer, num_offsets, &dcrs.indices[last]);
 
+      // weights
+      if(has_weights[0]) {
+        dcrs.vertex_weights.resize(dcrs.vertex_weights.size() + ncon);
+        topology::uncast(buffer, ncon, &dcrs.vertex_weights[local_id * ncon]);
+      }
+      if(has_weights[1]) {
+        dcrs.edge_weights.resize(dcrs.edge_weights.size() + num_offsets);
+        topology::uncast(buffer, num_offsets, &dcrs.edge_weights[last]);
+      }
+
       // now specific info related to mesh
       md.unpack(dimension, local_id, buffer);
 
@@ -936,6 +1036,9 @@ get_owner_info(const dcrs_t & dcrs,
   // keep track of shared ranks
   std::set<size_t> shared_ranks;
 
+  // ghosts are discovered out of order, so they are inserted all at once
+  std::vector<entity_info_t> ghosts;
+
   for(size_t local_id = 0; local_id < num_entities; ++local_id) {
 
     // determine clobal id
@@ -953,15 +1056,9 @@ get_owner_info(const dcrs_t & dcrs,
         // create possible new ghost
         // auto ghost_id = num_entities+num_ghost;
         auto ghost_id = neighbor - dcrs.distribution[rank];
-        auto e = entity_info_t(neighbor, rank, ghost_id, comm_rank);
-        // search for it
-        auto it = entities.ghost.find(e);
-        // if it has not been added, then add it!
-        if(it == entities.ghost.end()) {
-          entities.ghost.emplace(e);
-          color_info.ghost_owners.insert(rank);
-          // num_ghost++;
-        }
+        // duplicates are removed when inserting into the ghost set
+        ghosts.emplace_back(neighbor, rank, ghost_id, comm_rank);
+        color_info.ghost_owners.insert(rank);
         // keep track of shared ranks for the parent cell
         shared_ranks.emplace(rank);
       }
@@ -979,12 +1076,233 @@ get_owner_info(const dcrs_t & dcrs,
     }
   }
 
+  entities.ghost.insert(ghosts.begin(), ghosts.end());
+
   // store the sizes of each set
   color_info.exclusive = entities.exclusive.size();
   color_info.shared = entities.shared.size();
   color_info.ghost = entities.ghost.size();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Convert a primary coloring into a partitioning of the dcrs rows
+///
+/// Colorers like parmetis_colorer_t::color or naive_coloring return the set
+/// of global ids owned by the calling rank. This routine sends those ids to
+/// the ranks that store them in the dcrs distribution so that each dcrs row
+/// is tagged with its new owner, i.e., the same format as returned by
+/// colorer_t::new_color.
+////////////////////////////////////////////////////////////////////////////////
+inline std::vector<size_t>
+partitioning_from_primary(const dcrs_t & dcrs,
+  const std::set<size_t> & primary) {
+
+  int comm_size, comm_rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &comm_rank);
+
+  const auto mpi_size_t = utils::mpi_typetraits_u<size_t>::type();
+
+  // bin the primary ids by the rank that stores them in the dcrs
+  std::vector<size_t> sendcounts(comm_size, 0);
+  for(auto id : primary)
+    sendcounts[rank_owner(dcrs.distribution, id)]++;
+
+  std::vector<size_t> senddispls(comm_size + 1, 0);
+  for(size_t r = 0; r < comm_size; ++r)
+    senddispls[r + 1] = senddispls[r] + sendcounts[r];
+
+  // primary is sorted, so the ids are already grouped by owner
+  std::vector<size_t> sendbuf(primary.begin(), primary.end());
+
+  std::vector<size_t> recvcounts(comm_size, 0);
+  auto ret = MPI_Alltoall(sendcounts.data(), 1, mpi_size_t, recvcounts.data(),
+    1, mpi_size_t, MPI_COMM_WORLD);
+  if(ret != MPI_SUCCESS)
+    clog_error("Error communicating primary counts");
+
+  std::vector<size_t> recvdispls(comm_size + 1, 0);
+  for(size_t r = 0; r < comm_size; ++r)
+    recvdispls[r + 1] = recvdispls[r] + recvcounts[r];
+  std::vector<size_t> recvbuf(recvdispls[comm_size]);
+
+  ret = alltoallv(sendbuf, sendcounts, senddispls, recvbuf, recvcounts,
+    recvdispls, MPI_COMM_WORLD);
+  if(ret != MPI_SUCCESS)
+    clog_error("Error communicating primary ids");
+
+  // tag each of our rows with the rank that claimed it
+  std::vector<size_t> partitioning(
+    dcrs.size(), std::numeric_limits<size_t>::max());
+  const auto start = dcrs.distribution[comm_rank];
+
+  for(size_t r = 0; r < comm_size; ++r)
+    for(auto i = recvdispls[r]; i < recvdispls[r + 1]; ++i)
+      partitioning[recvbuf[i] - start] = r;
+
+  return partitioning;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Partition a distributed list of weighted entities into equal-weight
+///        pieces
+///
+/// The entities are taken in rank-major order, i.e., all of rank 0's
+/// entities in local order, followed by rank 1's, and so on. The running sum
+/// of the weights is cut into comm_size pieces of equal weight, so that
+/// entities only move between neighboring ranks in this order. This requires
+/// no graph information and is useful to rebalance an existing coloring whose
+/// local order already has good locality.
+///
+/// \param weights  The weight of each local entity.
+///
+/// \return The new owner of each local entity.
+////////////////////////////////////////////////////////////////////////////////
+inline std::vector<size_t>
+weighted_partitioning(const std::vector<double> & weights) {
+
+  int comm_size, comm_rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &comm_rank);
+
+  double local_weight = 0.0;
+  for(auto w : weights)
+    local_weight += w;
+
+  double offset = 0.0;
+  double total_weight = 0.0;
+  MPI_Exscan(
+    &local_weight, &offset, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(
+    &local_weight, &total_weight, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+  // MPI_Exscan leaves the receive buffer undefined on rank 0
+  if(comm_rank == 0)
+    offset = 0.0;
+
+  std::vector<size_t> partitioning(weights.size(), comm_rank);
+
+  if(total_weight <= 0.0)
+    return partitioning;
+
+  const double target = total_weight / comm_size;
+
+  for(size_t i = 0; i < weights.size(); ++i) {
+    // assign each entity by the midpoint of its weight interval
+    const double mid = offset + 0.5 * weights[i];
+    partitioning[i] = std::min(size_t(mid / target), size_t(comm_size - 1));
+    offset += weights[i];
+  } // for
+
+  return partitioning;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Compute the global edge cut of a partitioning of the dcrs graph
+///
+/// \param dcrs          The distributed graph.
+/// \param partitioning  The new owner of each local dcrs row, e.g., as
+///                      returned by colorer_t::new_color or
+///                      partitioning_from_primary.
+///
+/// \return The number of undirected graph edges whose endpoints belong to
+///         different colors. The result is the same on all ranks.
+////////////////////////////////////////////////////////////////////////////////
+inline size_t
+edge_cut(const dcrs_t & dcrs, const std::vector<size_t> & partitioning) {
+
+  int comm_size, comm_rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &comm_rank);
+
+  const auto mpi_size_t = utils::mpi_typetraits_u<size_t>::type();
+  const auto start = dcrs.distribution[comm_rank];
+  const auto num_entities = dcrs.size();
+
+  clog_assert(partitioning.size() == num_entities,
+    "partitioning does not match the number of dcrs rows");
+
+  //----------------------------------------------------------------------------
+  // Request the partition of every off-rank neighbor.
+  //----------------------------------------------------------------------------
+
+  std::vector<std::set<size_t>> requests(comm_size);
+  for(auto j : dcrs.indices) {
+    auto rank = rank_owner(dcrs.distribution, j);
+    if(rank != comm_rank)
+      requests[rank].insert(j);
+  } // for
+
+  std::vector<size_t> sendcounts(comm_size, 0);
+  std::vector<size_t> senddispls(comm_size + 1, 0);
+  std::vector<size_t> sendbuf;
+
+  for(size_t r = 0; r < comm_size; ++r) {
+    sendbuf.insert(sendbuf.end(), requests[r].begin(), requests[r].end());
+    sendcounts[r] = requests[r].size();
+    senddispls[r + 1] = senddispls[r] + sendcounts[r];
+  } // for
+
+  std::vector<size_t> recvcounts(comm_size, 0);
+  auto ret = MPI_Alltoall(sendcounts.data(), 1, mpi_size_t, recvcounts.data(),
+    1, mpi_size_t, MPI_COMM_WORLD);
+  if(ret != MPI_SUCCESS)
+    clog_error("Error communicating request counts");
+
+  std::vector<size_t> recvdispls(comm_size + 1, 0);
+  for(size_t r = 0; r < comm_size; ++r)
+    recvdispls[r + 1] = recvdispls[r] + recvcounts[r];
+  std::vector<size_t> recvbuf(recvdispls[comm_size]);
+
+  ret = alltoallv(sendbuf, sendcounts, senddispls, recvbuf, recvcounts,
+    recvdispls, MPI_COMM_WORLD);
+  if(ret != MPI_SUCCESS)
+    clog_error("Error communicating requested ids");
+
+  //----------------------------------------------------------------------------
+  // Answer the requests with our partitioning, and receive the answers in
+  // the same layout as the original requests.
+  //----------------------------------------------------------------------------
+
+  for(auto & id : recvbuf)
+    id = partitioning[id - start];
+
+  std::vector<size_t> answers(sendbuf.size());
+  ret = alltoallv(recvbuf, recvcounts, recvdispls, answers, sendcounts,
+    senddispls, MPI_COMM_WORLD);
+  if(ret != MPI_SUCCESS)
+    clog_error("Error communicating partitions");
+
+  std::map<size_t, size_t> remote_partitioning;
+  for(size_t i = 0; i < sendbuf.size(); ++i)
+    remote_partitioning.emplace(sendbuf[i], answers[i]);
+
+  //----------------------------------------------------------------------------
+  // Count the cut edges. Each edge is seen from both of its endpoints.
+  //----------------------------------------------------------------------------
+
+  size_t local_cut = 0;
+
+  for(size_t local_id = 0; local_id < num_entities; ++local_id) {
+    auto part = partitioning[local_id];
+    for(auto i = dcrs.offsets[local_id]; i < dcrs.offsets[local_id + 1]; ++i) {
+      auto neighbor = dcrs.indices[i];
+      auto rank = rank_owner(dcrs.distribution, neighbor);
+      auto neighbor_part = rank == comm_rank
+                             ? partitioning[neighbor - start]
+                             : remote_partitioning.at(neighbor);
+      if(neighbor_part != part)
+        local_cut++;
+    } // for
+  } // for
+
+  size_t global_cut = 0;
+  MPI_Allreduce(
+    &local_cut, &global_cut, 1, mpi_size_t, MPI_SUM, MPI_COMM_WORLD);
+
+  return global_cut / 2;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \brief Color an auxiliary index space like vertices or edges
 ////////////////////////////////////////////////////////////////////////////////
@@ -1419,13 +1737,16 @@ color_entities(const flecsi::coloring::crs_t & cells2entity,
   // Now we can set exclusive, shared and ghost
   //----------------------------------------------------------------------------
 
-  // exclusive
+  // exclusive, which are not necessarily in global id order
+  std::vector<entity_info_t> exclusive_entities;
   for(size_t local_id = 0; local_id < num_ents; ++local_id) {
     if(exclusive[local_id]) {
       auto global_id = local2global[local_id];
-      entities.exclusive.emplace(global_id, comm_rank, local_id);
+      exclusive_entities.emplace_back(global_id, comm_rank, local_id);
     }
   }
+  entities.exclusive.insert(
+    exclusive_entities.begin(), exclusive_entities.end());
 
   // shared and ghost
   for(const auto pair : entities2rank) {
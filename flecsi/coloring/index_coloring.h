@@ -16,6 +16,7 @@
 /*! @file */
 
 #include <cassert>
+#include <set>
 #include <unordered_map>
 #include <vector>
 
@@ -37,14 +38,14 @@ struct index_coloring_t {
   // Set of mesh ids of the primary coloring
   std::set<size_t> primary;
 
-  // Set of entity_info_t type of the exclusive coloring
-  std::set<entity_info_t> exclusive;
+  // Sorted set of entity_info_t type of the exclusive coloring
+  utils::flat_set_u<entity_info_t> exclusive;
 
-  // Set of entity_info_t type of the shared coloring
-  std::set<entity_info_t> shared;
+  // Sorted set of entity_info_t type of the shared coloring
+  utils::flat_set_u<entity_info_t> shared;
 
-  // Set of entity_info_t type of the ghost coloring
-  std::set<entity_info_t> ghost;
+  // Sorted set of entity_info_t type of the ghost coloring
+  utils::flat_set_u<entity_info_t> ghost;
 
   // Rank id to number of entities
   std::unordered_map<size_t, size_t> entities_per_rank;
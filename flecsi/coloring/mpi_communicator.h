@@ -94,7 +94,8 @@ public:
    @ingroup coloring
    */
 
-  std::vector<size_t> get_info_indices(const std::set<size_t> & request_indices,
+  std::vector<size_t> get_info_indices(
+    const utils::flat_set_u<size_t> & request_indices,
     size_t max_request_indices,
     int colors) {
     // Pad the request indices with size_t max. We will then set
@@ -138,16 +139,12 @@ public:
    @ingroup coloring
   */
 
-  std::pair<std::vector<std::set<size_t>>, std::set<entity_info_t>>
+  std::pair<std::vector<std::set<size_t>>, utils::flat_set_u<entity_info_t>>
   get_primary_info(const std::set<size_t> & primary,
-    const std::set<size_t> & request_indices) override {
+    const utils::flat_set_u<size_t> & request_indices) override {
     auto colors = size();
     auto color = rank();
 
-    // Store the request in a vector for indexed access below.
-    std::vector<size_t> request_indices_vector(
-      request_indices.begin(), request_indices.end());
-
     const auto mpi_size_t_type =
       flecsi::utils::mpi_typetraits_u<size_t>::type();
 
@@ -182,6 +179,9 @@ public:
     // on indices that are shared with other processes.
     std::vector<std::set<size_t>> local(primary.size());
 
+    // A flat copy of the primary set gives constant-time offsets below.
+    const utils::flat_set_u<size_t> flat_primary(primary);
+
     // See if we can fill any requests...
     for(size_t r(0); r < colors; ++r) {
 
@@ -198,13 +198,13 @@ public:
       // See which requests we can fulfill.
       for(size_t i(0); i < max_request_indices; ++i) {
 
-        auto match = primary.find(info[i]);
+        auto match = flat_primary.find(info[i]);
 
-        if(match != primary.end()) {
+        if(match != flat_primary.end()) {
           // This is a match, i.e., we own this entity, so we can
           // set the rank (ownership) and offset.
           input[i] = color;
-          offset[i] = std::distance(primary.begin(), match);
+          offset[i] = std::distance(flat_primary.begin(), match);
 
           // We also need to register that this index is shared
           // with other ranks
@@ -223,7 +223,7 @@ public:
       MPI_Alltoall(&input_offsets[0], max_request_indices, mpi_size_t_type,
         &info_offsets[0], max_request_indices, mpi_size_t_type, MPI_COMM_WORLD);
 
-    std::set<entity_info_t> remote;
+    std::vector<entity_info_t> remote;
 
     // Collect all of the information for the remote entities.
     for(size_t r(0); r < colors; ++r) {
@@ -241,13 +241,14 @@ public:
         if(ranks[i] != std::numeric_limits<size_t>::max()) {
           // If this is not size_t max, this rank answered our request
           // and we can set the information.
-          remote.insert(
-            entity_info_t(request_indices_vector[i], ranks[i], offsets[i], {}));
+          remote.emplace_back(entity_info_t(
+            request_indices.begin()[i], ranks[i], offsets[i], {}));
         } // if
       } // for
     } // for
 
-    return std::make_pair(local, remote);
+    return std::make_pair(local,
+      utils::flat_set_u<entity_info_t>(remote.begin(), remote.end()));
   } // get_primary_info
 
   /*!
@@ -255,20 +256,17 @@ public:
 
    @param request_indices FIXME...
                           information.
-   @return A std::unordered_map<size_t, std::set<size_t>> FIXME ...
+   @return A std::unordered_map<size_t, utils::flat_set_u<size_t>> FIXME ...
 
    @ingroup coloring
   */
 
-  std::unordered_map<size_t, std::set<size_t>> get_intersection_info(
-    const std::set<size_t> & request_indices) override {
+  std::unordered_map<size_t, utils::flat_set_u<size_t>>
+  get_intersection_info(
+    const utils::flat_set_u<size_t> & request_indices) override {
     auto colors = size();
     auto color = rank();
 
-    // Store the request in a vector for indexed access below.
-    std::vector<size_t> request_indices_vector(
-      request_indices.begin(), request_indices.end());
-
     const auto mpi_size_t_type =
       flecsi::utils::mpi_typetraits_u<size_t>::type();
 
@@ -295,7 +293,7 @@ public:
     }
 
     //
-    std::unordered_map<size_t, std::set<size_t>> intersection_map;
+    std::unordered_map<size_t, utils::flat_set_u<size_t>> intersection_map;
 
     for(size_t r(0); r < colors; ++r) {
 
@@ -307,13 +305,13 @@ public:
       // Array slice for convenience.
       size_t * info = &info_indices[r * max_request_indices];
 
-      // Create a set of the off-color request indices.
-      std::set<size_t> intersection_set;
-      for(size_t i(0); i < max_request_indices; ++i) {
-        if(info[i] != std::numeric_limits<size_t>::max()) {
-          intersection_set.insert(info[i]);
-        } // if
-      } // for
+      // Create a set of the off-color request indices. They were sent in
+      // order and are followed by the padding, so the set is the prefix
+      // before the first padding value.
+      auto end = std::find(
+        info, info + max_request_indices, std::numeric_limits<size_t>::max());
+      const utils::flat_set_u<size_t> intersection_set(
+        utils::sorted_unique, std::vector<size_t>(info, end));
 
       {
         clog_tag_guard(mpi_communicator);
@@ -333,7 +331,7 @@ public:
 
       // If the intersection is non-empty, add it to the return map
       if(intersection.size()) {
-        intersection_map[r] = intersection;
+        intersection_map[r] = std::move(intersection);
       } // if
     } // for
 
@@ -396,7 +394,7 @@ public:
    */
 
   std::vector<std::set<size_t>> get_entity_info(
-    const std::set<entity_info_t> & entity_info,
+    const utils::flat_set_u<entity_info_t> & entity_info,
     const std::vector<std::set<size_t>> & request_indices) override {
     auto colors = size();
     auto color = rank();
@@ -15,7 +15,9 @@
 
 /*! @file */
 
+#include <limits>
 #include <set>
+#include <vector>
 
 #include <cinchlog.h>
 
@@ -30,6 +32,8 @@
 #include <flecsi/coloring/colorer.h>
 #include <flecsi/utils/mpi_type_traits.h>
 
+clog_register_tag(parmetis_colorer);
+
 namespace flecsi {
 namespace coloring {
 
@@ -74,64 +78,8 @@ struct parmetis_colorer_t : public colorer_t {
     // Call ParMETIS partitioner.
     //------------------------------------------------------------------------//
 
-    idx_t wgtflag = 0;
-    idx_t numflag = 0;
-    idx_t ncon = 1;
-    std::vector<real_t> tpwgts(size);
-
-    real_t sum = 0.0;
-    for(size_t i(0); i < tpwgts.size(); ++i) {
-      if(i == (tpwgts.size() - 1)) {
-        tpwgts[i] = 1.0 - sum;
-      }
-      else {
-        tpwgts[i] = 1.0 / size;
-        sum += tpwgts[i];
-      } // if
-
-#if 0
-      if(rank == 0) {
-        std::cout << tpwgts[i] << std::endl;
-      } // if
-#endif
-    } // for
-
-    // We may need to expose some of the ParMETIS configuration options.
-    real_t ubvec = 1.05;
-    idx_t options = 0;
-    idx_t edgecut;
-    MPI_Comm comm = MPI_COMM_WORLD;
-    std::vector<idx_t> part(dcrs.size(), std::numeric_limits<idx_t>::max());
-
-#if 0
-    const size_t output_rank(1);
-    if(rank == output_rank) {
-      std::cout << "rank " << rank << " dcrs: " << std::endl;
-      std::cout << "size: " << dcrs.size() << std::endl;
-      std::cout << dcrs << std::endl;
-    } // if
-#endif
-
-    //    std::set<size_t> ret;
-    //    return ret;
-
-    // Get the dCRS information using ParMETIS types.
+    std::vector<idx_t> part = partition(dcrs);
     std::vector<idx_t> vtxdist = dcrs.distribution_as<idx_t>();
-    std::vector<idx_t> xadj = dcrs.offsets_as<idx_t>();
-    std::vector<idx_t> adjncy = dcrs.indices_as<idx_t>();
-
-    // Actual call to ParMETIS.
-    int result = ParMETIS_V3_PartKway(&vtxdist[0], &xadj[0], &adjncy[0],
-      nullptr, nullptr, &wgtflag, &numflag, &ncon, &size, &tpwgts[0], &ubvec,
-      &options, &edgecut, &part[0], &comm);
-
-#if 0
-    std::cout << "rank " << rank << ": ";
-    for(size_t i(0); i<dcrs.size(); ++i) {
-      std::cout << "[" << part[i] << ", " << vtxdist[rank]+i << "] ";
-    } // for
-    std::cout << std::endl;
-#endif
 
     //------------------------------------------------------------------------//
     // Exchange information with other ranks.
@@ -176,7 +124,7 @@ struct parmetis_colorer_t : public colorer_t {
 
     // Do all-to-all to find out where everything belongs.
     std::vector<idx_t> recv_cnts(size);
-    result = MPI_Alltoall(&send_cnts[0], 1,
+    int result = MPI_Alltoall(&send_cnts[0], 1,
       utils::mpi_typetraits_u<idx_t>::type(), &recv_cnts[0], 1,
       utils::mpi_typetraits_u<idx_t>::type(), MPI_COMM_WORLD);
 
@@ -249,24 +197,76 @@ struct parmetis_colorer_t : public colorer_t {
    */
 
   std::vector<size_t> new_color(const dcrs_t & dcrs) override {
+    std::vector<idx_t> part = partition(dcrs);
+
+    std::vector<size_t> partitioning(part.begin(), part.end());
+
+    return partitioning;
+
+  } // color
+
+private:
+  /*!
+   Call ParMETIS to partition the graph, honoring the vertex and edge
+   weights of the graph and the colorer options.
+
+   @return The color of each local vertex.
+   */
+
+  std::vector<idx_t> partition(const dcrs_t & dcrs) {
     int size;
     int rank;
 
     MPI_Comm_size(MPI_COMM_WORLD, &size);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-    //------------------------------------------------------------------------//
-    // Call ParMETIS partitioner.
-    //------------------------------------------------------------------------//
-
-    idx_t wgtflag = 0;
+    idx_t ncon = dcrs.num_constraints;
+
+    clog_assert(ncon > 0, "number of constraints must be positive");
+    clog_assert(!dcrs.has_vertex_weights() ||
+                  dcrs.vertex_weights.size() == dcrs.size() * ncon,
+      "vertex weights do not match the number of vertices and constraints");
+    clog_assert(!dcrs.has_edge_weights() ||
+                  dcrs.edge_weights.size() == dcrs.indices.size(),
+      "edge weights do not match the number of edges");
+    clog_assert(ncon == 1 || dcrs.has_vertex_weights(),
+      "multiple constraints require vertex weights");
+
+    // 0: no weights, 1: edge weights only, 2: vertex weights only, 3: both
+    idx_t wgtflag =
+      (dcrs.has_vertex_weights() ? 2 : 0) + (dcrs.has_edge_weights() ? 1 : 0);
     idx_t numflag = 0;
-    idx_t ncon = 1;
-    std::vector<real_t> tpwgts(ncon * size, 1.0 / size);
 
-    // We may need to expose some of the ParMETIS configuration options.
-    std::vector<real_t> ubvec(ncon, 1.05);
+    // Equal target weights for every color and constraint. The last color
+    // takes the remainder so that the weights of each constraint sum to one.
+    std::vector<real_t> tpwgts(ncon * size);
+
+    for(idx_t c(0); c < ncon; ++c) {
+      real_t sum = 0.0;
+      for(int i(0); i < size; ++i) {
+        if(i == (size - 1)) {
+          tpwgts[i * ncon + c] = 1.0 - sum;
+        }
+        else {
+          tpwgts[i * ncon + c] = 1.0 / size;
+          sum += tpwgts[i * ncon + c];
+        } // if
+      } // for
+    } // for
+
+    std::vector<real_t> ubvec(ncon);
+    for(idx_t c(0); c < ncon; ++c) {
+      ubvec[c] = options_.tolerance(c);
+    } // for
+
+    // options[0] = 1 means that the remaining entries are used, i.e.,
+    // the debug level and the random seed.
     idx_t options[3] = {0, 0, 0};
+    if(options_.seed >= 0) {
+      options[0] = 1;
+      options[2] = options_.seed;
+    } // if
+
     idx_t edgecut;
     MPI_Comm comm = MPI_COMM_WORLD;
     std::vector<idx_t> part(dcrs.size(), std::numeric_limits<idx_t>::max());
@@ -275,19 +275,26 @@ struct parmetis_colorer_t : public colorer_t {
     std::vector<idx_t> vtxdist = dcrs.distribution_as<idx_t>();
     std::vector<idx_t> xadj = dcrs.offsets_as<idx_t>();
     std::vector<idx_t> adjncy = dcrs.indices_as<idx_t>();
+    std::vector<idx_t> vwgt = dcrs.vertex_weights_as<idx_t>();
+    std::vector<idx_t> adjwgt = dcrs.edge_weights_as<idx_t>();
 
     // Actual call to ParMETIS.
     int result = ParMETIS_V3_PartKway(&vtxdist[0], &xadj[0], &adjncy[0],
-      nullptr, nullptr, &wgtflag, &numflag, &ncon, &size, &tpwgts[0],
-      ubvec.data(), options, &edgecut, &part[0], &comm);
+      vwgt.empty() ? nullptr : vwgt.data(),
+      adjwgt.empty() ? nullptr : adjwgt.data(), &wgtflag, &numflag, &ncon,
+      &size, tpwgts.data(), ubvec.data(), options, &edgecut, part.data(),
+      &comm);
     if(result != METIS_OK)
       clog_error("Parmetis failed!");
 
-    std::vector<size_t> partitioning(part.begin(), part.end());
+    {
+      clog_tag_guard(parmetis_colorer);
+      clog(info) << "rank " << rank << " ParMETIS edge cut " << edgecut
+                 << std::endl;
+    } // guard
 
-    return partitioning;
-
-  } // color
+    return part;
+  } // partition
 
 }; // struct parmetis_colorer_t
 
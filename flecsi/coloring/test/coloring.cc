@@ -209,7 +209,7 @@ DEVEL(coloring) {
 
   // Assign vertex ownership
   std::vector<std::set<size_t>> vertex_requests(size);
-  std::set<entry_info_t> vertex_info;
+  flecsi::utils::flat_set_u<entry_info_t> vertex_info;
 
   size_t offset(0);
   for(auto i : vertex_closure) {
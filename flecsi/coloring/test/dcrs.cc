@@ -4,11 +4,18 @@
  *~-------------------------------------------------------------------------~~*/
 
 #include <cinchtest.h>
+#include <flecsi-config.h>
 #include <mpi.h>
 
+#include <flecsi/coloring/coloring_report.h>
 #include <flecsi/coloring/dcrs_utils.h>
+#include <flecsi/coloring/mpi_communicator.h>
 #include <flecsi/io/simple_definition.h>
 
+#if defined(FLECSI_ENABLE_PARMETIS)
+#include <flecsi/coloring/parmetis_colorer.h>
+#endif
+
 const size_t output_rank(0);
 
 TEST(dcrs, naive_coloring) {
@@ -59,6 +66,153 @@ TEST(dcrs, simple2d_16x16) {
 
 } // TEST
 
+TEST(dcrs, coloring_quality) {
+
+  flecsi::io::simple_definition_t sd("simple2d-8x8.msh");
+  auto dcrs = flecsi::coloring::make_dcrs(sd);
+
+  flecsi::coloring::index_coloring_t cells;
+  flecsi::coloring::coloring_info_t cell_color_info;
+  flecsi::coloring::get_owner_info(dcrs, cells, cell_color_info);
+
+  flecsi::coloring::mpi_communicator_t communicator;
+  auto coloring_info = communicator.gather_coloring_info(cell_color_info);
+
+  auto quality = flecsi::coloring::analyze_coloring(coloring_info);
+
+  // Note: These assume that this test is run with 5 ranks.
+  CINCH_ASSERT(EQ, quality.colors.size(), 5);
+  CINCH_ASSERT(EQ, quality.owned, 64);
+  CINCH_ASSERT(EQ, quality.min_owned, 12);
+  CINCH_ASSERT(EQ, quality.max_owned, 13);
+  CINCH_ASSERT(EQ, quality.max_neighbors, 2);
+
+  // The naive coloring assigns each row of the dcrs to its current rank.
+  auto naive = flecsi::coloring::naive_coloring<2, 2>(sd);
+  auto partitioning =
+    flecsi::coloring::partitioning_from_primary(dcrs, naive);
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  for(auto p : partitioning) {
+    CINCH_ASSERT(EQ, p, rank);
+  } // for
+
+  quality.edge_cut = flecsi::coloring::edge_cut(dcrs, partitioning);
+  CINCH_ASSERT(EQ, quality.edge_cut, 36);
+
+  // Everything on one color has no cut.
+  std::vector<size_t> single(dcrs.size(), 0);
+  CINCH_ASSERT(EQ, flecsi::coloring::edge_cut(dcrs, single), 0);
+
+  if(rank == output_rank) {
+    flecsi::coloring::write_json(std::cout, quality) << std::endl;
+  } // if
+
+} // TEST
+
+TEST(dcrs, erase_weights) {
+
+  flecsi::io::simple_definition_t sd("simple2d-8x8.msh");
+  auto dcrs = flecsi::coloring::make_dcrs(sd);
+
+  // Two constraints per vertex and one weight per edge, all derived from
+  // the global ids so that they can be checked after erasing.
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  const auto first = dcrs.distribution[rank];
+
+  dcrs.num_constraints = 2;
+  for(size_t i(0); i < dcrs.size(); ++i) {
+    dcrs.vertex_weights.push_back(1);
+    dcrs.vertex_weights.push_back(first + i);
+    for(auto j : dcrs[i]) {
+      dcrs.edge_weights.push_back(j);
+    } // for
+  } // for
+
+  std::vector<size_t> keep;
+  std::vector<size_t> erase;
+  for(size_t i(0); i < dcrs.size(); ++i) {
+    (i % 2 ? erase : keep).push_back(first + i);
+  } // for
+
+  std::vector<size_t> erase_local;
+  for(auto i : erase) {
+    erase_local.push_back(i - first);
+  } // for
+
+  dcrs.erase(erase_local);
+
+  ASSERT_EQ(dcrs.size(), keep.size());
+  ASSERT_EQ(dcrs.vertex_weights.size(), 2 * keep.size());
+  ASSERT_EQ(dcrs.edge_weights.size(), dcrs.indices.size());
+
+  for(size_t i(0); i < dcrs.size(); ++i) {
+    ASSERT_EQ(dcrs.vertex_weights[2 * i], 1);
+    ASSERT_EQ(dcrs.vertex_weights[2 * i + 1], keep[i]);
+  } // for
+
+  // Edge weights are the neighbor ids, so they must follow the indices.
+  ASSERT_EQ(dcrs.edge_weights, dcrs.indices);
+
+  dcrs.clear();
+  ASSERT_FALSE(dcrs.has_vertex_weights());
+  ASSERT_FALSE(dcrs.has_edge_weights());
+
+} // TEST
+
+#if defined(FLECSI_ENABLE_PARMETIS)
+
+TEST(dcrs, weighted_parmetis) {
+
+  flecsi::io::simple_definition_t sd("simple2d-8x8.msh");
+  auto dcrs = flecsi::coloring::make_dcrs(sd);
+
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // The cells of the lower half of the mesh are nine times as expensive.
+  const size_t heavy = 9;
+  const size_t num_cells = dcrs.distribution.back();
+  auto weight = [&](size_t id) { return id < num_cells / 2 ? heavy : 1; };
+
+  for(size_t i(0); i < dcrs.size(); ++i) {
+    dcrs.vertex_weights.push_back(weight(dcrs.distribution[rank] + i));
+  } // for
+
+  flecsi::coloring::parmetis_colorer_t colorer;
+  auto partitioning = colorer.new_color(dcrs);
+
+  std::vector<size_t> counts(size, 0), work(size, 0);
+  for(size_t i(0); i < dcrs.size(); ++i) {
+    counts[partitioning[i]]++;
+    work[partitioning[i]] += weight(dcrs.distribution[rank] + i);
+  } // for
+
+  const auto mpi_size_t = flecsi::utils::mpi_typetraits_u<size_t>::type();
+  MPI_Allreduce(
+    MPI_IN_PLACE, counts.data(), size, mpi_size_t, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(
+    MPI_IN_PLACE, work.data(), size, mpi_size_t, MPI_SUM, MPI_COMM_WORLD);
+
+  // The work is balanced within the tolerance, up to one cell, which an
+  // equal number of cells per color would not achieve.
+  const double average = (num_cells / 2 * (heavy + 1)) / double(size);
+
+  for(int c(0); c < size; ++c) {
+    CINCH_ASSERT(LE, work[c], colorer.options().tolerance(0) * average + heavy);
+  } // for
+
+  CINCH_ASSERT(NE, *std::min_element(counts.begin(), counts.end()),
+    *std::max_element(counts.begin(), counts.end()));
+
+} // TEST
+
+#endif // FLECSI_ENABLE_PARMETIS
+
 /*----------------------------------------------------------------------------*
  * Cinch test Macros
  *
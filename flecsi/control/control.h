@@ -16,6 +16,8 @@
 /*! @file */
 
 #include <flecsi/control/phase_walker.h>
+#include <flecsi/control/pipeline.h>
+#include <flecsi/control/runtime.h>
 #include <flecsi/utils/dag.h>
 
 #include <functional>
@@ -46,6 +48,7 @@ struct control_u : public CONTROL_POLICY {
     instance().sort_phases();
     phase_walker_t pw(argc, argv);
     pw.template walk_types<typename CONTROL_POLICY::phases>();
+    instance().pipeline().wait();
     return 0;
   } // execute
 
@@ -72,6 +75,10 @@ struct control_u : public CONTROL_POLICY {
       registry_[phase].label() = label;
     } // if
 
+    // The caller may modify the map, which is therefore sorted again
+    // before the next phase is executed.
+    modified_ = true;
+
     return registry_[phase];
   } // control_phase_map
 
@@ -83,20 +90,37 @@ struct control_u : public CONTROL_POLICY {
    */
 
   std::vector<node_t> const & sorted_phase_map(size_t phase) {
+    sort_phases();
     return sorted_[phase];
   } // sorted_phase_map
 
+  /*!
+    Return the in-situ pipeline, on which actions can run analysis and
+    I/O on snapshots of their fields, concurrently with the next phases.
+    The pending actions are completed before execute returns.
+   */
+
+  pipeline_t & pipeline() {
+    return pipeline_;
+  } // pipeline
+
 private:
   void sort_phases() {
-    if(sorted_.size() == 0) {
+    if(modified_) {
       for(auto & d : registry_) {
         sorted_[d.first] = d.second.sort();
       } // for
+      modified_ = false;
+
+      // The traces recorded with the previous actions are stale.
+      runtime_t::instance().invalidate_traces();
     } // if
   } // sort_phases
 
   std::map<size_t, dag_t> registry_;
   std::map<size_t, std::vector<node_t>> sorted_;
+  bool modified_ = false;
+  pipeline_t pipeline_;
 
 }; // control_u
 
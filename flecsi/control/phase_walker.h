@@ -15,10 +15,13 @@
 
 /*! @file */
 
+#include <flecsi/control/runtime.h>
 #include <flecsi/utils/const_string.h>
 #include <flecsi/utils/tuple_walker.h>
 #include <flecsi/utils/typeify.h>
 
+#include <type_traits>
+
 #include <flecsi-config.h>
 
 #if defined(FLECSI_ENABLE_GRAPHVIZ)
@@ -61,6 +64,35 @@ struct cycle_u {
 
 }; // struct cycle_u
 
+/*!
+  Allow users to define cyclic control points whose iterations are
+  traced, so that the runtime can replay the dependence analysis of
+  their tasks. The first iteration is not traced, because it may
+  execute other tasks, e.g., the ghost copies of the initial values.
+  Every other iteration must execute the same tasks with the same
+  arguments.
+
+  @tparam TRACE      The trace id, which must be unique among the traced
+                     cycles.
+  @tparam PREDICATE  A predicate function that determines when
+                     the cycle should end.
+  @tparam PHASES ... A variadic list of phases within the cycle.
+ */
+
+template<size_t TRACE, bool (*PREDICATE)(), typename... PHASES>
+struct traced_cycle_u : public cycle_u<PREDICATE, PHASES...> {
+
+  static constexpr size_t trace = TRACE;
+
+}; // struct traced_cycle_u
+
+template<typename PHASE_TYPE, typename = void>
+struct is_traced_u : std::false_type {};
+
+template<typename PHASE_TYPE>
+struct is_traced_u<PHASE_TYPE, std::void_t<decltype(PHASE_TYPE::trace)>>
+  : std::true_type {};
+
 /*!
   The phase_walker_u class allows execution of statically-defined
   control points.
@@ -97,15 +129,37 @@ struct phase_walker_u
     else {
 
       // This is a cycle -> create a new phase walker to recurse the cycle.
+      bool first = true;
       while(PHASE_TYPE::predicate()) {
+        const bool traced = is_traced_u<PHASE_TYPE>::value && !first;
+        first = false;
+
+        if(traced) {
+          runtime_t::instance().begin_trace(trace_id<PHASE_TYPE>());
+        } // if
+
         phase_walker_u phase_walker(argc_, argv_);
         phase_walker.template walk_types<typename PHASE_TYPE::TYPE>();
+
+        if(traced) {
+          runtime_t::instance().end_trace(trace_id<PHASE_TYPE>());
+        } // if
       } // while
     } // if
 
   } // handle_type
 
 private:
+  template<typename PHASE_TYPE>
+  static constexpr size_t trace_id() {
+    if constexpr(is_traced_u<PHASE_TYPE>::value) {
+      return PHASE_TYPE::trace;
+    }
+    else {
+      return 0;
+    } // if
+  } // trace_id
+
   int argc_;
   char ** argv_;
 
@@ -0,0 +1,245 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include <flecsi/concurrency/thread_pool.h>
+
+namespace flecsi {
+namespace control {
+
+/*!
+  The pipeline_t type runs in-situ analysis and I/O actions on a pool of
+  worker threads, off the critical path of the computation. An action
+  works on a snapshot, i.e., a copy of the data that it needs, taken
+  when the action is submitted, so that the computation is free to
+  modify its fields while the action runs.
+
+  At most \em depth actions are pending, i.e., queued or running. When
+  the pipeline is full, submitting an action either blocks until a
+  pending action completes, or skips the new action, depending on the
+  overflow policy. The worker threads are started by the first
+  submission.
+ */
+
+class pipeline_t
+{
+public:
+  using action_t = std::function<void()>;
+
+  /*!
+    What to do with an action submitted to a full pipeline.
+   */
+
+  enum class overflow_t {
+    block, /*!< Wait until a pending action completes. */
+    skip /*!< Drop the new action. */
+  }; // enum class overflow_t
+
+  /*!
+    Constructor.
+
+    @param threads  The number of worker threads.
+    @param depth    The maximum number of pending actions.
+    @param overflow The overflow policy.
+   */
+
+  pipeline_t(size_t threads = 1,
+    size_t depth = 2,
+    overflow_t overflow = overflow_t::block)
+    : threads_(threads), depth_(depth), overflow_(overflow) {}
+
+  /// Copy constructor (disabled)
+  pipeline_t(const pipeline_t &) = delete;
+
+  /// Assignment operator (disabled)
+  pipeline_t & operator=(const pipeline_t &) = delete;
+
+  /*!
+    Destructor. Pending actions are completed first.
+   */
+
+  ~pipeline_t() {
+    drain();
+    pool_.join();
+  } // ~pipeline_t
+
+  /*!
+    Set the number of worker threads, the maximum number of pending
+    actions and the overflow policy. This must be called before the
+    first submission.
+   */
+
+  void configure(size_t threads,
+    size_t depth,
+    overflow_t overflow = overflow_t::block) {
+    assert(!started_ && "pipeline already started");
+    assert(threads > 0 && depth > 0);
+    threads_ = threads;
+    depth_ = depth;
+    overflow_ = overflow;
+  } // configure
+
+  /*!
+    Submit an action.
+
+    @return Whether the action was queued, i.e., false if it was skipped.
+   */
+
+  bool submit(action_t action) {
+    if(!acquire())
+      return false;
+    launch(std::move(action));
+    return true;
+  } // submit
+
+  /*!
+    Submit an action on a snapshot. The snapshot is copied, or moved
+    from an rvalue, once room has been made for the action, and is then
+    passed to the action by const reference.
+
+    @param snapshot The data on which the action works.
+    @param action   A callable object taking the snapshot.
+
+    @return Whether the action was queued, i.e., false if it was skipped.
+   */
+
+  template<typename SNAPSHOT, typename ACTION>
+  bool submit(SNAPSHOT && snapshot, ACTION && action) {
+    if(!acquire())
+      return false;
+    auto copy = std::make_shared<const std::decay_t<SNAPSHOT>>(
+      std::forward<SNAPSHOT>(snapshot));
+    launch([copy, action = std::forward<ACTION>(action)]() { action(*copy); });
+    return true;
+  } // submit
+
+  /*!
+    Block until all the pending actions are completed. The first
+    exception thrown by an action since the last call is rethrown.
+   */
+
+  void wait() {
+    drain();
+    std::exception_ptr error;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::swap(error, error_);
+    }
+    if(error)
+      std::rethrow_exception(error);
+  } // wait
+
+  /*!
+    Return the number of actions that were skipped because the pipeline
+    was full.
+   */
+
+  size_t skipped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return skipped_;
+  } // skipped
+
+  /*!
+    Return the time in seconds that submissions spent waiting for room
+    in the pipeline, i.e., the delay added to the computation.
+   */
+
+  double stall_time() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stall_time_;
+  } // stall_time
+
+private:
+  /*
+    Reserve room for an action, according to the overflow policy.
+   */
+
+  bool acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if(!started_) {
+      pool_.start(threads_);
+      started_ = true;
+    } // if
+
+    if(pending_ == depth_) {
+      if(overflow_ == overflow_t::skip) {
+        ++skipped_;
+        return false;
+      } // if
+
+      auto start = std::chrono::steady_clock::now();
+      cond_.wait(lock, [this] { return pending_ < depth_; });
+      std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+      stall_time_ += elapsed.count();
+    } // if
+
+    ++pending_;
+    return true;
+  } // acquire
+
+  void launch(action_t action) {
+    pool_.queue([this, action = std::move(action)]() {
+      std::exception_ptr error;
+      try {
+        action();
+      }
+      catch(...) {
+        error = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      if(error && !error_)
+        error_ = error;
+      --pending_;
+      cond_.notify_all();
+    });
+  } // launch
+
+  void drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return pending_ == 0; });
+  } // drain
+
+  size_t threads_;
+  size_t depth_;
+  overflow_t overflow_;
+
+  bool started_ = false;
+  size_t pending_ = 0;
+  size_t skipped_ = 0;
+  double stall_time_ = 0.0;
+  std::exception_ptr error_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  thread_pool pool_;
+
+}; // class pipeline_t
+
+} // namespace control
+} // namespace flecsi
@@ -38,6 +38,18 @@ struct runtime_handler_t {
   std::function<bool(int, char **)> output;
 }; // struct runtime_handler_t
 
+/*!
+  Type to define the handlers that begin and end a trace of the tasks
+  that are executed by an iteration of a traced cycle, and that discard
+  the recorded traces when the control model changes.
+ */
+
+struct trace_handler_t {
+  std::function<void(size_t)> begin;
+  std::function<void(size_t)> end;
+  std::function<void()> invalidate;
+}; // struct trace_handler_t
+
 /*!
  */
 
@@ -81,6 +93,47 @@ struct runtime_t {
     return handlers_;
   } // runtimes
 
+  /*!
+    Set the trace handler. Without one, traced cycles are executed like
+    other cycles.
+   */
+
+  bool register_trace_handler(trace_handler_t const & handler) {
+    trace_handler_ = handler;
+    return true;
+  } // register_trace_handler
+
+  /*!
+    Begin the trace with the given id.
+   */
+
+  void begin_trace(size_t trace) {
+    if(trace_handler_.begin) {
+      trace_handler_.begin(trace);
+    } // if
+  } // begin_trace
+
+  /*!
+    End the trace with the given id.
+   */
+
+  void end_trace(size_t trace) {
+    if(trace_handler_.end) {
+      trace_handler_.end(trace);
+    } // if
+  } // end_trace
+
+  /*!
+    Discard the recorded traces, e.g., because the actions of a phase
+    have changed.
+   */
+
+  void invalidate_traces() {
+    if(trace_handler_.invalidate) {
+      trace_handler_.invalidate();
+    } // if
+  } // invalidate_traces
+
   /*!
     Invoke runtime intiailzation callbacks.
    */
@@ -127,6 +180,7 @@ private:
   std::string program_;
   std::function<int(int, char **)> driver_;
   std::vector<runtime_handler_t> handlers_;
+  trace_handler_t trace_handler_;
 
 }; // runtime_t
 
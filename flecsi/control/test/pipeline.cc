@@ -0,0 +1,135 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <cinchtest.h>
+
+#include <flecsi/control/pipeline.h>
+
+using namespace flecsi::control;
+
+/*----------------------------------------------------------------------------*
+ * Actions work on the values of the snapshot at submission.
+ *----------------------------------------------------------------------------*/
+
+TEST(pipeline, snapshot) {
+  pipeline_t pipeline(2, 4);
+
+  std::vector<double> field(1000, 1.0);
+  std::atomic<int> sum(0);
+
+  for(int step = 0; step < 10; ++step) {
+    pipeline.submit(field, [&sum](const std::vector<double> & values) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      double s = 0.0;
+      for(auto v : values)
+        s += v;
+      sum += int(s);
+    });
+
+    // The computation goes on modifying the field.
+    for(auto & v : field)
+      v += 1.0;
+  } // for
+
+  pipeline.wait();
+
+  // 1000 * (1 + 2 + ... + 10)
+  ASSERT_EQ(sum, 55000);
+  ASSERT_EQ(pipeline.skipped(), 0);
+} // TEST
+
+/*----------------------------------------------------------------------------*
+ * No more than depth actions are pending at any time.
+ *----------------------------------------------------------------------------*/
+
+TEST(pipeline, backpressure) {
+  const size_t depth = 3;
+  pipeline_t pipeline(2, depth);
+
+  std::atomic<size_t> pending(0);
+  std::atomic<size_t> max_pending(0);
+  std::atomic<int> completed(0);
+
+  for(int step = 0; step < 20; ++step) {
+    size_t p = ++pending;
+    size_t m = max_pending;
+    while(p > m && !max_pending.compare_exchange_weak(m, p)) {
+    }
+
+    pipeline.submit([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      ++completed;
+      --pending;
+    });
+  } // for
+
+  pipeline.wait();
+
+  // A submission counts its action before it gets room for it.
+  ASSERT_LE(max_pending, depth + 1);
+  ASSERT_EQ(completed, 20);
+  ASSERT_GT(pipeline.stall_time(), 0.0);
+} // TEST
+
+/*----------------------------------------------------------------------------*
+ * Actions submitted to a full pipeline are skipped.
+ *----------------------------------------------------------------------------*/
+
+TEST(pipeline, skip) {
+  pipeline_t pipeline(1, 2, pipeline_t::overflow_t::skip);
+
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::mutex mutex;
+  std::vector<int> done;
+
+  for(int step = 0; step < 5; ++step) {
+    pipeline.submit(step, [&, released](int s) {
+      released.wait();
+      std::lock_guard<std::mutex> lock(mutex);
+      done.push_back(s);
+    });
+  } // for
+
+  release.set_value();
+  pipeline.wait();
+
+  ASSERT_EQ(pipeline.skipped(), 3);
+  ASSERT_EQ(done.size(), 2);
+  ASSERT_EQ(done[0], 0);
+  ASSERT_EQ(done[1], 1);
+} // TEST
+
+/*----------------------------------------------------------------------------*
+ * Exceptions thrown by actions are rethrown by wait.
+ *----------------------------------------------------------------------------*/
+
+TEST(pipeline, exception) {
+  pipeline_t pipeline;
+
+  pipeline.submit([]() { throw std::runtime_error("analysis failed"); });
+  ASSERT_THROW(pipeline.wait(), std::runtime_error);
+
+  // The error is reported once.
+  pipeline.submit([]() {});
+  pipeline.wait();
+} // TEST
@@ -0,0 +1,141 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+
+#include <bitset>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cinchtest.h>
+#include <flecsi/control/control.h>
+#include <flecsi/control/phase_walker.h>
+#include <flecsi/control/runtime.h>
+#include <flecsi/utils/const_string.h>
+#include <flecsi/utils/macros.h>
+
+using namespace flecsi::control;
+
+enum simulation_phases_t : size_t {
+  initialize,
+  advance,
+  finalize
+}; // enum simulation_phases_t
+
+struct control_policy_t {
+
+  using control_t = control_u<control_policy_t>;
+
+  static bool evolve_control() {
+    return control_t::instance().step()++ < 4;
+  } // evolve_control
+
+  using evolve = traced_cycle_u<7, evolve_control, phase_<advance>>;
+
+  using phases = std::tuple<phase_<initialize>, evolve, phase_<finalize>>;
+
+  size_t & step() {
+    return step_;
+  }
+
+  struct node_t {
+
+    using bitset_t = std::bitset<8>;
+    using action_t = std::function<int(int, char **)>;
+
+    node_t(action_t const & action = {}, bitset_t const & bitset = {})
+      : action_(action), bitset_(bitset) {}
+
+    bool initialize(node_t const & node) {
+      action_ = node.action_;
+      bitset_ = node.bitset_;
+      return true;
+    } // initialize
+
+    action_t const & action() const {
+      return action_;
+    }
+    action_t & action() {
+      return action_;
+    }
+
+  private:
+    action_t action_;
+    bitset_t bitset_;
+
+  }; // struct node_t
+
+private:
+  size_t step_ = 0;
+
+}; // struct control_policy_t
+
+std::ostream &
+operator<<(std::ostream & stream, control_policy_t::node_t const & node) {
+  return stream;
+} // operator <<
+
+using control_t = control_u<control_policy_t>;
+
+// The sequence of actions and trace boundaries.
+std::vector<std::string> events;
+
+int
+action_initialize(int argc, char ** argv) {
+  events.push_back("initialize");
+  return 0;
+} // action_initialize
+
+int
+action_advance(int argc, char ** argv) {
+  events.push_back("advance");
+  return 0;
+} // action_advance
+
+int
+action_finalize(int argc, char ** argv) {
+  events.push_back("finalize");
+  return 0;
+} // action_finalize
+
+#define register_action(phase, name, action)                                   \
+  bool name##_registered =                                                     \
+    control_t::instance()                                                      \
+      .phase_map(phase, EXPAND_AND_STRINGIFY(phase))                           \
+      .initialize_node(                                                        \
+        {flecsi::utils::const_string_t{EXPAND_AND_STRINGIFY(name)}.hash(),     \
+          EXPAND_AND_STRINGIFY(name), action, 0});
+
+register_action(initialize, initialize, action_initialize);
+register_action(advance, advance, action_advance);
+register_action(finalize, finalize, action_finalize);
+
+TEST(traced_cycle, testname) {
+
+  runtime_t::instance().register_trace_handler(
+    {[](size_t trace) { events.push_back("begin " + std::to_string(trace)); },
+      [](size_t trace) { events.push_back("end " + std::to_string(trace)); }});
+
+  int argc = 1;
+  char arg0[] = "traced_cycle";
+  char * argv[] = {arg0};
+
+  control_t::instance().execute(argc, argv);
+
+  // The first iteration is not traced.
+  const std::vector<std::string> expected = {"initialize", "advance",
+    "begin 7", "advance", "end 7", "begin 7", "advance", "end 7", "begin 7",
+    "advance", "end 7", "finalize"};
+  ASSERT_EQ(events, expected);
+
+} // TEST
@@ -0,0 +1,55 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+namespace flecsi {
+namespace data {
+
+/*!
+  The compression of a field in checkpoint and output files.
+
+  Lossless compression reproduces the values exactly, and is suitable
+  for restart files. Lossy compression quantizes floating-point values,
+  so that the values that are read differ from the values that were
+  written by at most the error bound. It is meant for visualization
+  dumps, and falls back to lossless compression for other types of
+  values. Checkpoints only apply it on explicit request.
+ */
+
+struct compression_t {
+
+  enum mode_t { none, lossless, lossy };
+
+  mode_t mode = none;
+
+  /*! The compression level, from 1 (fastest) to 9 (smallest). */
+  int level = 1;
+
+  /*! The maximum absolute error of lossy compression. */
+  double error_bound = 0.0;
+
+  static compression_t make_lossless(int level = 1) {
+    return {lossless, level, 0.0};
+  } // make_lossless
+
+  static compression_t make_lossy(double error_bound, int level = 1) {
+    return {lossy, level, error_bound};
+  } // make_lossy
+
+}; // struct compression_t
+
+} // namespace data
+} // namespace flecsi
@@ -0,0 +1,47 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+namespace flecsi {
+namespace data {
+
+/*!
+  The placement of the data of a field in memory.
+
+  The memory pages of a field are placed in the NUMA domain of the thread
+  that touches them first. By default, that is the thread that registers
+  the field. With first touch, the pages are touched by the threads of
+  the kernels of omp tasks, in contiguous blocks, so that each thread
+  finds the entities it processes in its own NUMA domain. Huge pages
+  reduce the TLB misses of large fields.
+ */
+
+struct placement_t {
+
+  /*! Touch the pages first with the kernel threads. */
+  bool first_touch = false;
+
+  /*! Back the data with transparent huge pages, where supported. */
+  bool huge_pages = false;
+
+  static placement_t make_first_touch(bool huge_pages = false) {
+    return {true, huge_pages};
+  } // make_first_touch
+
+}; // struct placement_t
+
+} // namespace data
+} // namespace flecsi
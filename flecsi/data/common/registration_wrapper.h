@@ -68,6 +68,7 @@ struct field_registration_wrapper_u {
     fi.storage_class = STORAGE_CLASS;
     fi.size = (STORAGE_CLASS == sparse ? sizeof(DATA_TYPE) + sizeof(size_t)
                                        : sizeof(DATA_TYPE));
+    fi.scalar_type = scalar_type_u<DATA_TYPE>::value;
     fi.namespace_hash = NAMESPACE_HASH;
     fi.name_hash = NAME_HASH;
     fi.versions = VERSIONS;
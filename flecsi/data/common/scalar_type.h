@@ -0,0 +1,127 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace flecsi {
+namespace data {
+
+/*!
+  Enumeration of the scalar types of field data. Fields whose values are
+  not built from a single arithmetic type are opaque.
+ */
+
+enum class scalar_type_t : size_t {
+  opaque,
+  int8,
+  uint8,
+  int16,
+  uint16,
+  int32,
+  uint32,
+  int64,
+  uint64,
+  float32,
+  float64
+}; // enum class scalar_type_t
+
+/*!
+  The scalar type of a C++ type. Arithmetic types map to themselves, and
+  arrays to the scalar type of their elements, so that a field of
+  std::array<double, 3> is stored as three float64 values per entry.
+
+  @tparam T The C++ type.
+ */
+
+template<typename T, typename = void>
+struct scalar_type_u {
+  static constexpr scalar_type_t value = scalar_type_t::opaque;
+}; // struct scalar_type_u
+
+template<typename T>
+struct scalar_type_u<T, std::enable_if_t<std::is_integral_v<T>>> {
+  static constexpr scalar_type_t integral() {
+    constexpr bool is_signed = std::is_signed_v<T>;
+    switch(sizeof(T)) {
+      case 1:
+        return is_signed ? scalar_type_t::int8 : scalar_type_t::uint8;
+      case 2:
+        return is_signed ? scalar_type_t::int16 : scalar_type_t::uint16;
+      case 4:
+        return is_signed ? scalar_type_t::int32 : scalar_type_t::uint32;
+      case 8:
+        return is_signed ? scalar_type_t::int64 : scalar_type_t::uint64;
+      default:
+        return scalar_type_t::opaque;
+    } // switch
+  } // integral
+
+  static constexpr scalar_type_t value = integral();
+}; // struct scalar_type_u
+
+template<>
+struct scalar_type_u<bool> {
+  static constexpr scalar_type_t value = scalar_type_t::opaque;
+}; // struct scalar_type_u
+
+template<>
+struct scalar_type_u<float> {
+  static constexpr scalar_type_t value = scalar_type_t::float32;
+}; // struct scalar_type_u
+
+template<>
+struct scalar_type_u<double> {
+  static constexpr scalar_type_t value = scalar_type_t::float64;
+}; // struct scalar_type_u
+
+template<typename T, size_t N>
+struct scalar_type_u<T[N]> : scalar_type_u<T> {};
+
+template<typename T, size_t N>
+struct scalar_type_u<std::array<T, N>> : scalar_type_u<T> {};
+
+/*!
+  Return the size in bytes of a scalar type, or zero if it is opaque.
+ */
+
+constexpr size_t
+scalar_type_size(scalar_type_t type) {
+  switch(type) {
+    case scalar_type_t::int8:
+    case scalar_type_t::uint8:
+      return 1;
+    case scalar_type_t::int16:
+    case scalar_type_t::uint16:
+      return 2;
+    case scalar_type_t::int32:
+    case scalar_type_t::uint32:
+    case scalar_type_t::float32:
+      return 4;
+    case scalar_type_t::int64:
+    case scalar_type_t::uint64:
+    case scalar_type_t::float64:
+      return 8;
+    default:
+      return 0;
+  } // switch
+} // scalar_type_size
+
+} // namespace data
+} // namespace flecsi
@@ -122,6 +122,8 @@ public:
 
   virtual size_t deep_copy(const void * ptr_in, void * ptr_out) const = 0;
 
+  virtual void destroy(void * field_ptr) const = 0;
+
 }; // class serdez_untyped_t
 
 template<typename SERDEZ>
@@ -168,6 +170,12 @@ public:
     auto out = static_cast<TYPE *>(ptr_out);
     return SERDEZ::deep_copy(*in, *out);
   }
+
+  virtual void destroy(void * field_ptr) const {
+    using TYPE = typename SERDEZ::FIELD_TYPE;
+    auto item_ptr = static_cast<TYPE *>(field_ptr);
+    SERDEZ::destroy(*item_ptr);
+  }
 }; // class serdez_wrapper_u
 
 } // namespace data
@@ -83,6 +83,44 @@
       flecsi::utils::const_string_t{EXPAND_AND_STRINGIFY(name)}.hash(),        \
       versions, ##__VA_ARGS__>({EXPAND_AND_STRINGIFY(name)})
 
+/*!
+  @def flecsi_set_field_attribute
+
+  This macro sets an attribute of a field. The attributes are:
+
+  - compression: The \ref compression_t of the data in checkpoint and
+    output files. Lossless compression is suitable for restart files.
+    Lossy compression bounds the absolute error of floating-point
+    values, and is meant for visualization dumps; checkpoints compress
+    such fields losslessly unless the IO policy enables
+    lossy_checkpoints. Fields are not compressed by default.
+  - placement: The \ref placement_t of the data in memory, e.g., so that
+    the kernels of omp tasks find the entities they process in their own
+    NUMA domain. The MPI backend applies it when the field data are
+    allocated.
+
+  @param client_type The \ref data_client_t type.
+  @param nspace      The namespace of the registered variable.
+  @param name        The name of the registered variable.
+  @param attribute   The attribute, whose type is
+                     flecsi::data::<attribute>_t.
+  @param value       The value of the attribute, e.g.,
+                     flecsi::data::compression_t::make_lossy(1e-6).
+
+  @ingroup data
+ */
+
+#define flecsi_set_field_attribute(                                            \
+  client_type, nspace, name, attribute, value)                                 \
+  /* MACRO IMPLEMENTATION */                                                   \
+                                                                               \
+  /* Record the attribute with the runtime context */                          \
+  inline bool client_type##_##nspace##_##name##_##attribute##_registered =     \
+    flecsi::data::field_interface_t::register_field_attribute<client_type,     \
+      flecsi::utils::const_string_t{EXPAND_AND_STRINGIFY(nspace)}.hash(),      \
+      flecsi::utils::const_string_t{EXPAND_AND_STRINGIFY(name)}.hash(),        \
+      flecsi::data::attribute##_t>(value)
+
 /*!
   @def flecsi_register_global
 
@@ -17,6 +17,7 @@
 
 #include <flecsi-config.h>
 
+#include <flecsi/data/common/compression.h>
 #include <flecsi/data/common/data_types.h>
 #include <flecsi/data/common/registration_wrapper.h>
 #include <flecsi/data/common/row_vector.h>
@@ -114,6 +115,37 @@ struct field_interface_u {
     return true;
   } // register_field
 
+  /*!
+    Register an attribute of a field, e.g., its compression in checkpoint
+    and output files or its placement in memory. The attribute applies to
+    all versions of the field.
+
+    @tparam DATA_CLIENT_TYPE The data client type on which the field is
+                             registered.
+    @tparam NAMESPACE_HASH   The namespace key.
+    @tparam NAME_HASH        The attribute name.
+    @tparam ATTRIBUTE        The attribute type, which identifies the
+                             attribute.
+
+    @param attribute The value of the attribute.
+
+    @ingroup data
+   */
+
+  template<typename DATA_CLIENT_TYPE,
+    size_t NAMESPACE_HASH,
+    size_t NAME_HASH,
+    typename ATTRIBUTE>
+  static bool register_field_attribute(const ATTRIBUTE & attribute) {
+    const size_t client_type_key =
+      typeid(typename DATA_CLIENT_TYPE::type_identifier_t).hash_code();
+
+    execution::context_t::instance().register_field_attribute(
+      client_type_key, NAMESPACE_HASH, NAME_HASH, attribute);
+
+    return true;
+  } // register_field_attribute
+
   /*!
     Return the handle associated with the given parameters and data client.
 
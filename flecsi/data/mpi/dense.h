@@ -153,7 +153,8 @@ struct storage_class_u<dense> {
       size_t size = field_info.size * (color_info.exclusive +
                                         color_info.shared + color_info.ghost);
       // TODO: deal with VERSION
-      context.register_field_data(field_info.fid, size);
+      context.register_field_data(field_info.fid, size,
+        context.field_attribute<data::placement_t>(field_info));
     }
     auto fieldMetaDataIter =
       context.registered_field_metadata().find(field_info.fid);
@@ -0,0 +1,625 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <flecsi-config.h>
+
+#include <flecsi/execution/common/timeline.h>
+
+namespace flecsi {
+namespace execution {
+
+/*!
+  Whether the task instrumentation is compiled in, which is selected with
+  the ENABLE_INSTRUMENTATION build option. Otherwise, the instrumentation
+  calls are empty and compile to nothing.
+
+  @ingroup execution
+ */
+
+#if defined(FLECSI_ENABLE_INSTRUMENTATION)
+constexpr bool instrumentation_enabled = true;
+#else
+constexpr bool instrumentation_enabled = false;
+#endif
+
+/*!
+  The phases of the execution of a task: the ghost copies before it, the
+  user task, the ghost updates after it, and the finalization of its
+  handles.
+
+  @ingroup execution
+ */
+
+enum class task_phase_t : size_t { prolog, user, epilog, finalize };
+
+constexpr size_t task_phases = 4;
+
+inline const char *
+task_phase_name(size_t phase) {
+  static const char * names[task_phases] = {
+    "prolog", "user", "epilog", "finalize"};
+  return names[phase];
+} // task_phase_name
+
+/*!
+  The counters of a task: the number of launches, and the time spent in
+  each phase, in seconds.
+
+  @ingroup execution
+ */
+
+struct task_counters_t {
+  size_t launches = 0;
+  double seconds[task_phases] = {};
+}; // struct task_counters_t
+
+/*!
+  The counters of the ghost updates of a field.
+
+  @ingroup execution
+ */
+
+struct field_counters_t {
+  size_t updates = 0;
+  size_t bytes = 0;
+}; // struct field_counters_t
+
+/*!
+  The instrumentation of a thread, or the aggregate of the threads of a
+  rank: the counters of each task, by task key, and of the ghost updates
+  of each field, by field id, and the time spent waiting on reductions.
+
+  @ingroup execution
+ */
+
+struct instrumentation_t {
+
+  /*!
+    Add the counters of another instrumentation.
+   */
+
+  void merge(const instrumentation_t & other) {
+    for(auto & t : other.tasks) {
+      auto & counters = tasks[t.first];
+      counters.launches += t.second.launches;
+      for(size_t p = 0; p < task_phases; ++p) {
+        counters.seconds[p] += t.second.seconds[p];
+      } // for
+    } // for
+
+    for(auto & f : other.fields) {
+      fields[f.first].updates += f.second.updates;
+      fields[f.first].bytes += f.second.bytes;
+    } // for
+
+    reductions += other.reductions;
+    reduction_wait += other.reduction_wait;
+  } // merge
+
+  std::map<size_t, task_counters_t> tasks;
+  std::map<size_t, field_counters_t> fields;
+  size_t reductions = 0;
+  double reduction_wait = 0.0;
+
+}; // struct instrumentation_t
+
+/*!
+  The instrumentation_registry_t type holds the instrumentation of the
+  threads of a rank, which each record into their own, and the names of
+  the tasks.
+
+  @ingroup execution
+ */
+
+class instrumentation_registry_t
+{
+public:
+  /*!
+    Return the registry instance.
+   */
+
+  static instrumentation_registry_t & instance() {
+    static instrumentation_registry_t registry;
+    return registry;
+  } // instance
+
+  /*!
+    Name a task in the reports.
+   */
+
+  void register_task(size_t key, const std::string & name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    names_[key] = name;
+  } // register_task
+
+  /*!
+    Return the name of a task, or its key if it has not been named.
+   */
+
+  std::string task_name(size_t key) const {
+    auto name = names_.find(key);
+    return name == names_.end() ? std::to_string(key) : name->second;
+  } // task_name
+
+  /*!
+    Return the names of the tasks, by task key.
+   */
+
+  const std::map<size_t, std::string> & task_names() const {
+    return names_;
+  } // task_names
+
+  /*!
+    Return the instrumentation of the calling thread.
+   */
+
+  static instrumentation_t & local() {
+    static thread_local thread_t thread;
+    return thread.data;
+  } // local
+
+  /*!
+    Return the aggregate instrumentation of the threads of the rank. This
+    must not be called while tasks execute.
+   */
+
+  instrumentation_t collect() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    instrumentation_t result = retired_;
+    for(auto thread : threads_) {
+      result.merge(*thread);
+    } // for
+
+    return result;
+  } // collect
+
+  /*!
+    Set the file to which the JSON report is written at finalization.
+   */
+
+  void set_report(const std::string & filename) {
+    report_ = filename;
+  } // set_report
+
+  const std::string & report() const {
+    return report_;
+  } // report
+
+private:
+  // The instrumentation of a thread is merged into the retired counters
+  // when the thread exits.
+  struct thread_t {
+    thread_t() {
+      auto & registry = instance();
+      std::lock_guard<std::mutex> lock(registry.mutex_);
+      registry.threads_.push_back(&data);
+    } // thread_t
+
+    ~thread_t() {
+      auto & registry = instance();
+      std::lock_guard<std::mutex> lock(registry.mutex_);
+      registry.retired_.merge(data);
+      registry.threads_.erase(std::find(
+        registry.threads_.begin(), registry.threads_.end(), &data));
+    } // ~thread_t
+
+    instrumentation_t data;
+  }; // struct thread_t
+
+  instrumentation_registry_t() = default;
+
+  std::mutex mutex_;
+  std::vector<instrumentation_t *> threads_;
+  instrumentation_t retired_;
+  std::map<size_t, std::string> names_;
+  std::string report_;
+
+}; // class instrumentation_registry_t
+
+//----------------------------------------------------------------------------//
+// Recording interface.
+//----------------------------------------------------------------------------//
+
+/*!
+  Name a task in the instrumentation reports and the timeline. The names
+  are registered even if the instrumentation is not compiled in, for the
+  timeline.
+
+  @ingroup execution
+ */
+
+inline void
+instrument_task_name(size_t task, const std::string & name) {
+  instrumentation_registry_t::instance().register_task(task, name);
+} // instrument_task_name
+
+/*!
+  Count a launch of a task.
+
+  @ingroup execution
+ */
+
+inline void
+instrument_task_launch(size_t task) {
+  if constexpr(instrumentation_enabled) {
+    ++instrumentation_registry_t::local().tasks[task].launches;
+  } // if
+} // instrument_task_launch
+
+/*!
+  Count a ghost update of a field.
+
+  @param fid   The field id.
+  @param bytes The number of bytes received for the ghosts.
+
+  @ingroup execution
+ */
+
+inline void
+instrument_ghost_update(size_t fid, size_t bytes) {
+  if constexpr(instrumentation_enabled) {
+    auto & counters = instrumentation_registry_t::local().fields[fid];
+    ++counters.updates;
+    counters.bytes += bytes;
+  } // if
+} // instrument_ghost_update
+
+/*!
+  The task_phase_timer_t type adds the time from its construction to its
+  destruction to a phase of a task, and records it in the timeline, if
+  it was started.
+
+  @ingroup execution
+ */
+
+class task_phase_timer_t
+{
+public:
+  task_phase_timer_t(size_t task, task_phase_t phase)
+    : task_(task), phase_(phase) {
+    if(instrumentation_enabled || timeline_t::enabled()) {
+      start_ = timeline_clock_t::now();
+    } // if
+  } // task_phase_timer_t
+
+  ~task_phase_timer_t() {
+    if(instrumentation_enabled || timeline_t::enabled()) {
+      const auto end = timeline_clock_t::now();
+
+      if constexpr(instrumentation_enabled) {
+        const std::chrono::duration<double> elapsed = end - start_;
+        instrumentation_registry_t::local()
+          .tasks[task_]
+          .seconds[size_t(phase_)] += elapsed.count();
+      } // if
+
+      if(timeline_t::enabled()) {
+        timeline_t::instance().record(
+          start_, end, task_, timeline_kind_t(phase_));
+      } // if
+    } // if
+  } // ~task_phase_timer_t
+
+  task_phase_timer_t(const task_phase_timer_t &) = delete;
+  task_phase_timer_t & operator=(const task_phase_timer_t &) = delete;
+
+private:
+  size_t task_;
+  task_phase_t phase_;
+  timeline_clock_t::time_point start_;
+
+}; // class task_phase_timer_t
+
+/*!
+  The reduction_timer_t type counts a reduction, adds the time from its
+  construction to its destruction to the reduction wait time, and
+  records it in the timeline, if it was started.
+
+  @ingroup execution
+ */
+
+class reduction_timer_t
+{
+public:
+  explicit reduction_timer_t(size_t task) : task_(task) {
+    if(instrumentation_enabled || timeline_t::enabled()) {
+      start_ = timeline_clock_t::now();
+    } // if
+  } // reduction_timer_t
+
+  ~reduction_timer_t() {
+    if(instrumentation_enabled || timeline_t::enabled()) {
+      const auto end = timeline_clock_t::now();
+
+      if constexpr(instrumentation_enabled) {
+        const std::chrono::duration<double> elapsed = end - start_;
+        auto & local = instrumentation_registry_t::local();
+        ++local.reductions;
+        local.reduction_wait += elapsed.count();
+      } // if
+
+      if(timeline_t::enabled()) {
+        timeline_t::instance().record(
+          start_, end, task_, timeline_kind_t::allreduce);
+      } // if
+    } // if
+  } // ~reduction_timer_t
+
+  reduction_timer_t(const reduction_timer_t &) = delete;
+  reduction_timer_t & operator=(const reduction_timer_t &) = delete;
+
+private:
+  size_t task_;
+  timeline_clock_t::time_point start_;
+
+}; // class reduction_timer_t
+
+//----------------------------------------------------------------------------//
+// Report interface.
+//----------------------------------------------------------------------------//
+
+/*!
+  Write the instrumentation of each rank as a JSON object.
+
+  @param stream The output stream.
+  @param ranks  The instrumentation of each rank.
+
+  @ingroup execution
+ */
+
+inline std::ostream &
+write_json(std::ostream & stream,
+  const std::vector<instrumentation_t> & ranks) {
+  auto & registry = instrumentation_registry_t::instance();
+
+  stream << "{" << std::endl << "  \"ranks\": [";
+
+  for(size_t r = 0; r < ranks.size(); ++r) {
+    const auto & rank = ranks[r];
+
+    stream << (r == 0 ? "" : ",") << std::endl;
+    stream << "    {" << std::endl;
+    stream << "      \"rank\": " << r << "," << std::endl;
+    stream << "      \"tasks\": [";
+
+    bool first(true);
+    for(auto & t : rank.tasks) {
+      stream << (first ? "" : ",") << std::endl;
+      stream << "        { \"name\": \"" << registry.task_name(t.first)
+             << "\", \"launches\": " << t.second.launches;
+      for(size_t p = 0; p < task_phases; ++p) {
+        stream << ", \"" << task_phase_name(p)
+               << "\": " << t.second.seconds[p];
+      } // for
+      stream << " }";
+      first = false;
+    } // for
+
+    stream << std::endl << "      ]," << std::endl;
+    stream << "      \"fields\": [";
+
+    first = true;
+    for(auto & f : rank.fields) {
+      stream << (first ? "" : ",") << std::endl;
+      stream << "        { \"fid\": " << f.first
+             << ", \"updates\": " << f.second.updates
+             << ", \"bytes\": " << f.second.bytes << " }";
+      first = false;
+    } // for
+
+    stream << std::endl << "      ]," << std::endl;
+    stream << "      \"reductions\": " << rank.reductions << "," << std::endl;
+    stream << "      \"reduction_wait\": " << rank.reduction_wait
+           << std::endl;
+    stream << "    }";
+  } // for
+
+  stream << std::endl << "  ]" << std::endl << "}" << std::endl;
+
+  return stream;
+} // write_json
+
+/*!
+  Write a summary table of the instrumentation of the ranks: the maximum
+  over the ranks of the counters of each task, the ghost updates of each
+  field summed over the ranks, and the reduction wait times.
+
+  @param stream The output stream.
+  @param ranks  The instrumentation of each rank.
+
+  @ingroup execution
+ */
+
+inline std::ostream &
+write_table(std::ostream & stream,
+  const std::vector<instrumentation_t> & ranks) {
+  auto & registry = instrumentation_registry_t::instance();
+
+  instrumentation_t max, total;
+  for(auto & rank : ranks) {
+    total.merge(rank);
+
+    for(auto & t : rank.tasks) {
+      auto & counters = max.tasks[t.first];
+      counters.launches = std::max(counters.launches, t.second.launches);
+      for(size_t p = 0; p < task_phases; ++p) {
+        counters.seconds[p] =
+          std::max(counters.seconds[p], t.second.seconds[p]);
+      } // for
+    } // for
+
+    max.reduction_wait = std::max(max.reduction_wait, rank.reduction_wait);
+  } // for
+
+  const auto precision = stream.precision();
+
+  stream << "Task instrumentation, maximum over " << ranks.size()
+         << " ranks (seconds)" << std::endl;
+  stream << std::left << std::setw(32) << "task" << std::right
+         << std::setw(10) << "launches";
+  for(size_t p = 0; p < task_phases; ++p) {
+    stream << std::setw(12) << task_phase_name(p);
+  } // for
+  stream << std::endl;
+
+  for(auto & t : max.tasks) {
+    stream << std::left << std::setw(32) << registry.task_name(t.first)
+           << std::right << std::setw(10) << t.second.launches;
+    for(size_t p = 0; p < task_phases; ++p) {
+      stream << std::setw(12) << std::setprecision(4) << t.second.seconds[p];
+    } // for
+    stream << std::endl;
+  } // for
+
+  if(!total.fields.empty()) {
+    stream << std::endl << "Ghost updates, total over ranks" << std::endl;
+    stream << std::left << std::setw(32) << "field" << std::right
+           << std::setw(10) << "updates" << std::setw(16) << "bytes"
+           << std::endl;
+
+    for(auto & f : total.fields) {
+      stream << std::left << std::setw(32) << f.first << std::right
+             << std::setw(10) << f.second.updates << std::setw(16)
+             << f.second.bytes << std::endl;
+    } // for
+  } // if
+
+  if(total.reductions > 0) {
+    stream << std::endl
+           << "Reduction wait: " << total.reductions / ranks.size()
+           << " reductions per rank, " << max.reduction_wait
+           << " s maximum, " << total.reduction_wait / ranks.size()
+           << " s average" << std::endl;
+  } // if
+
+  stream.precision(precision);
+
+  return stream;
+} // write_table
+
+/*!
+  Gather the instrumentation of the ranks, and write the summary table
+  to the standard output, and the JSON report to the file that was set
+  with instrumentation_registry_t::set_report, on rank 0. This is called
+  by the runtimes at finalization, and is a no-op when the
+  instrumentation is not compiled in.
+
+  @ingroup execution
+ */
+
+inline void
+report_instrumentation() {
+  if constexpr(instrumentation_enabled) {
+    auto & registry = instrumentation_registry_t::instance();
+    const instrumentation_t local = registry.collect();
+
+    std::vector<instrumentation_t> ranks;
+
+#if defined(FLECSI_ENABLE_MPI)
+    if(detail::mpi_active()) {
+      struct task_record_t {
+        size_t key;
+        task_counters_t counters;
+      };
+
+      struct field_record_t {
+        size_t fid;
+        field_counters_t counters;
+      };
+
+      struct reduction_record_t {
+        size_t reductions;
+        double wait;
+      };
+
+      std::vector<task_record_t> tasks;
+      for(auto & t : local.tasks) {
+        tasks.push_back({t.first, t.second});
+      } // for
+
+      std::vector<field_record_t> fields;
+      for(auto & f : local.fields) {
+        fields.push_back({f.first, f.second});
+      } // for
+
+      auto all_tasks = detail::gather_records(tasks);
+      auto all_fields = detail::gather_records(fields);
+      auto all_reductions = detail::gather_records(
+        std::vector<reduction_record_t>{{local.reductions,
+          local.reduction_wait}});
+
+      ranks.resize(all_tasks.size());
+      for(size_t r = 0; r < ranks.size(); ++r) {
+        for(auto & t : all_tasks[r]) {
+          ranks[r].tasks[t.key] = t.counters;
+        } // for
+
+        for(auto & f : all_fields[r]) {
+          ranks[r].fields[f.fid] = f.counters;
+        } // for
+
+        ranks[r].reductions = all_reductions[r][0].reductions;
+        ranks[r].reduction_wait = all_reductions[r][0].wait;
+      } // for
+    }
+    else {
+      ranks.push_back(local);
+    } // if
+#else
+    ranks.push_back(local);
+#endif // FLECSI_ENABLE_MPI
+
+    if(ranks.empty()) {
+      return;
+    } // if
+
+    write_table(std::cout, ranks);
+
+    if(!registry.report().empty()) {
+      std::ofstream report(registry.report());
+      write_json(report, ranks);
+    } // if
+  } // if
+} // report_instrumentation
+
+/*!
+  Write the timeline of the ranks, if it was started. This is called by
+  the runtimes at finalization.
+
+  @ingroup execution
+ */
+
+inline void
+report_timeline() {
+  timeline_t::instance().write(
+    instrumentation_registry_t::instance().task_names());
+} // report_timeline
+
+} // namespace execution
+} // namespace flecsi
@@ -27,7 +27,12 @@ namespace flecsi {
   @ingroup execution
  */
 
-enum processor_type_t : size_t { loc, toc, mpi }; // enum processor_type_t
+enum processor_type_t : size_t {
+  loc,
+  toc,
+  mpi,
+  omp
+}; // enum processor_type_t
 
 /*!
   Convenience method to print processor_type_t instances.
@@ -45,9 +50,48 @@ operator<<(std::ostream & stream, const processor_type_t & variant) {
     case processor_type_t::mpi:
       stream << "mpi";
       break;
+    case processor_type_t::omp:
+      stream << "omp";
+      break;
   } // switch
 
   return stream;
 } // operator <<
 
+/*!
+  Return the processor type of the task that is executed by the calling
+  thread. The kernels, e.g., for_each_u, only run threaded in omp tasks.
+
+  @ingroup execution
+ */
+
+inline processor_type_t &
+task_processor_type() {
+  static thread_local processor_type_t type = processor_type_t::loc;
+  return type;
+} // task_processor_type
+
+/*!
+  Set the processor type of the calling thread for the execution of a
+  task, and restore the previous one on destruction.
+
+  @ingroup execution
+ */
+
+struct task_processor_guard_t {
+
+  task_processor_guard_t(processor_type_t type)
+    : previous_(task_processor_type()) {
+    task_processor_type() = type;
+  } // task_processor_guard_t
+
+  ~task_processor_guard_t() {
+    task_processor_type() = previous_;
+  } // ~task_processor_guard_t
+
+private:
+  processor_type_t previous_;
+
+}; // struct task_processor_guard_t
+
 } // namespace flecsi
@@ -0,0 +1,443 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <flecsi-config.h>
+
+#if defined(FLECSI_ENABLE_MPI)
+#include <mpi.h>
+#endif
+
+namespace flecsi {
+namespace execution {
+
+/*!
+  The kinds of the events of the timeline. The first ones are the phases
+  of a task, in the order of task_phase_t.
+
+  @ingroup execution
+ */
+
+enum class timeline_kind_t : uint32_t {
+  prolog,
+  user,
+  epilog,
+  finalize,
+  allreduce,
+  checkpoint,
+  checkpoint_write,
+  recover
+}; // enum timeline_kind_t
+
+/*!
+  An event of the timeline: its begin and end, in nanoseconds since the
+  start of the timeline, and its kind. The key identifies the task of
+  the event, if any.
+
+  @ingroup execution
+ */
+
+struct timeline_event_t {
+  int64_t begin;
+  int64_t end;
+  size_t key;
+  timeline_kind_t kind;
+  uint32_t thread;
+}; // struct timeline_event_t
+
+/*!
+  The timeline_buffer_t type is the ring buffer of the events of a
+  thread. Only its thread records into it, without locks, and the oldest
+  events are overwritten when it is full.
+
+  @ingroup execution
+ */
+
+class timeline_buffer_t
+{
+public:
+  timeline_buffer_t(size_t capacity, uint32_t thread)
+    : events_(capacity), thread_(thread) {}
+
+  /*!
+    Record an event.
+   */
+
+  void push(int64_t begin, int64_t end, size_t key, timeline_kind_t kind) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    events_[head % events_.size()] = {begin, end, key, kind, thread_};
+    head_.store(head + 1, std::memory_order_release);
+  } // push
+
+  /*!
+    Append the recorded events, oldest first. The thread must not record
+    events meanwhile.
+   */
+
+  void collect(std::vector<timeline_event_t> & events) const {
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t count = std::min(head, events_.size());
+
+    for(size_t e = head - count; e < head; ++e) {
+      events.push_back(events_[e % events_.size()]);
+    } // for
+  } // collect
+
+private:
+  std::vector<timeline_event_t> events_;
+  std::atomic<size_t> head_{0};
+  uint32_t thread_;
+
+}; // class timeline_buffer_t
+
+#if defined(FLECSI_ENABLE_MPI)
+
+namespace detail {
+
+/*!
+  Gather the records of each rank on rank 0. The records are sent in
+  pieces whose size fits in an MPI count, so that the records of a rank
+  may exceed 2^31 bytes.
+ */
+
+template<typename T>
+std::vector<std::vector<T>>
+gather_records(const std::vector<T> & records) {
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  std::uint64_t count = records.size();
+  std::vector<std::uint64_t> counts(rank == 0 ? size : 0);
+  MPI_Gather(&count, 1, MPI_UINT64_T, counts.data(), 1, MPI_UINT64_T, 0,
+    MPI_COMM_WORLD);
+
+  const size_t piece = std::max<size_t>(1, (size_t(1) << 30) / sizeof(T));
+  const int tag = 0x71e;
+
+  std::vector<std::vector<T>> result(counts.size());
+  if(rank == 0) {
+    result[0] = records;
+    for(int r = 1; r < size; ++r) {
+      result[r].resize(counts[r]);
+      for(size_t offset = 0; offset < counts[r]; offset += piece) {
+        const size_t n = std::min<size_t>(piece, counts[r] - offset);
+        MPI_Recv(result[r].data() + offset, int(n * sizeof(T)), MPI_BYTE, r,
+          tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      } // for
+    } // for
+  }
+  else {
+    for(size_t offset = 0; offset < records.size(); offset += piece) {
+      const size_t n = std::min(piece, records.size() - offset);
+      MPI_Send(records.data() + offset, int(n * sizeof(T)), MPI_BYTE, 0, tag,
+        MPI_COMM_WORLD);
+    } // for
+  } // if
+
+  return result;
+} // gather_records
+
+/*!
+  Return whether MPI may be called.
+ */
+
+inline bool
+mpi_active() {
+  int initialized, finalized;
+  MPI_Initialized(&initialized);
+  MPI_Finalized(&finalized);
+  return initialized && !finalized;
+} // mpi_active
+
+} // namespace detail
+
+#endif // FLECSI_ENABLE_MPI
+
+/*!
+  The clock of the timeline.
+
+  @ingroup execution
+ */
+
+using timeline_clock_t = std::chrono::steady_clock;
+
+/*!
+  The timeline_t type records the begin and end of the phases of the
+  tasks, the reductions and the checkpoints of the threads of a rank,
+  when it has been started, and writes the events of all ranks as a
+  Chrome trace, which chrome://tracing and Perfetto display, at
+  finalization. Each rank is a process of the trace, and each of its
+  threads a thread, so that the overlap of tasks, ghost updates and
+  reductions can be seen.
+
+  @ingroup execution
+ */
+
+class timeline_t
+{
+public:
+  /*!
+    Return the timeline instance.
+   */
+
+  static timeline_t & instance() {
+    static timeline_t timeline;
+    return timeline;
+  } // instance
+
+  /*!
+    Return whether events are recorded.
+   */
+
+  static bool enabled() {
+    return enabled_;
+  } // enabled
+
+  /*!
+    Start recording events. This must be called before the runtime
+    starts its threads. With MPI, it must be called by all ranks, which
+    synchronize so that their clocks start together.
+
+    @param filename The file of the trace.
+    @param capacity The number of events that each thread keeps.
+   */
+
+  void start(const std::string & filename, size_t capacity = 1 << 16) {
+#if defined(FLECSI_ENABLE_MPI)
+    if(detail::mpi_active()) {
+      MPI_Barrier(MPI_COMM_WORLD);
+    } // if
+#endif
+
+    filename_ = filename;
+    capacity_ = capacity;
+    origin_ = timeline_clock_t::now();
+    enabled_ = true;
+  } // start
+
+  /*!
+    Record an event of the calling thread.
+   */
+
+  void record(timeline_clock_t::time_point begin,
+    timeline_clock_t::time_point end,
+    size_t key,
+    timeline_kind_t kind) {
+    thread_local timeline_buffer_t * buffer = nullptr;
+
+    if(buffer == nullptr) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers_.push_back(
+        std::make_unique<timeline_buffer_t>(capacity_, buffers_.size()));
+      buffer = buffers_.back().get();
+    } // if
+
+    buffer->push(nanoseconds(begin), nanoseconds(end), key, kind);
+  } // record
+
+  /*!
+    Write the events of all ranks to the trace file on rank 0, if the
+    timeline was started. No events may be recorded meanwhile.
+
+    @param names The names of the tasks, by task key.
+   */
+
+  void write(const std::map<size_t, std::string> & names) {
+    if(!enabled_) {
+      return;
+    } // if
+
+    std::vector<timeline_event_t> events;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for(auto & buffer : buffers_) {
+        buffer->collect(events);
+      } // for
+    }
+
+    std::vector<std::vector<timeline_event_t>> ranks;
+
+#if defined(FLECSI_ENABLE_MPI)
+    if(detail::mpi_active()) {
+      ranks = detail::gather_records(events);
+    }
+    else {
+      ranks.push_back(std::move(events));
+    } // if
+#else
+    ranks.push_back(std::move(events));
+#endif
+
+    if(ranks.empty()) {
+      return;
+    } // if
+
+    std::ofstream trace(filename_);
+    write_chrome_trace(trace, ranks, names);
+  } // write
+
+  /*!
+    Write the events of the ranks in the Chrome trace event format.
+
+    @param stream The output stream.
+    @param ranks  The events of each rank.
+    @param names  The names of the tasks, by task key.
+   */
+
+  static std::ostream & write_chrome_trace(std::ostream & stream,
+    const std::vector<std::vector<timeline_event_t>> & ranks,
+    const std::map<size_t, std::string> & names) {
+    static const char * kinds[] = {"prolog", "user", "epilog", "finalize",
+      "allreduce", "checkpoint", "checkpoint_write", "recover"};
+
+    stream << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+
+    bool first(true);
+    auto separate = [&]() {
+      stream << (first ? "" : ",") << std::endl;
+      first = false;
+    };
+
+    for(size_t r = 0; r < ranks.size(); ++r) {
+      separate();
+      stream << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << r
+             << ", \"args\": {\"name\": \"rank " << r << "\"}}";
+
+      for(auto & e : ranks[r]) {
+        const char * kind = kinds[size_t(e.kind)];
+        std::string name;
+
+        if(e.kind <= timeline_kind_t::finalize) {
+          auto task = names.find(e.key);
+          name = task == names.end() ? std::to_string(e.key) : task->second;
+          if(e.kind != timeline_kind_t::user) {
+            name += std::string(" ") + kind;
+          } // if
+        }
+        else {
+          name = kind;
+        } // if
+
+        separate();
+        stream << "{\"name\": \"" << json_escape(name) << "\", \"cat\": \""
+               << kind << "\", \"ph\": \"X\", \"ts\": " << e.begin / 1000.0
+               << ", \"dur\": " << (e.end - e.begin) / 1000.0
+               << ", \"pid\": " << r << ", \"tid\": " << e.thread << "}";
+      } // for
+    } // for
+
+    stream << std::endl << "]}" << std::endl;
+
+    return stream;
+  } // write_chrome_trace
+
+private:
+  timeline_t() = default;
+
+  /*!
+    Escape a string for a JSON string literal. Task names are chosen by
+    the user and may contain quotes, backslashes or control characters.
+   */
+
+  static std::string json_escape(const std::string & value) {
+    static const char * hex = "0123456789abcdef";
+
+    std::string escaped;
+    escaped.reserve(value.size());
+    for(unsigned char c : value) {
+      if(c == '"' || c == '\\') {
+        escaped += '\\';
+        escaped += c;
+      }
+      else if(c < 0x20) {
+        escaped += "\\u00";
+        escaped += hex[c >> 4];
+        escaped += hex[c & 0xf];
+      }
+      else {
+        escaped += c;
+      } // if
+    } // for
+
+    return escaped;
+  } // json_escape
+
+  int64_t nanoseconds(timeline_clock_t::time_point time) const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      time - origin_)
+      .count();
+  } // nanoseconds
+
+  static inline bool enabled_ = false;
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<timeline_buffer_t>> buffers_;
+  std::string filename_;
+  size_t capacity_ = 0;
+  timeline_clock_t::time_point origin_;
+
+}; // class timeline_t
+
+/*!
+  The timeline_scope_t type records an event of the timeline from its
+  construction to its destruction, if the timeline was started.
+
+  @ingroup execution
+ */
+
+class timeline_scope_t
+{
+public:
+  explicit timeline_scope_t(timeline_kind_t kind, size_t key = 0)
+    : kind_(kind), key_(key) {
+    if(timeline_t::enabled()) {
+      begin_ = timeline_clock_t::now();
+    } // if
+  } // timeline_scope_t
+
+  ~timeline_scope_t() {
+    if(timeline_t::enabled()) {
+      timeline_t::instance().record(
+        begin_, timeline_clock_t::now(), key_, kind_);
+    } // if
+  } // ~timeline_scope_t
+
+  timeline_scope_t(const timeline_scope_t &) = delete;
+  timeline_scope_t & operator=(const timeline_scope_t &) = delete;
+
+private:
+  timeline_kind_t kind_;
+  size_t key_;
+  timeline_clock_t::time_point begin_;
+
+}; // class timeline_scope_t
+
+} // namespace execution
+} // namespace flecsi
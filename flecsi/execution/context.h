@@ -16,10 +16,14 @@
 /*! @file */
 
 #include <algorithm>
+#include <any>
 #include <cstddef>
 #include <functional>
 #include <map>
 #include <memory>
+#include <string>
+#include <tuple>
+#include <typeinfo>
 #include <unordered_map>
 
 #include <cinchlog.h>
@@ -27,8 +31,12 @@
 #include <flecsi/utils/const_string.h>
 
 #include <flecsi/coloring/adjacency_types.h>
+#include <flecsi/coloring/coloring_report.h>
 #include <flecsi/coloring/coloring_types.h>
 #include <flecsi/coloring/index_coloring.h>
+#include <flecsi/data/common/compression.h>
+#include <flecsi/data/common/placement.h>
+#include <flecsi/data/common/scalar_type.h>
 #include <flecsi/data/common/serdez.h>
 #include <flecsi/execution/common/execution_state.h>
 #include <flecsi/execution/global_object_wrapper.h>
@@ -71,6 +79,7 @@ struct context_u : public CONTEXT_POLICY {
     size_t data_client_hash;
     size_t storage_class = 0;
     size_t size;
+    data::scalar_type_t scalar_type = data::scalar_type_t::opaque;
     size_t namespace_hash;
     size_t name_hash;
     size_t versions;
@@ -691,6 +700,61 @@ struct context_u : public CONTEXT_POLICY {
     return coloring_info_;
   } // colorings
 
+  /*!
+    Return the quality metrics of the coloring of each index space, e.g.,
+    load imbalance and ghost volume. This is computed from the coloring
+    information and requires no communication. The edge cut is reported
+    for the index spaces for which the specialization set it.
+
+    @return A map of index space to coloring quality.
+   */
+
+  std::map<size_t, flecsi::coloring::coloring_quality_t>
+  coloring_quality() const {
+    std::map<size_t, flecsi::coloring::coloring_quality_t> quality;
+
+    for(auto & ci : coloring_info_) {
+      quality[ci.first] = flecsi::coloring::analyze_coloring(ci.second);
+
+      auto cut = edge_cuts_.find(ci.first);
+      if(cut != edge_cuts_.end()) {
+        quality[ci.first].edge_cut = cut->second;
+      } // if
+    } // for
+
+    return quality;
+  } // coloring_quality
+
+  /*!
+    Set the edge cut of the coloring of an index space, e.g., as computed
+    by \ref flecsi::coloring::edge_cut from the dcrs graph that was
+    colored, for the coloring report.
+
+    @param index_space The index space id.
+    @param cut         The number of graph edges between colors.
+   */
+
+  void set_edge_cut(size_t index_space, size_t cut) {
+    edge_cuts_[index_space] = cut;
+  } // set_edge_cut
+
+  /*!
+    Set the file to which the runtime driver writes the coloring report.
+    An empty string disables the report.
+   */
+
+  void set_coloring_report(const std::string & filename) {
+    coloring_report_ = filename;
+  } // set_coloring_report
+
+  /*!
+    Return the file to which the runtime driver writes the coloring report.
+   */
+
+  const std::string & coloring_report() const {
+    return coloring_report_;
+  } // coloring_report
+
   /*!
     Add an adjacency/connectivity from one index space to another.
 
@@ -752,6 +816,44 @@ struct context_u : public CONTEXT_POLICY {
     return field_info_vec_;
   }
 
+  /*!
+    Register an attribute of a field, e.g., its \ref data::compression_t
+    or \ref data::placement_t. An attribute is identified by its type, and
+    applies to all versions of the field.
+
+    @tparam ATTRIBUTE The attribute type.
+
+    @param data_client_hash data client type hash
+    @param namespace_hash   namespace hash
+    @param name_hash        field name hash
+    @param attribute        the value of the attribute
+   */
+
+  template<typename ATTRIBUTE>
+  void register_field_attribute(size_t data_client_hash,
+    size_t namespace_hash,
+    size_t name_hash,
+    const ATTRIBUTE & attribute) {
+    field_attribute_map_[{data_client_hash, namespace_hash, name_hash,
+      typeid(ATTRIBUTE).hash_code()}] = attribute;
+  } // register_field_attribute
+
+  /*!
+    Return an attribute of a field, which is the default value of its
+    type unless it was registered.
+
+    @tparam ATTRIBUTE The attribute type.
+   */
+
+  template<typename ATTRIBUTE>
+  ATTRIBUTE field_attribute(const field_info_t & fi) const {
+    auto itr = field_attribute_map_.find({fi.data_client_hash,
+      fi.namespace_hash, fi.name_hash, typeid(ATTRIBUTE).hash_code()});
+    return itr == field_attribute_map_.end()
+             ? ATTRIBUTE{}
+             : std::any_cast<const ATTRIBUTE &>(itr->second);
+  } // field_attribute
+
   /*!
     Add an adjacency index space.
 
@@ -956,6 +1058,14 @@ private:
   std::map<std::pair<size_t, size_t>, std::pair<size_t, field_id_t>>
     field_name_map_;
 
+  //--------------------------------------------------------------------------//
+  // Field attribute map, key = (data client hash, namespace hash,
+  //   name hash, attribute type hash)
+  //--------------------------------------------------------------------------//
+
+  std::map<std::tuple<size_t, size_t, size_t, size_t>, std::any>
+    field_attribute_map_;
+
   //--------------------------------------------------------------------------//
   // key: virtual index space id
   // value: coloring indices (exclusive, shared, ghost)
@@ -1054,6 +1164,13 @@ private:
 
   std::map<size_t, std::unordered_map<size_t, coloring_info_t>> coloring_info_;
 
+  //--------------------------------------------------------------------------//
+  // Output file for the coloring quality report.
+  //--------------------------------------------------------------------------//
+
+  std::string coloring_report_;
+  std::map<size_t, size_t> edge_cuts_;
+
   //--------------------------------------------------------------------------//
   // key: index space
   //--------------------------------------------------------------------------//
@@ -435,6 +435,46 @@ clog_register_tag(execution);
                                                                                \
   flecsi_execute_task(task, nspace, index, ##__VA_ARGS__)
 
+//----------------------------------------------------------------------------//
+// Trace Interface
+//----------------------------------------------------------------------------//
+
+/*!
+  @def flecsi_begin_trace
+
+  This macro begins a trace of the tasks that are executed until the
+  matching flecsi_end_trace. Traces are meant for the body of a time step
+  loop: the tasks and arguments of each execution of a trace must be
+  identical, so that the runtime can replay the analysis of their
+  dependences instead of repeating it. Traces cannot be nested, and
+  cannot contain MPI tasks. The recorded traces are discarded when the
+  phases of the control model change, and are recorded again.
+
+  @param id The trace id.
+
+  @ingroup execution
+ */
+
+#define flecsi_begin_trace(id)                                                 \
+  /* MACRO IMPLEMENTATION */                                                   \
+                                                                               \
+  flecsi::execution::task_interface_t::begin_trace(id)
+
+/*!
+  @def flecsi_end_trace
+
+  This macro ends the trace with the given id.
+
+  @param id The trace id.
+
+  @ingroup execution
+ */
+
+#define flecsi_end_trace(id)                                                   \
+  /* MACRO IMPLEMENTATION */                                                   \
+                                                                               \
+  flecsi::execution::task_interface_t::end_trace(id)
+
 //----------------------------------------------------------------------------//
 // Reduction Interface
 //----------------------------------------------------------------------------//
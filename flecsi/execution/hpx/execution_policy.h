@@ -152,6 +152,20 @@ struct FLECSI_EXPORT hpx_execution_policy_t {
       std::forward_as_tuple(std::forward<ARGS>(args)...));
   } // execute_task
 
+  //--------------------------------------------------------------------------//
+  // Trace interface.
+  //--------------------------------------------------------------------------//
+
+  ///
+  /// hpx task traces. Tasks are scheduled as soon as they are executed,
+  /// so that there is no dependence analysis to replay.
+  ///
+  static void begin_trace(size_t) {} // begin_trace
+
+  static void end_trace(size_t) {} // end_trace
+
+  static void invalidate_traces() {} // invalidate_traces
+
   //--------------------------------------------------------------------------//
   // Function interface.
   //--------------------------------------------------------------------------//
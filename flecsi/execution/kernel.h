@@ -17,8 +17,260 @@
   @file
  */
 
+#include <flecsi/concurrency/thread_pool.h>
+#include <flecsi/execution/common/processor.h>
 #include <flecsi/topology/index_space.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <flecsi-config.h>
+
+#if defined(FLECSI_ENABLE_OPENMP)
+#include <omp.h>
+#endif
+
+/*!
+  Vectorization hint for the inner loops of the kernels, whose iterations
+  must not depend on each other.
+ */
+
+#if defined(FLECSI_ENABLE_OPENMP)
+#define FLECSI_KERNEL_SIMD _Pragma("omp simd")
+#elif defined(__GNUC__) && !defined(__clang__)
+#define FLECSI_KERNEL_SIMD _Pragma("GCC ivdep")
+#else
+#define FLECSI_KERNEL_SIMD
+#endif
+
+namespace flecsi {
+
+/*!
+  Return whether the kernels of the calling thread run threaded, i.e.,
+  whether it executes an omp task outside of a parallel region.
+ */
+
+inline bool
+threaded_kernels() {
+#if defined(FLECSI_ENABLE_OPENMP)
+  return task_processor_type() == processor_type_t::omp && !omp_in_parallel();
+#else
+  return task_processor_type() == processor_type_t::omp;
+#endif
+} // threaded_kernels
+
+/*!
+  Return the number of threads, including the calling one, that execute
+  the kernels of omp tasks when FleCSI is built without OpenMP. It must
+  be set before the first threaded kernel.
+ */
+
+inline size_t &
+kernel_threads() {
+  static size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  return threads;
+} // kernel_threads
+
+/*!
+  The number of entities of a chunk of a threaded kernel. The chunks, and
+  therefore the results of the reductions, do not depend on the number
+  of threads.
+ */
+
+constexpr size_t kernel_chunk_size = 2048;
+
+namespace detail {
+
+/*!
+  Return the thread pool that executes the chunks of the threaded kernels
+  without OpenMP.
+ */
+
+inline thread_pool &
+kernel_pool() {
+  static thread_pool pool;
+  static std::once_flag started;
+  std::call_once(started, [] { pool.start(kernel_threads() - 1); });
+  return pool;
+} // kernel_pool
+
+/*!
+  Return the index of the calling thread among the threads that execute
+  kernels without OpenMP: zero for the threads that launch them, and a
+  fixed index from one on for each thread of the kernel pool.
+ */
+
+inline size_t &
+kernel_thread_index() {
+  static thread_local size_t index = 0;
+  return index;
+} // kernel_thread_index
+
+/*!
+  Execute function(begin, end) for the blocks of a static split of
+  [begin, end) into one contiguous block per kernel thread, on the kernel
+  thread pool. Each thread executes the block of its index if it is still
+  pending, so that every split of the same range is executed by the same
+  threads, as with the static schedule of OpenMP. The blocks of busy
+  threads are taken over by the others. The calling thread executes
+  blocks, too, and returns when all of them are done.
+ */
+
+template<typename FUNCTION>
+void
+for_each_block(size_t begin, size_t end, FUNCTION && function) {
+  thread_pool & pool = kernel_pool();
+  const size_t blocks = pool.num_threads() + 1;
+
+  std::vector<std::atomic<bool>> taken(blocks);
+  for(auto & t : taken) {
+    t = false;
+  } // for
+
+  auto run = [&](size_t block) {
+    if(!taken[block].exchange(true)) {
+      function(begin + (end - begin) * block / blocks,
+        begin + (end - begin) * (block + 1) / blocks);
+    } // if
+  };
+
+  auto work = [&]() {
+    run(kernel_thread_index() % blocks);
+    for(size_t block = 0; block < blocks; ++block) {
+      run(block);
+    } // for
+  };
+
+  static std::atomic<size_t> next_index{0};
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t active = blocks - 1;
+
+  for(size_t w = 1; w < blocks; ++w) {
+    pool.queue([&]() {
+      auto & index = kernel_thread_index();
+      if(index == 0) {
+        index = ++next_index;
+      } // if
+      work();
+      std::lock_guard<std::mutex> lock(mutex);
+      if(--active == 0) {
+        done.notify_one();
+      } // if
+    });
+  } // for
+
+  work();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&]() { return active == 0; });
+} // for_each_block
+
+/*!
+  Execute function(chunk, begin, end) for the chunks of [begin, end) on
+  the OpenMP thread team or the kernel thread pool. The chunks are
+  statically split among the threads in both cases, so that first-touch
+  placement puts the data of a thread in its NUMA domain. The calling
+  thread executes chunks, too, and returns when all of them are done.
+ */
+
+template<typename FUNCTION>
+void
+for_each_chunk(size_t begin, size_t end, FUNCTION && function) {
+  const size_t chunks = (end - begin + kernel_chunk_size - 1) /
+                        kernel_chunk_size;
+
+  if(chunks == 0) {
+    return;
+  } // if
+
+  auto run = [&](size_t chunk) {
+    const size_t first = begin + chunk * kernel_chunk_size;
+    function(chunk, first, std::min(first + kernel_chunk_size, end));
+  };
+
+#if defined(FLECSI_ENABLE_OPENMP)
+#pragma omp parallel for schedule(static)
+  for(size_t chunk = 0; chunk < chunks; ++chunk) {
+    run(chunk);
+  } // for
+#else
+  // Nested kernels, including those of the calling thread, run serially.
+  task_processor_guard_t guard(processor_type_t::loc);
+
+  for_each_block(0, chunks, [&](size_t first, size_t last) {
+    for(size_t chunk = first; chunk < last; ++chunk) {
+      run(chunk);
+    } // for
+  });
+#endif
+} // for_each_chunk
+
+/*!
+  Combine the partial results of the chunks of a reduction pairwise, in
+  a fixed order, and apply the total to the reduction variable.
+ */
+
+template<typename OPERATION>
+void
+reduce_chunks(std::vector<typename OPERATION::LHS> & partial,
+  typename OPERATION::LHS & reduction) {
+  const size_t size = partial.size();
+
+  for(size_t stride = 1; stride < size; stride *= 2) {
+    for(size_t i = 0; i + stride < size; i += 2 * stride) {
+      OPERATION::template apply<true>(partial[i], partial[i + stride]);
+    } // for
+  } // for
+
+  if(size > 0) {
+    OPERATION::template apply<true>(reduction, partial[0]);
+  } // if
+} // reduce_chunks
+
+/*!
+  Execute function(entity) for the entities with offsets [begin, end) of
+  an index space. The loop is vectorized if the entities have contiguous
+  ids, which the ids of a sorted index space have if the first and last
+  ones differ by the number of entities.
+ */
+
+template<bool SORTED, typename ENTITY_TYPE, typename INDEX_SPACE,
+  typename FUNCTION>
+void
+for_each_offset(INDEX_SPACE & index_space,
+  size_t begin,
+  size_t end,
+  FUNCTION & function) {
+  if(SORTED && begin < end) {
+    auto & storage = *index_space.storage();
+    const size_t first = index_space.id_storage()[begin].index_space_index();
+    const size_t last = index_space.id_storage()[end - 1].index_space_index();
+
+    if(last - first == end - begin - 1) {
+      const size_t size = end - begin;
+      FLECSI_KERNEL_SIMD
+      for(size_t i = 0; i < size; ++i) {
+        function(std::forward<ENTITY_TYPE>(storage[first + i]));
+      } // for
+      return;
+    } // if
+  } // if
+
+  for(size_t i = begin; i < end; ++i) {
+    function(std::forward<ENTITY_TYPE>(index_space.get_offset(i)));
+  } // for
+} // for_each_offset
+
+} // namespace detail
+
+} // namespace flecsi
+
 #ifdef FLECSI_ENABLE_KOKKOS
 
 #include <Kokkos_Core.hpp>
@@ -91,6 +343,50 @@ private:
 #define forall(it, iterator, name)                                             \
   forall_t{iterator, name} + KOKKOS_LAMBDA(auto it)
 
+} // namespace flecsi
+
+#else
+
+namespace flecsi {
+
+/*!
+  Without Kokkos, the forall_t type runs the kernel in chunks on the
+  OpenMP thread team or the kernel thread pool in omp tasks, and serially
+  otherwise.
+ */
+
+template<typename ITERATOR>
+struct forall_t {
+
+  forall_t(ITERATOR iterator, std::string const & name = "")
+    : iterator_(iterator) {}
+
+  template<typename LAMBDA>
+  void operator+(LAMBDA lambda) {
+    const size_t size = iterator_.size();
+
+    if(threaded_kernels()) {
+      detail::for_each_chunk(0, size, [&](size_t, size_t begin, size_t end) {
+        FLECSI_KERNEL_SIMD
+        for(size_t i = begin; i < end; ++i) {
+          lambda(iterator_[i]);
+        } // for
+      });
+      return;
+    } // if
+
+    for(size_t i = 0; i < size; ++i) {
+      lambda(iterator_[i]);
+    } // for
+  } // operator+
+
+private:
+  ITERATOR iterator_;
+
+}; // forall_t
+
+#define forall(it, iterator, name) forall_t{iterator, name} + [&](auto it)
+
 } // namespace flecsi
 #endif
 
@@ -130,6 +426,16 @@ for_each_u(
   FUNCTION && function) {
   const size_t end = index_space.end_offset();
 
+  // In omp tasks, the entities are divided into chunks among the threads.
+  if(threaded_kernels()) {
+    detail::for_each_chunk(index_space.begin_offset(), end,
+      [&](size_t, size_t chunk_begin, size_t chunk_end) {
+        detail::for_each_offset<SORTED, ENTITY_TYPE>(
+          index_space, chunk_begin, chunk_end, function);
+      });
+    return;
+  } // if
+
   for(size_t i(index_space.begin_offset()); i < end; ++i) {
     function(std::forward<ENTITY_TYPE>(index_space.get_offset(i)));
   } // for
@@ -177,4 +483,72 @@ reduce_each_u(
   } // for
 } // reduce_each_u
 
+//----------------------------------------------------------------------------//
+//! Abstraction function for fine-grained, data-parallel reductions with a
+//! reduction operation, e.g., flecsi::execution::reduction::sum<double>.
+//! In omp tasks, every chunk of entities is reduced into a partial result,
+//! starting from the identity of the operation, and the partial results
+//! are combined in a tree, so that the result does not depend on the
+//! number of threads.
+//!
+//! @tparam OPERATION   The reduction operation type.
+//! @tparam ENTITY_TYPE The entity type of the associated index space.
+//! @tparam STORAGE     A boolean indicating whether or not the associated
+//!                     index space has storage for the referenced entity types.
+//! @tparam OWNED       A boolean indicating whether or not the entity data are
+//!                     owned by the associated index space.
+//! @tparam SORTED      A boolean indicating whether or not the associated index
+//!                     space is sorted.
+//! @tparam PREDICATE   An optional predicate function used to select
+//!                     indices matching particular criteria.
+//! @tparam FUNCTION    The calleable object type.
+//!
+//! @param index_space  The index space over which to execute the calleable
+//!                     object.
+//! @param reduction    The reduction variable.
+//! @param function     The calleable object instance.
+//!
+//! @ingroup execution
+//----------------------------------------------------------------------------//
+
+template<typename OPERATION,
+  typename ENTITY_TYPE,
+  bool STORAGE,
+  bool OWNED,
+  bool SORTED,
+  typename PREDICATE,
+  typename FUNCTION>
+inline void
+reduce_each_u(
+  flecsi::topology::
+    index_space_u<ENTITY_TYPE, STORAGE, OWNED, SORTED, PREDICATE> & index_space,
+  typename OPERATION::LHS & reduction,
+  FUNCTION && function) {
+  size_t end = index_space.end_offset();
+
+  if(threaded_kernels()) {
+    const size_t begin = index_space.begin_offset();
+    std::vector<typename OPERATION::LHS> partial(
+      (end - begin + kernel_chunk_size - 1) / kernel_chunk_size,
+      OPERATION::identity);
+
+    detail::for_each_chunk(begin, end,
+      [&](size_t chunk, size_t chunk_begin, size_t chunk_end) {
+        auto & local = partial[chunk];
+        auto reduce = [&](auto && entity) {
+          function(std::forward<decltype(entity)>(entity), local);
+        };
+        detail::for_each_offset<false, ENTITY_TYPE>(
+          index_space, chunk_begin, chunk_end, reduce);
+      });
+
+    detail::reduce_chunks<OPERATION>(partial, reduction);
+    return;
+  } // if
+
+  for(size_t i(index_space.begin_offset()); i < end; ++i) {
+    function(std::forward<ENTITY_TYPE>(index_space.get_offset(i)), reduction);
+  } // for
+} // reduce_each_u
+
 } // namespace flecsi
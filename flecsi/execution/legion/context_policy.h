@@ -62,6 +62,7 @@ enum {
   MAPPER_COMPACTED_STORAGE = 0x00002000,
   MAPPER_SUBRANK_LAUNCH = 0x00003000,
   EXCLUSIVE_LR = 0x00004000,
+  MAPPER_IO_LAUNCH = 0x00005000,
   PREFER_GPU = 0x11000001,
   PREFER_OMP = 0x11000002,
 };
@@ -16,6 +16,7 @@
 /*! @file */
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <type_traits>
 
@@ -30,6 +31,7 @@
 
 #include <flecsi/utils/const_string.h>
 
+#include <flecsi/execution/common/instrumentation.h>
 #include <flecsi/execution/common/processor.h>
 #include <flecsi/execution/context.h>
 #include <flecsi/execution/legion/context_policy.h>
@@ -41,11 +43,6 @@
 #include <flecsi/execution/legion/task_prolog.h>
 #include <flecsi/execution/legion/task_wrapper.h>
 
-#if defined(ENABLE_CALIPER)
-#include <caliper/Annotation.h>
-#include <caliper/cali.h>
-#endif
-
 namespace flecsi {
 namespace execution {
 
@@ -145,6 +142,8 @@ struct legion_execution_policy_t {
 
     clog_assert(success, "callback registration failed for " << name);
 
+    instrument_task_name(TASK, name);
+
     return true;
   } // register_task
 
@@ -161,12 +160,6 @@ struct legion_execution_policy_t {
     typename... ARGS>
   static decltype(auto) execute_task(ARGS &&... args) {
 
-#if defined(ENABLE_CALIPER)
-    cali::Annotation et("FleCSI-Execution");
-    std::string tname = "execute_task with TASK HASH " + std::to_string(TASK);
-    cali::Annotation::Guard g(et.begin(tname.c_str()));
-#endif
-
     using namespace Legion;
 
     // This will guard the entire method
@@ -175,6 +168,8 @@ struct legion_execution_policy_t {
     // Make a tuple from the arugments passed by the user
     ARG_TUPLE task_args = std::make_tuple(std::forward<ARGS>(args)...);
 
+    instrument_task_launch(TASK);
+
     // Get the FleCSI runtime context
     context_t & context_ = context_t::instance();
 
@@ -207,23 +202,25 @@ struct legion_execution_policy_t {
 
       switch(processor_type) {
         case processor_type_t::toc:
-          launcher.tag = PREFER_GPU;
+        case processor_type_t::omp:
         case processor_type_t::loc: {
           clog(info) << "Executing single task: " << TASK << std::endl;
 
+          if(processor_type == processor_type_t::toc) {
+            launcher.tag = PREFER_GPU;
+          }
+          else if(processor_type == processor_type_t::omp) {
+            launcher.tag = PREFER_OMP;
+          } // if
+
           // Execute a tuple walker that initializes the handle arguments
           // that are passed to the task
-#if defined(ENABLE_CALIPER)
-          tname =
-            "TASK HASH " + std::to_string(TASK) + " single-launch init_args";
-          et.begin(tname.c_str());
-#endif
           init_args_t init_args(legion_runtime, legion_context);
-          init_args.walk(task_args);
+          {
+            task_phase_timer_t timer(TASK, task_phase_t::prolog);
+            init_args.walk(task_args);
+          } // scope
 
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
           // Add region requirements and future dependencies to the
           // task launcher
           for(auto & req : init_args.region_reqs) {
@@ -239,37 +236,23 @@ struct legion_execution_policy_t {
 
           // Execute a tuple walker that applies the task prolog operations
           // on the mapped handles
-#if defined(ENABLE_CALIPER)
-          tname = "TASK HASH " + std::to_string(TASK) +
-                  " single-launch task_prolog sparse false";
-          et.begin(tname.c_str());
-#endif
           {
+            task_phase_timer_t timer(TASK, task_phase_t::prolog);
             task_prolog_t task_prolog(
               legion_runtime, legion_context, launch_domain);
             task_prolog.sparse = false;
             task_prolog.walk(task_args);
             task_prolog.launch_copies();
           } // scope
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
 
-#if defined(ENABLE_CALIPER)
-          tname = "TASK HASH " + std::to_string(TASK) +
-                  " single-launch task_prolog sparse true";
-          et.begin(tname.c_str());
-#endif
           {
+            task_phase_timer_t timer(TASK, task_phase_t::prolog);
             task_prolog_t task_prolog(
               legion_runtime, legion_context, launch_domain);
             task_prolog.sparse = true;
             task_prolog.walk(task_args);
             task_prolog.launch_copies();
           } // scope
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
 
           // Enqueue the task.
           clog(trace) << "Execute flecsi/legion task " << TASK << " on rank "
@@ -278,16 +261,11 @@ struct legion_execution_policy_t {
 
           // Execute a tuple walker that applies the task epilog operations
           // on the mapped handles
-#if defined(ENABLE_CALIPER)
-          tname =
-            "TASK HASH " + std::to_string(TASK) + " single-launch task_epilog";
-          et.begin(tname.c_str());
-#endif
-          task_epilog_t task_epilog(legion_runtime, legion_context);
-          task_epilog.walk(task_args);
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
+          {
+            task_phase_timer_t timer(TASK, task_phase_t::epilog);
+            task_epilog_t task_epilog(legion_runtime, legion_context);
+            task_epilog.walk(task_args);
+          } // scope
 
           static_assert(
             REDUCTION == ZERO, "reductions are not supported for single tasks");
@@ -314,21 +292,17 @@ struct legion_execution_policy_t {
 
       switch(processor_type) {
         case processor_type_t::toc:
+        case processor_type_t::omp:
         case processor_type_t::loc: {
           clog(info) << "Executing index task: " << TASK << std::endl;
 
           // Execute a tuple walker that initializes the handle arguments
           // that are passed to the task
-#if defined(ENABLE_CALIPER)
-          tname =
-            "TASK HASH " + std::to_string(TASK) + " index-launch init_args";
-          et.begin(tname.c_str());
-#endif
           init_args_t init_args(legion_runtime, legion_context);
-          init_args.walk(task_args);
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
+          {
+            task_phase_timer_t timer(TASK, task_phase_t::prolog);
+            init_args.walk(task_args);
+          } // scope
 
           LegionRuntime::Arrays::Rect<1> launch_bounds(
             LegionRuntime::Arrays::Point<1>(0),
@@ -344,6 +318,9 @@ struct legion_execution_policy_t {
           if(processor_type == processor_type_t::toc) {
             launcher.tag = PREFER_GPU;
           }
+          else if(processor_type == processor_type_t::omp) {
+            launcher.tag = PREFER_OMP;
+          } // if
 
           // Add region requirements and future dependencies to the
           // task launcher
@@ -357,37 +334,23 @@ struct legion_execution_policy_t {
 
           // Execute a tuple walker that applies the task prolog operations
           // on the mapped handles
-#if defined(ENABLE_CALIPER)
-          tname = "TASK HASH " + std::to_string(TASK) +
-                  " index-launch task_prolog sparse false";
-          et.begin(tname.c_str());
-#endif
           {
+            task_phase_timer_t timer(TASK, task_phase_t::prolog);
             task_prolog_t task_prolog(
               legion_runtime, legion_context, launch_domain);
             task_prolog.sparse = false;
             task_prolog.walk(task_args);
             task_prolog.launch_copies();
           } // scope
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
 
-#if defined(ENABLE_CALIPER)
-          tname = "TASK HASH " + std::to_string(TASK) +
-                  " index-launch task_prolog sparse true";
-          et.begin(tname.c_str());
-#endif
           {
+            task_phase_timer_t timer(TASK, task_phase_t::prolog);
             task_prolog_t task_prolog(
               legion_runtime, legion_context, launch_domain);
             task_prolog.sparse = true;
             task_prolog.walk(task_args);
             task_prolog.launch_copies();
           } // scope
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
 
           if constexpr(REDUCTION != ZERO) {
             clog(info) << "executing reduction logic for " << REDUCTION
@@ -404,16 +367,11 @@ struct legion_execution_policy_t {
               legion_context, launcher, reduction_id);
 
             // Enqueue the epilog.
-#if defined(ENABLE_CALIPER)
-            tname =
-              "TASK HASH " + std::to_string(TASK) + " index-launch task_epilog";
-            et.begin(tname.c_str());
-#endif
-            task_epilog_t task_epilog(legion_runtime, legion_context);
-            task_epilog.walk(task_args);
-#if defined(ENABLE_CALIPER)
-            et.end();
-#endif
+            {
+              task_phase_timer_t timer(TASK, task_phase_t::epilog);
+              task_epilog_t task_epilog(legion_runtime, legion_context);
+              task_epilog.walk(task_args);
+            } // scope
 
             return legion_future_u<RETURN, launch_type_t::single>(future);
           }
@@ -424,16 +382,11 @@ struct legion_execution_policy_t {
 
             // Execute a tuple walker that applies the task epilog operations
             // on the mapped handles
-#if defined(ENABLE_CALIPER)
-            tname =
-              "TASK HASH " + std::to_string(TASK) + " index-launch task_epilog";
-            et.begin(tname.c_str());
-#endif
-            task_epilog_t task_epilog(legion_runtime, legion_context);
-            task_epilog.walk(task_args);
-#if defined(ENABLE_CALIPER)
-            et.end();
-#endif
+            {
+              task_phase_timer_t timer(TASK, task_phase_t::epilog);
+              task_epilog_t task_epilog(legion_runtime, legion_context);
+              task_epilog.walk(task_args);
+            } // scope
 
             return legion_future_u<RETURN, launch_type_t::index>(future_map);
           } // else
@@ -442,17 +395,16 @@ struct legion_execution_policy_t {
         case processor_type_t::mpi: {
           clog(info) << "Executing MPI task: " << TASK << std::endl;
 
+          // The handoff to MPI waits on the task, which cannot be replayed.
+          clog_assert(!tracing_, "MPI tasks cannot be executed in a trace");
+
           // Execute a tuple walker that initializes the handle arguments
           // that are passed to the task
-#if defined(ENABLE_CALIPER)
-          tname = "TASK HASH " + std::to_string(TASK) + " mpi-launch init_args";
-          et.begin(tname.c_str());
-#endif
           init_args_t init_args(legion_runtime, legion_context);
-          init_args.walk(task_args);
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
+          {
+            task_phase_timer_t timer(TASK, task_phase_t::prolog);
+            init_args.walk(task_args);
+          } // scope
 
           // FIXME: This will need to change with the new control model
           //         if(context_.execution_state() == SPECIALIZATION_TLT_INIT) {
@@ -482,37 +434,23 @@ struct legion_execution_policy_t {
 
           // Execute a tuple walker that applies the task prolog operations
           // on the mapped handles
-#if defined(ENABLE_CALIPER)
-          tname = "TASK HASH " + std::to_string(TASK) +
-                  " mpi-launch task_prolog sparse false";
-          et.begin(tname.c_str());
-#endif
           {
+            task_phase_timer_t timer(TASK, task_phase_t::prolog);
             task_prolog_t task_prolog(
               legion_runtime, legion_context, launch_domain);
             task_prolog.sparse = false;
             task_prolog.walk(task_args);
             task_prolog.launch_copies();
           } // scope
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
 
-#if defined(ENABLE_CALIPER)
-          tname = "TASK HASH " + std::to_string(TASK) +
-                  " mpi-launch task_prolog sparse true";
-          et.begin(tname.c_str());
-#endif
           {
+            task_phase_timer_t timer(TASK, task_phase_t::prolog);
             task_prolog_t task_prolog(
               legion_runtime, legion_context, launch_domain);
             task_prolog.sparse = true;
             task_prolog.walk(task_args);
             task_prolog.launch_copies();
           } // scope
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
 
           // Launch the MPI task
           auto future =
@@ -531,16 +469,11 @@ struct legion_execution_policy_t {
 
           // Execute a tuple walker that applies the task epilog operations
           // on the mapped handles
-#if defined(ENABLE_CALIPER)
-          tname =
-            "TASK HASH " + std::to_string(TASK) + " mpi-launch task_epilog";
-          et.begin(tname.c_str());
-#endif
-          task_epilog_t task_epilog(legion_runtime, legion_context);
-          task_epilog.walk(task_args);
-#if defined(ENABLE_CALIPER)
-          et.end();
-#endif
+          {
+            task_phase_timer_t timer(TASK, task_phase_t::epilog);
+            task_epilog_t task_epilog(legion_runtime, legion_context);
+            task_epilog.walk(task_args);
+          } // scope
 
           if constexpr(REDUCTION != ZERO) {
             clog_fatal("there is no implementation for the mpi"
@@ -618,6 +551,47 @@ struct legion_execution_policy_t {
     } // if constexpr
   } // execute_task
 
+  //------------------------------------------------------------------------//
+  // Trace interface.
+  //------------------------------------------------------------------------//
+
+  /*!
+    Legion backend trace. The dependence analysis of the tasks and
+    copies that are launched in a trace is captured on its first
+    execution and replayed on the following ones. For documentation on
+    this method, please see task_interface_u::begin_trace.
+   */
+
+  static void begin_trace(size_t trace) {
+    clog_assert(!tracing_, "traces cannot be nested");
+    tracing_ = true;
+    trace_ = trace_id(trace);
+    Legion::Runtime::get_runtime()->begin_trace(
+      Legion::Runtime::get_context(), trace_);
+  } // begin_trace
+
+  /*!
+    Legion backend trace. For documentation on this method, please see
+    task_interface_u::end_trace.
+   */
+
+  static void end_trace(size_t trace) {
+    clog_assert(tracing_, "no trace to end");
+    tracing_ = false;
+    Legion::Runtime::get_runtime()->end_trace(
+      Legion::Runtime::get_context(), trace_);
+  } // end_trace
+
+  /*!
+    Legion backend trace invalidation. The traces are given new Legion
+    trace ids, which are recorded again on their next execution. A trace
+    in progress ends with its current id.
+   */
+
+  static void invalidate_traces() {
+    trace_ids_.clear();
+  } // invalidate_traces
+
   //------------------------------------------------------------------------//
   // Function interface.
   //------------------------------------------------------------------------//
@@ -666,6 +640,27 @@ struct legion_execution_policy_t {
       HASH, wrapper_t::registration_callback);
   } // register_reduction_operation
 
+private:
+  // Whether the top-level task is in a trace.
+  static inline bool tracing_ = false;
+
+  /*!
+    Return the Legion trace id of a trace.
+   */
+
+  static Legion::TraceID trace_id(size_t trace) {
+    auto it = trace_ids_.find(trace);
+    if(it == trace_ids_.end()) {
+      it = trace_ids_.emplace(trace, next_trace_id_++).first;
+    } // if
+    return it->second;
+  } // trace_id
+
+  // The Legion trace id of the trace in progress, and of each trace.
+  static inline Legion::TraceID trace_ = 0;
+  static inline std::map<size_t, Legion::TraceID> trace_ids_;
+  static inline Legion::TraceID next_trace_id_ = 0;
+
 }; // struct legion_execution_policy_t
 
 } // namespace execution
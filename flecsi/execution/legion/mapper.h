@@ -21,6 +21,15 @@
 #error FLECSI_ENABLE_LEGION not defined! This file depends on Legion!
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
 #include <default_mapper.h>
 #include <legion.h>
 #include <legion_mapping.h>
@@ -44,6 +53,95 @@ enum {
 namespace flecsi {
 namespace execution {
 
+/*!
+ The mapper_options_t type holds the options of the FleCSI mapper, which
+ are given on the command line, as those of the Legion default mapper:
+
+   -fm:memoize  Reuse the mapping of identical task launches, and let
+                Legion memoize the mappings of traced launches.
+   -fm:numa     Map the instances of a task to the NUMA memory of its
+                processor, and run the task on that processor.
+   -fm:stats    Report the mapping statistics of each process.
+
+ @ingroup legion-execution
+ */
+
+struct mapper_options_t {
+  bool memoize = false;
+  bool numa = false;
+  bool stats = false;
+}; // struct mapper_options_t
+
+/*!
+ Return the options of the FleCSI mapper.
+
+ @ingroup legion-execution
+ */
+
+inline const mapper_options_t &
+mapper_options() {
+  static const mapper_options_t options = []() {
+    mapper_options_t result;
+    const Legion::InputArgs & args = Legion::Runtime::get_input_args();
+
+    for(int i = 1; i < args.argc; ++i) {
+      const std::string arg(args.argv[i]);
+
+      if(arg == "-fm:memoize")
+        result.memoize = true;
+      else if(arg == "-fm:numa")
+        result.numa = true;
+      else if(arg == "-fm:stats")
+        result.stats = true;
+    } // for
+
+    return result;
+  }();
+
+  return options;
+} // mapper_options
+
+/*!
+ The mapper_statistics_t type accumulates the mapping statistics of the
+ mappers of a process.
+
+ @ingroup legion-execution
+ */
+
+struct mapper_statistics_t {
+
+  /*!
+   Write the statistics to the given stream.
+   */
+
+  void report(std::ostream & stream) const {
+    stream << "tasks mapped: " << tasks << std::endl
+           << "  memoized mappings: " << memoized << std::endl
+           << "  instances created: " << instances << " ("
+           << instance_bytes << " bytes)" << std::endl
+           << "  mapping time: " << mapping_ns * 1.e-9 << " s" << std::endl;
+  } // report
+
+  std::atomic<size_t> tasks{0};
+  std::atomic<size_t> memoized{0};
+  std::atomic<size_t> instances{0};
+  std::atomic<size_t> instance_bytes{0};
+  std::atomic<size_t> mapping_ns{0};
+
+}; // struct mapper_statistics_t
+
+/*!
+ Return the mapping statistics of the process.
+
+ @ingroup legion-execution
+ */
+
+inline mapper_statistics_t &
+mapper_statistics() {
+  static mapper_statistics_t statistics;
+  return statistics;
+} // mapper_statistics
+
 /*
  The mpi_mapper_t - is a custom mapper that handles mpi-legion
  interoperability in FLeCSI
@@ -136,7 +234,8 @@ public:
       clog_tag_guard(legion_mapper);
       clog(info) << "Mapper constuctor: local=" << local
                  << " cpus=" << local_cpus.size()
-                 << " gpus=" << local_gpus.size() << " sysmem=" << local_sysmem
+                 << " gpus=" << local_gpus.size()
+                 << " omps=" << local_omps.size() << " sysmem=" << local_sysmem
                  << std::endl;
     }
   } // end mpi_mapper_t
@@ -267,6 +366,9 @@ public:
                << " allocates physical instance with size " << instance_size
                << " for the region requirement #" << indx << std::endl;
 
+    ++mapper_statistics().instances;
+    mapper_statistics().instance_bytes += instance_size;
+
     if(instance_size > 1000000000) {
       clog(error) << "task " << task.get_task_name()
                   << " is trying to allocate physical instance with \
@@ -336,6 +438,11 @@ public:
                << " allocates physical instance with size " << instance_size
                << " for the region requirement #" << indx << std::endl;
 
+    if(created) {
+      ++mapper_statistics().instances;
+      mapper_statistics().instance_bytes += instance_size;
+    } // if
+
     if(instance_size > 1000000000) {
       clog(error) << "task " << task.get_task_name()
                   << " is trying to allocate physical compacted instance with \
@@ -395,6 +502,11 @@ public:
                << " allocates physical instance with size " << instance_size
                << " for the region requirement #" << indx << std::endl;
 
+    if(created) {
+      ++mapper_statistics().instances;
+      mapper_statistics().instance_bytes += instance_size;
+    } // if
+
     if(instance_size > 1000000000) {
       clog(error)
         << "task " << task.get_task_name()
@@ -414,6 +526,10 @@ public:
      "MAPPER_COMPACTED_STORAGE" tag, mapper will create single physical
    instance for exclusive, shared and ghost partitions for each data handle
 
+   With -fm:memoize, the mapping of a launch is reused by the following
+   launches of the same task on the same processor, regions, privileges
+   and fields, as long as its instances can be acquired.
+
     @param ctx Mapper Context
     @param task Legion's task
     @param input Input information about task mapping
@@ -424,18 +540,96 @@ public:
     const Legion::Task & task,
     const Legion::Mapping::Mapper::MapTaskInput & input,
     Legion::Mapping::Mapper::MapTaskOutput & output) {
+    const auto start = std::chrono::steady_clock::now();
+    const mapper_options_t & options = mapper_options();
+
+    mapping_key_t key;
+    const bool memoize = options.memoize && memoizable(task, key);
+
+    bool memoized = false;
+    if(memoize) {
+      auto finder = memoized_mappings_.find(key);
+      if(finder != memoized_mappings_.end()) {
+        output.chosen_variant = finder->second.chosen_variant;
+        output.target_procs = finder->second.target_procs;
+        output.chosen_instances = finder->second.chosen_instances;
+
+        // The instances may have been collected, in which case the task
+        // is mapped again. The runtime call can preempt this mapper and
+        // let another call change the memoized mappings, so finder must
+        // not be used after it.
+        memoized = runtime->acquire_instances(ctx, output.chosen_instances);
+        if(!memoized) {
+          memoized_mappings_.erase(key);
+          output.target_procs.clear();
+          output.chosen_instances.clear();
+        } // if
+      } // if
+    } // if
+
+    if(!memoized) {
+      map_task_instances(ctx, task, output);
+
+      if(memoize) {
+        memoized_mappings_[key] = {output.chosen_variant, output.target_procs,
+          output.chosen_instances};
+      } // if
+    } // if
+
+    auto & statistics = mapper_statistics();
+    ++statistics.tasks;
+    if(memoized) {
+      ++statistics.memoized;
+    } // if
+    const std::chrono::nanoseconds elapsed =
+      std::chrono::steady_clock::now() - start;
+    statistics.mapping_ns += elapsed.count();
+  } // map_task
+
+  /*!
+   Let Legion memoize the mappings of the operations of traced launches
+   with -fm:memoize, so that their replay skips the mapper calls.
+   */
+
+  virtual void memoize_operation(const Legion::Mapping::MapperContext ctx,
+    const Legion::Mappable & mappable,
+    const Legion::Mapping::Mapper::MemoizeInput & input,
+    Legion::Mapping::Mapper::MemoizeOutput & output) {
+    output.memoize = mapper_options().memoize;
+  } // memoize_operation
+
+  /*!
+   Select the variant, processors and instances of a task.
+
+    @param ctx Mapper Context
+    @param task Legion's task
+    @param output Output information about task mapping
+   */
+
+  void map_task_instances(const Legion::Mapping::MapperContext ctx,
+    const Legion::Task & task,
+    Legion::Mapping::Mapper::MapTaskOutput & output) {
 
     using namespace Legion;
     using namespace Legion::Mapping;
 
-    if((task.tag & PREFER_GPU) && !local_gpus.empty()) {
+    const mapper_options_t & options = mapper_options();
+
+    // The tags share their high bits, so that they are compared, not
+    // masked.
+    if((task.tag == PREFER_GPU) && !local_gpus.empty()) {
       output.chosen_variant = find_gpu_variant(ctx, task.task_id);
       output.target_procs.push_back(task.target_proc);
     }
-    else if((task.tag & PREFER_OMP) && !local_omps.empty()) {
+    else if((task.tag == PREFER_OMP) && !local_omps.empty()) {
       output.chosen_variant = find_omp_variant(ctx, task.task_id);
       output.target_procs = local_omps;
     }
+    else if(options.numa) {
+      // The task runs next to the memory of its instances.
+      output.chosen_variant = find_cpu_variant(ctx, task.task_id);
+      output.target_procs.push_back(task.target_proc);
+    }
     else {
       output.chosen_variant = find_cpu_variant(ctx, task.task_id);
       output.target_procs = local_cpus;
@@ -450,12 +644,17 @@ public:
       //     DefaultMapper::default_policy_select_target_memory(
       //       ctx, task.target_proc, task.regions[0]);
 
-      if((task.tag & PREFER_GPU) && !local_gpus.empty())
+      const bool gpu = (task.tag == PREFER_GPU) && !local_gpus.empty();
+
+      if(gpu)
         target_mem = local_framebuffer;
+      else if(options.numa)
+        target_mem = numa_memory(task.target_proc);
       else
         target_mem = local_sysmem;
 
-      // creating ordering constraint (SOA )
+      // creating ordering constraint (SOA), which the raw pointers of the
+      // accessors assume
       std::vector<Legion::DimensionKind> ordering;
       ordering.push_back(Legion::DimensionKind::DIM_Y);
       ordering.push_back(Legion::DimensionKind::DIM_X);
@@ -501,7 +700,29 @@ public:
 
     runtime->acquire_instances(ctx, output.chosen_instances);
 
-  } // map_task
+  } // map_task_instances
+
+  /*!
+   Return the NUMA memory with the best affinity to a processor, or the
+   system memory if there is none.
+   */
+
+  Legion::Memory numa_memory(Legion::Processor proc) {
+    auto finder = numa_memories_.find(proc);
+    if(finder != numa_memories_.end())
+      return finder->second;
+
+    Legion::Machine::MemoryQuery numa_query(machine);
+    numa_query.only_kind(Legion::Memory::SOCKET_MEM);
+    numa_query.best_affinity_to(proc);
+    Legion::Memory memory = numa_query.first();
+
+    if(!memory.exists())
+      memory = local_sysmem;
+
+    numa_memories_[proc] = memory;
+    return memory;
+  } // numa_memory
 
   virtual void slice_task(const Legion::Mapping::MapperContext ctx,
     const Legion::Task & task,
@@ -554,6 +775,40 @@ public:
       return;
     } // MAPPER_FORCE_RANK_MATCH
 
+    if(task.tag == MAPPER_IO_LAUNCH) {
+      // expect a 1-D index domain - every point writes its own file, so
+      // each point is given its own processor on the node that holds the
+      // corresponding block of colors, and the files are written
+      // concurrently
+      assert(input.domain.get_dim() == 1);
+      std::map<Legion::AddressSpace, std::vector<Legion::Processor>> targets;
+
+      Legion::Machine::ProcessorQuery pq =
+        Legion::Machine::ProcessorQuery(machine).only_kind(
+          Legion::Processor::LOC_PROC);
+      for(Legion::Machine::ProcessorQuery::iterator it = pq.begin();
+          it != pq.end(); ++it) {
+        targets[it->address_space()].push_back(*it);
+      }
+
+      const Legion::coord_t first = task.index_domain.lo()[0];
+      const size_t points = task.index_domain.get_volume();
+      std::map<Legion::AddressSpace, size_t> next;
+      for(Domain::DomainPointIterator itr(input.domain); itr; itr++) {
+        Legion::AddressSpace a =
+          Legion::AddressSpace((itr.p[0] - first) * targets.size() / points);
+        std::vector<Legion::Processor> & procs = targets[a];
+        assert(!procs.empty());
+        TaskSlice slice;
+        slice.domain = Domain(itr.p, itr.p);
+        slice.proc = procs[next[a]++ % procs.size()];
+        slice.recurse = false;
+        slice.stealable = false;
+        output.slices.push_back(slice);
+      }
+      return;
+    } // MAPPER_IO_LAUNCH
+
     // We've already been control replicated, so just divide our points
     // over the local processors, depending on which kind we prefer
     if((task.tag == PREFER_GPU) && !local_gpus.empty()) {
@@ -600,6 +855,55 @@ public:
   } // slice_task
 
 private:
+  // The key of a memoized mapping: the task, its processor and tag, and
+  // the region, privilege, tag and fields of each region requirement.
+  struct mapping_key_t {
+    Legion::TaskID task_id;
+    Legion::MappingTagID tag;
+    Legion::Processor proc;
+    std::vector<std::tuple<Legion::LogicalRegion,
+      Legion::PrivilegeMode,
+      Legion::MappingTagID,
+      std::set<Legion::FieldID>>>
+      regions;
+
+    bool operator<(const mapping_key_t & key) const {
+      return std::tie(task_id, tag, proc, regions) <
+             std::tie(key.task_id, key.tag, key.proc, key.regions);
+    } // operator <
+  }; // struct mapping_key_t
+
+  struct mapping_t {
+    Legion::VariantID chosen_variant;
+    std::vector<Legion::Processor> target_procs;
+    std::vector<std::vector<Legion::Mapping::PhysicalInstance>>
+      chosen_instances;
+  }; // struct mapping_t
+
+  /*!
+   Compute the key of the mapping of a task. Tasks with reductions are
+   not memoized, since their reduction instances are not reused.
+   */
+
+  static bool memoizable(const Legion::Task & task, mapping_key_t & key) {
+    key.task_id = task.task_id;
+    key.tag = task.tag;
+    key.proc = task.target_proc;
+
+    for(const auto & req : task.regions) {
+      if(req.privilege == REDUCE)
+        return false;
+
+      key.regions.emplace_back(
+        req.region, req.privilege, req.tag, req.privilege_fields);
+    } // for
+
+    return true;
+  } // memoizable
+
+  std::map<mapping_key_t, mapping_t> memoized_mappings_;
+  std::map<Legion::Processor, Legion::Memory> numa_memories_;
+
   std::map<Legion::Processor, std::map<Realm::Memory::Kind, Realm::Memory>>
     proc_mem_map;
   Realm::Machine machine;
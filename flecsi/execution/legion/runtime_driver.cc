@@ -15,6 +15,8 @@
 
 #include <flecsi/execution/legion/runtime_driver.h>
 
+#include <fstream>
+#include <iostream>
 #include <legion.h>
 #include <legion_utilities.h>
 #include <limits>
@@ -162,6 +164,12 @@ runtime_driver(const Legion::Task * task,
   specialization_tlt_init(args.argc, args.argv);
   remap_shared_entities();
 
+  // Write the coloring quality report if it was requested.
+  if(!context_.coloring_report().empty()) {
+    std::ofstream report(context_.coloring_report());
+    flecsi::coloring::write_json(report, context_.coloring_quality());
+  } // if
+
   context_.advance_state();
 #endif // FLECSI_ENABLE_SPECIALIZATION_TLT_INIT
 
@@ -566,6 +574,15 @@ runtime_driver(const Legion::Task * task,
   // ----------------------------------------------------------------------//
 
   context_.unset_call_mpi(ctx, runtime);
+
+  // Report the mapping statistics of the process, once the tasks of the
+  // driver have been mapped.
+  if(mapper_options().stats) {
+    runtime->issue_execution_fence(ctx).wait();
+    std::cout << "mapper statistics of rank " << context_.color() << ": ";
+    mapper_statistics().report(std::cout);
+  } // if
+
   context_.handoff_to_mpi(ctx, runtime);
 
 #if defined(ENABLE_CALIPER)
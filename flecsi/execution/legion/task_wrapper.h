@@ -16,6 +16,7 @@
 /*! @file */
 
 #include <string>
+#include <vector>
 
 #include <cinchlog.h>
 #include <flecsi-config.h>
@@ -26,6 +27,7 @@
 
 #include <legion.h>
 
+#include <flecsi/execution/common/instrumentation.h>
 #include <flecsi/execution/common/launch.h>
 #include <flecsi/execution/common/processor.h>
 #include <flecsi/execution/context.h>
@@ -35,16 +37,50 @@
 #include <flecsi/utils/tuple_function.h>
 #include <flecsi/utils/tuple_type_converter.h>
 
-#if defined(ENABLE_CALIPER)
-#include <caliper/Annotation.h>
-#include <caliper/cali.h>
-#endif
-
 clog_register_tag(task_wrapper);
 
 namespace flecsi {
 namespace execution {
 
+/*!
+  Return the Legion processor kinds of the variants of a task with the
+  given processor type. OpenMP tasks also have a CPU variant, which is
+  used on the nodes without OpenMP processors.
+
+  @ingroup legion-execution
+ */
+
+inline std::vector<Legion::Processor::Kind>
+processor_kinds(processor_type_t processor_type) {
+  switch(processor_type) {
+    case processor_type_t::toc:
+      return {Legion::Processor::TOC_PROC};
+    case processor_type_t::omp:
+      return {Legion::Processor::OMP_PROC, Legion::Processor::LOC_PROC};
+    default:
+      return {Legion::Processor::LOC_PROC};
+  } // switch
+} // processor_kinds
+
+/*!
+  Return the processor type of a task that executes on a processor of
+  the given Legion kind.
+
+  @ingroup legion-execution
+ */
+
+inline processor_type_t
+processor_type(Legion::Processor::Kind kind) {
+  switch(kind) {
+    case Legion::Processor::TOC_PROC:
+      return processor_type_t::toc;
+    case Legion::Processor::OMP_PROC:
+      return processor_type_t::omp;
+    default:
+      return processor_type_t::loc;
+  } // switch
+} // processor_type
+
 /*!
   Pure Legion task wrapper.
 
@@ -85,36 +121,35 @@ struct pure_task_wrapper_u {
       clog(info) << "registering pure Legion task " << name << std::endl;
     }
 
-    Legion::TaskVariantRegistrar registrar(tid, name.c_str());
-    Legion::Processor::Kind kind = processor_type == processor_type_t::toc
-                                     ? Legion::Processor::TOC_PROC
-                                     : Legion::Processor::LOC_PROC;
-    registrar.add_constraint(Legion::ProcessorConstraint(kind));
-    registrar.set_leaf(launch_leaf(launch));
-    registrar.set_inner(launch_inner(launch));
-    registrar.set_idempotent(launch_idempotent(launch));
-
-    /*
-      This section of conditionals is necessary because there is still
-      a distinction between void and non-void task registration with
-      Legion, and we still have to use different execution tasks for
-      normal and MPI tasks. MPI tasks are required to have void returns,
-      so there is no mpi case for non-void tasks.
-     */
-
-    if constexpr(std::is_same_v<RETURN, void>) {
-      if(processor_type == processor_type_t::mpi) {
-        clog_fatal("MPI type passed to pure task registration");
+    for(auto kind : processor_kinds(processor_type)) {
+      Legion::TaskVariantRegistrar registrar(tid, name.c_str());
+      registrar.add_constraint(Legion::ProcessorConstraint(kind));
+      registrar.set_leaf(launch_leaf(launch));
+      registrar.set_inner(launch_inner(launch));
+      registrar.set_idempotent(launch_idempotent(launch));
+
+      /*
+        This section of conditionals is necessary because there is still
+        a distinction between void and non-void task registration with
+        Legion, and we still have to use different execution tasks for
+        normal and MPI tasks. MPI tasks are required to have void
+        returns, so there is no mpi case for non-void tasks.
+       */
+
+      if constexpr(std::is_same_v<RETURN, void>) {
+        if(processor_type == processor_type_t::mpi) {
+          clog_fatal("MPI type passed to pure task registration");
+        }
+        else {
+          Legion::Runtime::preregister_task_variant<TASK>(
+            registrar, name.c_str());
+        } // if
       }
       else {
-        Legion::Runtime::preregister_task_variant<TASK>(
+        Legion::Runtime::preregister_task_variant<RETURN, TASK>(
           registrar, name.c_str());
       } // if
-    }
-    else {
-      Legion::Runtime::preregister_task_variant<RETURN, TASK>(
-        registrar, name.c_str());
-    } // if
+    } // for
   } // registration_callback
 
 }; // struct pure_task_wrapper_u
@@ -165,38 +200,37 @@ struct task_wrapper_u {
     // for(int i = 0; i < 4; i++)
     //  short_name = short_name.erase(0, short_name.find(":") + 2);
 
-    // Legion::TaskVariantRegistrar registrar(tid, short_name.c_str());
-    Legion::TaskVariantRegistrar registrar(tid, name.c_str());
-    Legion::Processor::Kind kind = processor_type == processor_type_t::toc
-                                     ? Legion::Processor::TOC_PROC
-                                     : Legion::Processor::LOC_PROC;
-    registrar.add_constraint(Legion::ProcessorConstraint(kind));
-    registrar.set_leaf(launch_leaf(launch));
-    registrar.set_inner(launch_inner(launch));
-    registrar.set_idempotent(launch_idempotent(launch));
-
-    /*
-      This section of conditionals is necessary because there is still
-      a distinction between void and non-void task registration with
-      Legion, and we still have to use different execution tasks for
-      normal and MPI tasks. MPI tasks are required to have void returns,
-      so there is no mpi case for non-void tasks.
-     */
-
-    if constexpr(std::is_same_v<RETURN, void>) {
-      if(processor_type == processor_type_t::mpi) {
-        Legion::Runtime::preregister_task_variant<execute_mpi_task>(
-          registrar, name.c_str());
+    for(auto kind : processor_kinds(processor_type)) {
+      // Legion::TaskVariantRegistrar registrar(tid, short_name.c_str());
+      Legion::TaskVariantRegistrar registrar(tid, name.c_str());
+      registrar.add_constraint(Legion::ProcessorConstraint(kind));
+      registrar.set_leaf(launch_leaf(launch));
+      registrar.set_inner(launch_inner(launch));
+      registrar.set_idempotent(launch_idempotent(launch));
+
+      /*
+        This section of conditionals is necessary because there is still
+        a distinction between void and non-void task registration with
+        Legion, and we still have to use different execution tasks for
+        normal and MPI tasks. MPI tasks are required to have void
+        returns, so there is no mpi case for non-void tasks.
+       */
+
+      if constexpr(std::is_same_v<RETURN, void>) {
+        if(processor_type == processor_type_t::mpi) {
+          Legion::Runtime::preregister_task_variant<execute_mpi_task>(
+            registrar, name.c_str());
+        }
+        else {
+          Legion::Runtime::preregister_task_variant<execute_user_task>(
+            registrar, name.c_str());
+        } // if
       }
       else {
-        Legion::Runtime::preregister_task_variant<execute_user_task>(
+        Legion::Runtime::preregister_task_variant<RETURN, execute_user_task>(
           registrar, name.c_str());
       } // if
-    }
-    else {
-      Legion::Runtime::preregister_task_variant<RETURN, execute_user_task>(
-        registrar, name.c_str());
-    } // if
+    } // for
 
   } // registration_callback
 
@@ -213,67 +247,44 @@ struct task_wrapper_u {
       clog(info) << "In execute_user_task" << std::endl;
     }
 
-#if defined(ENABLE_CALIPER)
-    cali::Annotation tw("FleCSI-Execution");
-    std::string tname = task->get_task_name();
-    std::string tname1 = "execute_task->init-handles->" + tname;
-    tw.begin(tname1.c_str());
-#endif
     // Unpack task arguments
     ARG_TUPLE & task_args = *(reinterpret_cast<ARG_TUPLE *>(task->args));
 
-    init_handles_t init_handles(runtime, context, regions, task->futures);
-    init_handles.walk(task_args);
-
-#if defined(ENABLE_CALIPER)
-    tw.end();
-#endif
+    {
+      task_phase_timer_t timer(KEY, task_phase_t::prolog);
+      init_handles_t init_handles(runtime, context, regions, task->futures);
+      init_handles.walk(task_args);
+    } // scope
 
     context_t & context_ = context_t::instance();
     context_.set_color(task->index_point.point_data[0]);
 
-    if constexpr(std::is_same_v<RETURN, void>) {
-
-#if defined(ENABLE_CALIPER)
-      tname1 = "execute_task->user_task->" + tname;
-      tw.begin(tname1.c_str());
-#endif
-      (*DELEGATE)(std::forward<ARG_TUPLE>(task_args));
-
-#if defined(ENABLE_CALIPER)
-      tw.end();
-      tname1 = "execute_task->finalize-handles->" + tname;
-      tw.begin(tname1.c_str());
-#endif
+    // Let the kernels of OpenMP variants run threaded.
+    task_processor_guard_t processor_guard(
+      processor_type(task->target_proc.kind()));
 
+    // Finalize the handles when the user task returns.
+    auto finalize = [&]() {
+      task_phase_timer_t timer(KEY, task_phase_t::finalize);
       finalize_handles_t finalize_handles;
       finalize_handles.walk(task_args);
+    };
 
-#if defined(ENABLE_CALIPER)
-      tw.end();
-#endif
+    if constexpr(std::is_same_v<RETURN, void>) {
+      {
+        task_phase_timer_t timer(KEY, task_phase_t::user);
+        (*DELEGATE)(std::forward<ARG_TUPLE>(task_args));
+      } // scope
+
+      finalize();
     }
     else {
+      RETURN result = [&]() {
+        task_phase_timer_t timer(KEY, task_phase_t::user);
+        return (*DELEGATE)(std::forward<ARG_TUPLE>(task_args));
+      }();
 
-#if defined(ENABLE_CALIPER)
-      tname1 = "execute_task->user_task->" + tname;
-      tw.begin(tname1.c_str());
-#endif
-
-      RETURN result = (*DELEGATE)(std::forward<ARG_TUPLE>(task_args));
-
-#if defined(ENABLE_CALIPER)
-      tw.end();
-      tname1 = "execute_task->finalize-handles->" + tname;
-      tw.begin(tname1.c_str());
-#endif
-
-      finalize_handles_t finalize_handles;
-      finalize_handles.walk(task_args);
-
-#if defined(ENABLE_CALIPER)
-      tw.end();
-#endif
+      finalize();
 
       return result;
     } // if
@@ -35,10 +35,12 @@
 #include <flecsi/coloring/index_coloring.h>
 #include <flecsi/coloring/mpi_utils.h>
 #include <flecsi/data/common/data_types.h>
+#include <flecsi/data/common/placement.h>
 #include <flecsi/data/common/row_vector.h>
 #include <flecsi/data/common/serdez.h>
 #include <flecsi/execution/common/launch.h>
 #include <flecsi/execution/common/processor.h>
+#include <flecsi/execution/mpi/field_allocator.h>
 #include <flecsi/execution/mpi/future.h>
 #include <flecsi/execution/mpi/runtime_driver.h>
 #include <flecsi/runtime/types.h>
@@ -307,6 +309,7 @@ struct mpi_context_policy_t {
       MPI_INFO_NULL, MPI_COMM_WORLD, &metadata.win);
 
     field_metadata.insert({fid, metadata});
+    ++metadata_generation_;
   }
 
   /*!
@@ -325,6 +328,7 @@ struct mpi_context_policy_t {
       metadata.compact_target_lengs, metadata.compact_target_disps);
 
     sparse_field_metadata.insert({fid, metadata});
+    ++metadata_generation_;
   }
 
   /*!
@@ -504,20 +508,25 @@ struct mpi_context_policy_t {
 
   /*!
    Register new field data, i.e. allocate a new buffer for the specified field
-   ID.
+   ID. The placement applies when the buffer is allocated.
    */
-  void register_field_data(field_id_t fid, size_t size) {
+  void register_field_data(field_id_t fid,
+    size_t size,
+    const data::placement_t & placement = {}) {
     // TODO: VERSIONS
     auto it = field_data.find(fid);
     if(it == field_data.end()) {
-      field_data.insert({fid, std::vector<uint8_t>(size)});
+      field_data.emplace(
+        fid, field_storage_t(size, field_allocator_u<uint8_t>(placement)));
     }
     else {
       it->second.resize(size);
     }
+    mark_field_written(fid);
+    ++metadata_generation_;
   }
 
-  std::map<field_id_t, std::vector<uint8_t>> & registered_field_data() {
+  std::map<field_id_t, field_storage_t> & registered_field_data() {
     return field_data;
   }
 
@@ -542,6 +551,8 @@ struct mpi_context_policy_t {
     else {
       it->second = std::move(new_field);
     }
+    mark_field_written(fid);
+    ++metadata_generation_;
   }
 
   std::map<field_id_t, sparse_field_data_t> & registered_sparse_field_data() {
@@ -553,6 +564,55 @@ struct mpi_context_policy_t {
     return sparse_field_metadata;
   };
 
+  /*!
+   Record that the data of a field have been modified. Every
+   modification gets a new write epoch, so that the fields that were
+   modified since some point, e.g., the last checkpoint, can be found.
+   Tasks mark the fields that they have write privileges on, and data
+   that are modified outside of tasks must be marked explicitly.
+   */
+
+  void mark_field_written(field_id_t fid) {
+    field_write_epochs_[fid] = ++write_epoch_;
+  } // mark_field_written
+
+  /*!
+   Return the write epoch of the last modification of a field.
+   */
+
+  size_t field_write_epoch(field_id_t fid) const {
+    auto it = field_write_epochs_.find(fid);
+    return it == field_write_epochs_.end() ? 0 : it->second;
+  } // field_write_epoch
+
+  /*!
+   Return the write epoch of the last modification of any field.
+   */
+
+  size_t write_epoch() const {
+    return write_epoch_;
+  } // write_epoch
+
+  /*!
+   Return the generation of the field data, ghost-copy metadata and
+   coloring information. It changes whenever field data or metadata is
+   registered or replaced, e.g., by a rebalance, so that pointers into
+   them that are kept across task launches can be checked.
+   */
+
+  size_t metadata_generation() const {
+    return metadata_generation_;
+  } // metadata_generation
+
+  /*!
+   Record that the ghost-copy metadata or coloring information has been
+   replaced.
+   */
+
+  void invalidate_metadata() {
+    ++metadata_generation_;
+  } // invalidate_metadata
+
   std::map<size_t, MPI_Datatype> & reduction_types() {
     return reduction_types_;
   } // reduction_types
@@ -581,7 +641,7 @@ struct mpi_context_policy_t {
   //    task_info_t
   //  > task_registry_;
 
-  std::map<field_id_t, std::vector<uint8_t>> field_data;
+  std::map<field_id_t, field_storage_t> field_data;
   std::map<field_id_t, field_metadata_t> field_metadata;
 
   std::map<size_t, index_space_data_t> index_space_data_map_;
@@ -593,6 +653,10 @@ struct mpi_context_policy_t {
   std::map<size_t, MPI_Datatype> reduction_types_;
   std::map<size_t, MPI_Op> reduction_ops_;
 
+  size_t write_epoch_ = 0;
+  std::map<field_id_t, size_t> field_write_epochs_;
+  size_t metadata_generation_ = 0;
+
 }; // class mpi_context_policy_t
 
 } // namespace execution
@@ -15,23 +15,24 @@
 
 /*! @file */
 
+#include <array>
 #include <cinchlog.h>
 #include <functional>
 #include <future>
 #include <memory>
+#include <tuple>
 #include <type_traits>
 
+#include <flecsi/execution/common/instrumentation.h>
 #include <flecsi/execution/common/processor.h>
 #include <flecsi/execution/context.h>
 #include <flecsi/execution/mpi/finalize_handles.h>
 #include <flecsi/execution/mpi/future.h>
 #include <flecsi/execution/mpi/reduction_wrapper.h>
 #include <flecsi/execution/mpi/task_epilog.h>
+#include <flecsi/execution/mpi/task_graph.h>
 #include <flecsi/execution/mpi/task_prolog.h>
-
-#if defined(ENABLE_CALIPER)
-#include <caliper/Annotation.h>
-#endif
+#include <flecsi/execution/mpi/task_scheduler.h>
 
 namespace flecsi {
 namespace execution {
@@ -77,6 +78,74 @@ struct executor_u<void, ARG_TUPLE> {
   } // execute_task
 }; // struct executor_u
 
+/*!
+  The launch_passthrough_u type identifies task arguments that none of
+  the handle walkers (task_prolog_t, task_epilog_t and finalize_handles_t)
+  act on: values, and read-only dense and global accessors.
+ */
+
+template<typename T>
+struct launch_passthrough_u
+  : std::bool_constant<
+      !std::is_base_of<data::data_reference_base_t, T>::value> {};
+
+template<typename... TS>
+struct launch_passthrough_u<std::tuple<TS...>> : std::false_type {};
+
+template<typename T, std::size_t N>
+struct launch_passthrough_u<std::array<T, N>> : std::false_type {};
+
+template<typename T, size_t GHOST_PERMISSIONS>
+struct launch_passthrough_u<
+  dense_accessor_u<T, size_t(ro), size_t(ro), GHOST_PERMISSIONS>>
+  : std::true_type {};
+
+template<typename T>
+struct launch_passthrough_u<global_accessor_u<T, size_t(ro)>>
+  : std::true_type {};
+
+/*!
+  Whether all arguments of a task are passed through, so that its launch
+  skips the handle walkers.
+ */
+
+template<typename ARG_TUPLE>
+struct launch_passthrough_tuple_u;
+
+template<typename... ARGS>
+struct launch_passthrough_tuple_u<std::tuple<ARGS...>>
+  : std::conjunction<launch_passthrough_u<std::decay_t<ARGS>>...> {};
+
+/*!
+  The launch_async_u type identifies task arguments whose accesses the
+  task scheduler tracks: dense accessors, in addition to the arguments
+  that are passed through.
+ */
+
+template<typename T>
+struct launch_async_u : launch_passthrough_u<T> {};
+
+template<typename T,
+  size_t EXCLUSIVE_PERMISSIONS,
+  size_t SHARED_PERMISSIONS,
+  size_t GHOST_PERMISSIONS>
+struct launch_async_u<dense_accessor_u<T,
+  EXCLUSIVE_PERMISSIONS,
+  SHARED_PERMISSIONS,
+  GHOST_PERMISSIONS>> : std::true_type {};
+
+/*!
+  Whether a task can be executed asynchronously, which requires that all
+  of its arguments can.
+ */
+
+template<typename ARG_TUPLE>
+struct launch_async_tuple_u;
+
+template<typename... ARGS>
+struct launch_async_tuple_u<std::tuple<ARGS...>>
+  : std::conjunction<launch_async_u<std::decay_t<ARGS>>...> {};
+
 //----------------------------------------------------------------------------//
 // Execution policy.
 //----------------------------------------------------------------------------//
@@ -130,13 +199,11 @@ struct mpi_execution_policy_t {
     RETURN (*DELEGATE)(ARG_TUPLE)>
   static bool
   register_task(processor_type_t processor, launch_t launch, std::string name) {
-#if defined(ENABLE_CALIPER)
-    return context_t::instance()
-      .template register_function<TASK, RETURN, ARG_TUPLE, DELEGATE>(name);
-#else
+    task_processor_type_<TASK> = processor;
+    task_function_<TASK> = reinterpret_cast<void *>(DELEGATE);
+    instrument_task_name(TASK, name);
     return context_t::instance()
       .template register_function<TASK, RETURN, ARG_TUPLE, DELEGATE>();
-#endif
   } // register_task
 
   /*!
@@ -154,38 +221,75 @@ struct mpi_execution_policy_t {
 
     context_t & context_ = context_t::instance();
 
-    auto function = context_.function(TASK);
+    // The function pointer is resolved at registration.
+    void * function = task_function_<TASK>;
 
     // Make a tuple from the task arguments.
     ARG_TUPLE task_args = std::make_tuple(std::forward<ARGS>(args)...);
 
+    instrument_task_launch(TASK);
+
+    // The handle walkers are skipped for tasks with only read-only dense
+    // and global handles.
+    constexpr bool walk = !launch_passthrough_tuple_u<ARG_TUPLE>::value;
+
+    // In a recorded or replayed trace, the ghost updates of the tracked
+    // tasks are those of the task graph.
+    mpi_task_graph_t::task_ptr_t traced;
+    if(mpi_task_graph_t::instance().active()) {
+      traced = trace_task<TASK>(task_args);
+    } // if
+
     // run task_prolog to copy ghost cells.
-    task_prolog_t task_prolog;
-    task_prolog.walk(task_args);
-
-#if defined(ENABLE_CALIPER)
-    cali::Annotation ep("FleCSI-Execution");
-    auto tname = context_.function_name(TASK);
-    std::string atag = "execute_task->user->" + tname;
-    ep.begin(atag.c_str());
-#endif
-    auto future = executor_u<RETURN, ARG_TUPLE>::execute(function, task_args);
-#if defined(ENABLE_CALIPER)
-    ep.end();
-#endif
-
-    task_epilog_t task_epilog;
-    task_epilog.walk(task_args);
-
-#if defined(ENABLE_CALIPER)
-    atag = "execute_task->finalize-handles->" + tname;
-    ep.begin(atag.c_str());
-#endif
-    finalize_handles_t finalize_handles;
-    finalize_handles.walk(task_args);
-#if defined(ENABLE_CALIPER)
-    ep.end();
-#endif
+    if constexpr(walk) {
+      if(!traced) {
+        task_phase_timer_t timer(TASK, task_phase_t::prolog);
+        task_prolog_t task_prolog;
+        task_prolog.walk(task_args);
+      } // if
+    } // if
+
+    // With asynchronous execution, tasks without a return value whose
+    // arguments the scheduler can track are submitted to it. All other
+    // tasks wait for the submitted ones.
+    auto & scheduler = mpi_task_scheduler_t::instance();
+
+    if(scheduler.threads() > 0) {
+      if constexpr(std::is_void_v<RETURN> &&
+                   launch_async_tuple_u<ARG_TUPLE>::value) {
+        if(task_processor_type_<TASK> != processor_type_t::mpi) {
+          return submit_task<TASK, walk>(
+            function, std::move(task_args), std::move(traced));
+        } // if
+      } // if
+
+      scheduler.fence();
+    } // if
+
+    // The kernels of omp tasks run on the OpenMP thread team of the rank.
+    auto future = [&]() {
+      task_phase_timer_t timer(TASK, task_phase_t::user);
+      task_processor_guard_t processor_guard(task_processor_type_<TASK>);
+      return executor_u<RETURN, ARG_TUPLE>::execute(function, task_args);
+    }();
+
+    if(traced) {
+      task_phase_timer_t timer(TASK, task_phase_t::epilog);
+      traced->epilog();
+    }
+    else if constexpr(walk) {
+      task_phase_timer_t timer(TASK, task_phase_t::epilog);
+      task_epilog_t task_epilog(task_epilog_cache_<TASK>);
+      task_epilog.walk(task_args);
+    } // if
+
+    if constexpr(walk) {
+      if(!traced) {
+        task_phase_timer_t timer(TASK, task_phase_t::finalize);
+        finalize_handles_t finalize_handles;
+        finalize_handles.walk(task_args);
+      } // if
+    } // if
 
     constexpr size_t ZERO =
       flecsi::utils::const_string_t{EXPAND_AND_STRINGIFY(0)}.hash();
@@ -216,8 +320,11 @@ struct mpi_execution_policy_t {
       const RETURN sendbuf = future.get();
       RETURN recvbuf;
 
-      MPI_Allreduce(
-        &sendbuf, &recvbuf, 1, datatype, reduction_op->second, MPI_COMM_WORLD);
+      {
+        reduction_timer_t timer(TASK);
+        MPI_Allreduce(&sendbuf, &recvbuf, 1, datatype, reduction_op->second,
+          MPI_COMM_WORLD);
+      } // scope
 
       mpi_future_u<RETURN> gfuture;
       gfuture.set(recvbuf);
@@ -228,6 +335,60 @@ struct mpi_execution_policy_t {
     } // if
   } // execute_task
 
+  //--------------------------------------------------------------------------//
+  // Asynchronous interface.
+  //--------------------------------------------------------------------------//
+
+  /*!
+    Execute the tasks that have no return value, and whose arguments are
+    values, dense accessors and read-only global accessors, on a pool of
+    the given number of threads. Their dependences are derived from the
+    privileges of their dense accessors, so that independent tasks run
+    concurrently while the results are those of sequential execution.
+    Zero, the default, executes all tasks synchronously.
+   */
+
+  static void set_async_threads(size_t threads) {
+    mpi_task_scheduler_t::instance().set_threads(threads);
+  } // set_async_threads
+
+  /*!
+    Wait for all asynchronously executed tasks, e.g., before the field
+    data are accessed outside of tasks.
+   */
+
+  static void fence() {
+    mpi_task_scheduler_t::instance().fence();
+  } // fence
+
+  //--------------------------------------------------------------------------//
+  // Trace interface.
+  //--------------------------------------------------------------------------//
+
+  /*!
+    MPI backend trace. The tasks of the first execution of a trace are
+    recorded into a task graph, with the ghost schedules of the fields
+    they write, which the following executions replay. Please see
+    mpi_task_graph_t.
+   */
+
+  static void begin_trace(size_t trace) {
+    mpi_task_graph_t::instance().begin(trace);
+  } // begin_trace
+
+  static void end_trace(size_t) {
+    mpi_task_graph_t::instance().end();
+  } // end_trace
+
+  /*!
+    MPI backend trace invalidation. The recorded task graphs are
+    discarded.
+   */
+
+  static void invalidate_traces() {
+    mpi_task_graph_t::instance().invalidate();
+  } // invalidate_traces
+
   //--------------------------------------------------------------------------//
   // Reduction interface.
   //--------------------------------------------------------------------------//
@@ -274,6 +435,97 @@ struct mpi_execution_policy_t {
       std::forward_as_tuple(args...));
   } // execute_function
 
+private:
+  /*!
+    Record or replay the launch of a task in the trace in progress.
+
+    @return The recorded launch, or null if the task is not tracked or
+            does not match the recording.
+   */
+
+  template<size_t TASK, typename ARG_TUPLE>
+  static mpi_task_graph_t::task_ptr_t trace_task(ARG_TUPLE & task_args) {
+    auto & graph = mpi_task_graph_t::instance();
+
+    if constexpr(launch_async_tuple_u<ARG_TUPLE>::value) {
+      task_accesses_t accesses;
+      accesses.walk(task_args);
+
+      return graph.launch(TASK, std::move(accesses.accesses), [&]() {
+        ghost_schedules_t schedules;
+        schedules.walk(task_args);
+        return std::move(schedules.schedules);
+      });
+    }
+    else {
+      graph.launch(TASK);
+      return nullptr;
+    } // if
+  } // trace_task
+
+  /*!
+    Submit a task to the scheduler. The arguments are shared by its body,
+    which runs on the thread pool, and its epilog, which updates the
+    ghosts of the written fields on the launching thread.
+   */
+
+  template<size_t TASK, bool WALK, typename ARG_TUPLE>
+  static mpi_future_u<void> submit_task(void * function,
+    ARG_TUPLE && task_args,
+    mpi_task_graph_t::task_ptr_t traced) {
+    task_accesses_t accesses;
+    if(traced) {
+      accesses.accesses = traced->accesses;
+    }
+    else {
+      accesses.walk(task_args);
+    } // if
+
+    auto args = std::make_shared<ARG_TUPLE>(std::move(task_args));
+
+    auto body = [function, args]() {
+      task_phase_timer_t timer(TASK, task_phase_t::user);
+      task_processor_guard_t processor_guard(task_processor_type_<TASK>);
+      executor_u<void, ARG_TUPLE>::execute(function, *args);
+    };
+
+    std::function<void()> epilog;
+    if(traced) {
+      if(!traced->schedules.empty()) {
+        epilog = [traced]() {
+          task_phase_timer_t timer(TASK, task_phase_t::epilog);
+          traced->epilog();
+        };
+      } // if
+    }
+    else if constexpr(WALK) {
+      epilog = [args]() {
+        task_phase_timer_t timer(TASK, task_phase_t::epilog);
+        task_epilog_t task_epilog(task_epilog_cache_<TASK>);
+        task_epilog.walk(*args);
+      };
+    } // if
+
+    auto & scheduler = mpi_task_scheduler_t::instance();
+    auto node = scheduler.submit(accesses.accesses, body, epilog);
+
+    mpi_future_u<void> future;
+    future.wait_ = [node]() { mpi_task_scheduler_t::instance().wait(node); };
+    return future;
+  } // submit_task
+
+  // The processor type of each task.
+  template<size_t TASK>
+  static inline processor_type_t task_processor_type_ = processor_type_t::loc;
+
+  // The function of each task.
+  template<size_t TASK>
+  static inline void * task_function_ = nullptr;
+
+  // The field metadata of the writable dense handles of each task.
+  template<size_t TASK>
+  static inline task_epilog_cache_t task_epilog_cache_;
+
 }; // struct mpi_execution_policy_t
 
 } // namespace execution
@@ -0,0 +1,77 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+
+/*! @file */
+
+#include <flecsi/execution/kernel.h>
+#include <flecsi/execution/mpi/field_allocator.h>
+
+// The system headers define macros, e.g., MAP_TYPE, that clash with the
+// names of the template parameters of the topology, and are therefore
+// included last.
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace flecsi {
+namespace execution {
+
+//----------------------------------------------------------------------------//
+// Implementation of field_page_size.
+//----------------------------------------------------------------------------//
+
+size_t
+field_page_size() {
+  static const size_t size = size_t(sysconf(_SC_PAGESIZE));
+  return size;
+} // field_page_size
+
+//----------------------------------------------------------------------------//
+// Implementation of place_field_data.
+//----------------------------------------------------------------------------//
+
+void
+place_field_data(char * data,
+  size_t bytes,
+  const data::placement_t & placement) {
+#if defined(MADV_HUGEPAGE)
+  if(placement.huge_pages) {
+    madvise(data, bytes, MADV_HUGEPAGE);
+  } // if
+#endif
+
+  if(!placement.first_touch) {
+    return;
+  } // if
+
+  // Touch one byte per page, with the static partition of the kernels,
+  // so that each page is placed in the NUMA domain of its thread.
+  const size_t page = field_page_size();
+  const size_t pages = bytes / page;
+
+#if defined(FLECSI_ENABLE_OPENMP)
+#pragma omp parallel for schedule(static)
+  for(size_t p = 0; p < pages; ++p) {
+    data[p * page] = 0;
+  } // for
+#else
+  detail::for_each_block(0, pages, [&](size_t begin, size_t end) {
+    for(size_t p = begin; p < end; ++p) {
+      data[p * page] = 0;
+    } // for
+  });
+#endif
+} // place_field_data
+
+} // namespace execution
+} // namespace flecsi
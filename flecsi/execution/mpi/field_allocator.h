@@ -0,0 +1,129 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <flecsi/data/common/placement.h>
+
+namespace flecsi {
+namespace execution {
+
+/*!
+  The alignment of field data with huge pages.
+
+  @ingroup mpi-execution
+ */
+
+constexpr size_t field_huge_page_size = size_t(2) << 20;
+
+/*!
+  Return the size of the memory pages, to which field data are aligned.
+
+  @ingroup mpi-execution
+ */
+
+size_t field_page_size();
+
+/*!
+  Place newly allocated field data: request huge pages, and touch the
+  pages first with the kernel threads, according to the placement.
+
+  @ingroup mpi-execution
+ */
+
+void place_field_data(char * data,
+  size_t bytes,
+  const data::placement_t & placement);
+
+/*!
+  The field_allocator_u type allocates field data aligned to memory
+  pages, and places them according to the placement of the field. The
+  containers value-initialize the data after the pages have been placed.
+
+  @ingroup mpi-execution
+ */
+
+template<typename T>
+struct field_allocator_u {
+
+  using value_type = T;
+
+  // All instances free the memory in the same way.
+  using is_always_equal = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  field_allocator_u() = default;
+
+  explicit field_allocator_u(const data::placement_t & placement)
+    : placement(placement) {}
+
+  template<typename U>
+  field_allocator_u(const field_allocator_u<U> & allocator)
+    : placement(allocator.placement) {}
+
+  T * allocate(size_t n) {
+    const size_t alignment =
+      placement.huge_pages ? field_huge_page_size : field_page_size();
+    const size_t bytes =
+      std::max((n * sizeof(T) + alignment - 1) / alignment, size_t(1)) *
+      alignment;
+
+    void * data = std::aligned_alloc(alignment, bytes);
+    if(data == nullptr) {
+      throw std::bad_alloc();
+    } // if
+
+    place_field_data(static_cast<char *>(data), bytes, placement);
+
+    return static_cast<T *>(data);
+  } // allocate
+
+  void deallocate(T * data, size_t) noexcept {
+    std::free(data);
+  } // deallocate
+
+  data::placement_t placement;
+
+}; // struct field_allocator_u
+
+template<typename T, typename U>
+bool
+operator==(const field_allocator_u<T> &, const field_allocator_u<U> &) {
+  return true;
+} // operator ==
+
+template<typename T, typename U>
+bool
+operator!=(const field_allocator_u<T> &, const field_allocator_u<U> &) {
+  return false;
+} // operator !=
+
+/*!
+  The storage of the data of a dense field.
+
+  @ingroup mpi-execution
+ */
+
+using field_storage_t = std::vector<uint8_t, field_allocator_u<uint8_t>>;
+
+} // namespace execution
+} // namespace flecsi
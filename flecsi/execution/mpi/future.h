@@ -73,9 +73,17 @@ struct mpi_future_u {
 template<launch_type_t launch>
 struct mpi_future_u<void, launch> {
   /*!
-   FIXME documentation
+   Wait for the task, if it is executed asynchronously.
    */
-  void wait() {}
+  void wait() {
+    if(wait_) {
+      wait_();
+    } // if
+  } // wait
+
+  // private:
+
+  std::function<void()> wait_;
 
 }; // struct mpi_future_u
 
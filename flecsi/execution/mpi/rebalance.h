@@ -0,0 +1,665 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <cinchlog.h>
+#include <flecsi-config.h>
+
+#if !defined(FLECSI_ENABLE_MPI)
+#error FLECSI_ENABLE_MPI not defined! This file depends on MPI!
+#endif
+
+#include <mpi.h>
+
+#include <flecsi/coloring/colorer.h>
+#include <flecsi/coloring/crs.h>
+#include <flecsi/coloring/dcrs_utils.h>
+#include <flecsi/coloring/mpi_communicator.h>
+#include <flecsi/data/data_constants.h>
+#include <flecsi/execution/context.h>
+#include <flecsi/execution/mpi/task_graph.h>
+#include <flecsi/execution/mpi/task_scheduler.h>
+#include <flecsi/execution/remap_shared.h>
+#include <flecsi/topology/parallel_mesh_definition.h>
+#include <flecsi/utils/mpi_type_traits.h>
+
+clog_register_tag(rebalance);
+
+namespace flecsi {
+namespace execution {
+
+namespace rebalance_detail {
+
+using byte_t = unsigned char;
+using byte_buffer_t = std::vector<byte_t>;
+
+using coloring::exchange;
+
+/*!
+  The field values of a list of entities, stored field by field. Dense
+  values are stored contiguously; ragged rows are stored in their serialized
+  form with CRS-style offsets. In packed buffers, each serialized row is
+  preceded by its size in bytes.
+ */
+
+struct entity_values_t {
+  std::vector<byte_buffer_t> dense;
+  std::vector<byte_buffer_t> ragged;
+  std::vector<std::vector<size_t>> ragged_offsets;
+}; // struct entity_values_t
+
+/*!
+  Return the graph of the owned entities of an index space as a dcrs, in
+  which the entities of each rank are numbered contiguously in local
+  order. The global ids of the neighbors are translated through a
+  distributed directory.
+
+  @param index_space  The index space.
+  @param connectivity The neighbors of each local owned entity as global
+                      ids.
+ */
+
+inline coloring::dcrs_t
+owned_graph(size_t index_space, const coloring::crs_t & connectivity) {
+  auto & context_ = context_t::instance();
+
+  int comm_size, comm_rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &comm_rank);
+
+  const auto mpi_size_t = utils::mpi_typetraits_u<size_t>::type();
+  auto & index_map = context_.index_map(index_space);
+  const size_t num_owned = connectivity.size();
+
+  coloring::dcrs_t dcrs;
+  dcrs.distribution.resize(comm_size + 1, 0);
+  MPI_Allgather(&num_owned, 1, mpi_size_t, &dcrs.distribution[1], 1,
+    mpi_size_t, MPI_COMM_WORLD);
+
+  for(size_t r = 0; r < comm_size; ++r)
+    dcrs.distribution[r + 1] += dcrs.distribution[r];
+
+  const size_t start = dcrs.distribution[comm_rank];
+
+  // Register the graph vertex of each owned entity with the home rank of
+  // its id, id % comm_size, and look up the vertices of the off-rank
+  // neighbors there.
+  std::unordered_map<size_t, size_t> vertices;
+  std::vector<std::vector<size_t>> registrations(comm_size);
+  for(size_t local = 0; local < num_owned; ++local) {
+    const size_t id = index_map.at(local);
+    vertices[id] = start + local;
+    registrations[id % comm_size].push_back(id);
+    registrations[id % comm_size].push_back(start + local);
+  } // for
+
+  std::vector<size_t> remote;
+  for(auto id : connectivity.indices)
+    if(vertices.find(id) == vertices.end())
+      remote.push_back(id);
+
+  std::sort(remote.begin(), remote.end());
+  remote.erase(std::unique(remote.begin(), remote.end()), remote.end());
+
+  std::vector<std::vector<size_t>> requests(comm_size);
+  for(auto id : remote)
+    requests[id % comm_size].push_back(id);
+
+  auto registered = coloring::exchange(registrations);
+  auto requested = coloring::exchange(requests);
+
+  std::unordered_map<size_t, size_t> directory;
+  for(size_t r = 0; r < comm_size; ++r)
+    for(size_t i = 0; i < registered[r].size(); i += 2)
+      directory[registered[r][i]] = registered[r][i + 1];
+
+  std::vector<std::vector<size_t>> answers(comm_size);
+  for(size_t r = 0; r < comm_size; ++r) {
+    for(auto id : requested[r]) {
+      auto it = directory.find(id);
+      clog_assert(it != directory.end(), "no owner for entity " << id);
+      answers[r].push_back(it->second);
+    } // for
+  } // for
+
+  auto answered = coloring::exchange(answers);
+
+  for(size_t r = 0; r < comm_size; ++r)
+    for(size_t i = 0; i < requests[r].size(); ++i)
+      vertices[requests[r][i]] = answered[r][i];
+
+  dcrs.offsets.push_back(0);
+  for(size_t local = 0; local < num_owned; ++local) {
+    for(auto id : connectivity[local])
+      dcrs.indices.push_back(vertices.at(id));
+    dcrs.offsets.push_back(dcrs.indices.size());
+  } // for
+
+  return dcrs;
+} // owned_graph
+
+} // namespace rebalance_detail
+
+/*!
+  Repartition the entities of an index space during a run and migrate
+  the field data that lives on it to the new owners.
+
+  Every rank passes the new owner of each of its owned (exclusive and
+  shared) entities in local order, together with the connectivity of
+  those entities as global entity ids. Entities are moved to their new
+  owners along with the values of all dense and ragged fields that have
+  been allocated on the index space and with their connectivity. The
+  new exclusive/shared/ghost coloring is derived from the migrated
+  connectivity, i.e., an entity is a ghost of a color if it is adjacent
+  to one of the entities owned by that color. Ghost values are filled
+  from the new owners, and the coloring, coloring information, index
+  maps and MPI ghost-copy metadata in the context are rebuilt so that
+  subsequent tasks see the new distribution.
+
+  This must be called collectively by all ranks outside of a task, and
+  waits for the pending asynchronous tasks first. Mesh topology storage
+  built from the old coloring is not migrated and must be reinitialized
+  by the specialization, e.g., from the returned connectivity.
+
+  @param index_space  The index space to rebalance.
+  @param partitioning The new owner of each local owned entity, e.g., as
+                      returned by a colorer, see the overload below, or
+                      by coloring::weighted_partitioning, which needs no
+                      graph.
+  @param connectivity The neighbors of each local owned entity as global
+                      ids. On return, this holds the connectivity of the
+                      new owned entities in their new local order.
+
+  @ingroup mpi-execution
+ */
+
+inline void
+rebalance(size_t index_space,
+  const std::vector<size_t> & partitioning,
+  coloring::crs_t & connectivity) {
+  using namespace rebalance_detail;
+  using entity_info_t = coloring::entity_info_t;
+  using field_info_t = context_t::field_info_t;
+
+  // The asynchronous tasks still use the storage and the ghost-copy
+  // windows that are replaced below.
+  mpi_task_scheduler_t::instance().fence();
+
+  auto & context_ = context_t::instance();
+
+  int comm_size, comm_rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &comm_rank);
+
+  const auto & color_info = context_.coloring_info(index_space).at(comm_rank);
+  const size_t num_owned = color_info.exclusive + color_info.shared;
+
+  clog_assert(partitioning.size() == num_owned,
+    "partitioning does not match the number of owned entities");
+  clog_assert(connectivity.size() == num_owned,
+    "connectivity does not match the number of owned entities");
+
+  auto & index_map = context_.index_map(index_space);
+  auto & field_data = context_.registered_field_data();
+  auto & sparse_field_data = context_.registered_sparse_field_data();
+
+  //--------------------------------------------------------------------------//
+  // Collect the fields that have storage on this index space. The
+  // registered fields are in the same order on every rank.
+  //--------------------------------------------------------------------------//
+
+  std::vector<const field_info_t *> dense_fields;
+  std::vector<const field_info_t *> ragged_fields;
+
+  for(auto & fi : context_.registered_fields()) {
+    if(fi.index_space != index_space)
+      continue;
+
+    if(fi.storage_class == data::dense &&
+       field_data.find(fi.fid) != field_data.end()) {
+      dense_fields.push_back(&fi);
+    }
+    else if((fi.storage_class == data::ragged ||
+              fi.storage_class == data::sparse) &&
+            sparse_field_data.find(fi.fid) != sparse_field_data.end()) {
+      ragged_fields.push_back(&fi);
+    } // if
+  } // for
+
+  const size_t row_size = sizeof(data::row_vector_u<byte_t>);
+
+  // Append the values of a local entity to a buffer.
+  auto pack_values = [&](size_t local, byte_buffer_t & buf) {
+    for(auto fi : dense_fields) {
+      auto data = field_data[fi->fid].data() + local * fi->size;
+      buf.insert(buf.end(), data, data + fi->size);
+    } // for
+
+    for(auto fi : ragged_fields) {
+      auto serdez = context_.get_serdez(fi->fid);
+      auto row = &sparse_field_data[fi->fid].rows[local * row_size];
+      const size_t bytes = serdez->serialized_size(row);
+      topology::cast_insert(&bytes, 1, buf);
+      const size_t start = buf.size();
+      buf.resize(start + bytes);
+      serdez->serialize(row, &buf[start]);
+    } // for
+  }; // pack_values
+
+  // Append the values of an entity from a buffer to a value store.
+  auto unpack_values = [&](const byte_t *& buf, entity_values_t & values) {
+    for(size_t f = 0; f < dense_fields.size(); ++f) {
+      auto size = dense_fields[f]->size;
+      values.dense[f].insert(values.dense[f].end(), buf, buf + size);
+      buf += size;
+    } // for
+
+    for(size_t f = 0; f < ragged_fields.size(); ++f) {
+      size_t bytes;
+      topology::uncast(buf, 1, &bytes);
+      values.ragged[f].insert(values.ragged[f].end(), buf, buf + bytes);
+      values.ragged_offsets[f].push_back(values.ragged[f].size());
+      buf += bytes;
+    } // for
+  }; // unpack_values
+
+  auto init_values = [&](entity_values_t & values) {
+    values.dense.resize(dense_fields.size());
+    values.ragged.resize(ragged_fields.size());
+    values.ragged_offsets.assign(ragged_fields.size(), {0});
+  }; // init_values
+
+  //--------------------------------------------------------------------------//
+  // Migrate owned entities with their connectivity and field values.
+  //--------------------------------------------------------------------------//
+
+  std::vector<size_t> owned_ids;
+  coloring::crs_t owned_connectivity;
+  entity_values_t owned_values;
+  init_values(owned_values);
+
+  std::vector<byte_buffer_t> sendbufs(comm_size);
+
+  for(size_t local = 0; local < num_owned; ++local) {
+    const size_t id = index_map.at(local);
+    auto neighbors = connectivity[local];
+
+    if(partitioning[local] == comm_rank) {
+      // Keep it, staging the values through the same packed format.
+      byte_buffer_t buf;
+      pack_values(local, buf);
+      const byte_t * p = buf.data();
+      unpack_values(p, owned_values);
+
+      owned_ids.push_back(id);
+      owned_connectivity.append(neighbors.begin(), neighbors.end());
+    }
+    else {
+      auto & buf = sendbufs[partitioning[local]];
+      const size_t num_neighbors = neighbors.size();
+      topology::cast_insert(&id, 1, buf);
+      topology::cast_insert(&num_neighbors, 1, buf);
+      topology::cast_insert(neighbors.begin(), num_neighbors, buf);
+      pack_values(local, buf);
+    } // if
+  } // for
+
+  auto recvbufs = exchange(sendbufs);
+
+  for(size_t r = 0; r < comm_size; ++r) {
+    const byte_t * p = recvbufs[r].data();
+    const byte_t * end = p + recvbufs[r].size();
+
+    while(p < end) {
+      size_t id, num_neighbors;
+      topology::uncast(p, 1, &id);
+      topology::uncast(p, 1, &num_neighbors);
+
+      std::vector<size_t> neighbors(num_neighbors);
+      topology::uncast(p, num_neighbors, neighbors.data());
+
+      owned_ids.push_back(id);
+      owned_connectivity.append(neighbors.begin(), neighbors.end());
+      unpack_values(p, owned_values);
+    } // while
+
+    clog_assert(p == end, "Unpacking mismatch");
+  } // for
+
+  clog_assert(owned_ids.size() > 0,
+    "At least one rank has no entities after rebalancing. Please either "
+    "increase the problem size or use fewer ranks");
+
+  {
+    clog_tag_guard(rebalance);
+    clog(info) << "rank " << comm_rank << " owns " << owned_ids.size()
+               << " entities after rebalancing (was " << num_owned << ")"
+               << std::endl;
+  } // guard
+
+  //--------------------------------------------------------------------------//
+  // Find the owners of our off-rank neighbors through a distributed
+  // directory. Entity id % comm_size is the home rank of an entity.
+  //--------------------------------------------------------------------------//
+
+  std::unordered_set<size_t> owned_set(owned_ids.begin(), owned_ids.end());
+
+  std::vector<std::vector<size_t>> registrations(comm_size);
+  for(auto id : owned_ids)
+    registrations[id % comm_size].push_back(id);
+
+  auto registered = exchange(registrations);
+
+  std::unordered_map<size_t, size_t> directory;
+  for(size_t r = 0; r < comm_size; ++r)
+    for(auto id : registered[r])
+      directory[id] = r;
+
+  std::vector<std::set<size_t>> ghost_requests(comm_size);
+  for(auto id : owned_connectivity.indices)
+    if(owned_set.find(id) == owned_set.end())
+      ghost_requests[id % comm_size].insert(id);
+
+  std::vector<std::vector<size_t>> requests(comm_size);
+  for(size_t r = 0; r < comm_size; ++r)
+    requests[r].assign(ghost_requests[r].begin(), ghost_requests[r].end());
+
+  auto requested = exchange(requests);
+
+  // Answer with the owners, and tell the owners who needs their entities.
+  std::vector<std::vector<size_t>> answers(comm_size);
+  std::vector<std::vector<size_t>> notices(comm_size);
+
+  for(size_t r = 0; r < comm_size; ++r) {
+    for(auto id : requested[r]) {
+      auto it = directory.find(id);
+      clog_assert(it != directory.end(), "no owner for entity " << id);
+      answers[r].push_back(it->second);
+      notices[it->second].push_back(id);
+      notices[it->second].push_back(r);
+    } // for
+  } // for
+
+  auto owners = exchange(answers);
+  auto noticed = exchange(notices);
+
+  //--------------------------------------------------------------------------//
+  // Build the new coloring.
+  //--------------------------------------------------------------------------//
+
+  std::unordered_map<size_t, std::set<size_t>> sharers;
+  for(size_t r = 0; r < comm_size; ++r)
+    for(size_t i = 0; i < noticed[r].size(); i += 2)
+      sharers[noticed[r][i]].insert(noticed[r][i + 1]);
+
+  coloring::index_coloring_t new_coloring;
+  coloring::coloring_info_t new_color_info;
+
+  new_coloring.primary.insert(owned_ids.begin(), owned_ids.end());
+
+  // The entities are collected first and inserted at once, because the
+  // sets are sorted vectors and the ids do not arrive in order.
+  std::vector<entity_info_t> exclusive, shared, ghost;
+
+  for(auto id : owned_ids) {
+    auto it = sharers.find(id);
+    if(it == sharers.end()) {
+      exclusive.emplace_back(id, comm_rank);
+    }
+    else {
+      shared.emplace_back(id, comm_rank, 0, it->second);
+      new_color_info.shared_users.insert(
+        it->second.begin(), it->second.end());
+    } // if
+  } // for
+
+  for(size_t r = 0; r < comm_size; ++r) {
+    for(size_t i = 0; i < requests[r].size(); ++i) {
+      const size_t owner = owners[r][i];
+      ghost.emplace_back(requests[r][i], owner);
+      new_color_info.ghost_owners.insert(owner);
+    } // for
+  } // for
+
+  new_coloring.exclusive.insert(exclusive.begin(), exclusive.end());
+  new_coloring.shared.insert(shared.begin(), shared.end());
+  new_coloring.ghost.insert(ghost.begin(), ghost.end());
+
+  new_color_info.exclusive = new_coloring.exclusive.size();
+  new_color_info.shared = new_coloring.shared.size();
+  new_color_info.ghost = new_coloring.ghost.size();
+
+  // The local storage order is exclusive, shared, ghost, each sorted by id.
+  std::map<size_t, size_t> new_index_map;
+  std::unordered_map<size_t, size_t> new_offsets;
+  {
+    size_t counter(0);
+
+    // The offsets do not change the order of the entities.
+    std::vector<entity_info_t> exclusive;
+    exclusive.reserve(new_coloring.exclusive.size());
+    for(auto e : new_coloring.exclusive) {
+      exclusive.emplace_back(e.id, e.rank, counter, e.shared);
+      new_offsets[e.id] = counter;
+      new_index_map[counter++] = e.id;
+    } // for
+    new_coloring.exclusive =
+      utils::flat_set_u<entity_info_t>(utils::sorted_unique, exclusive);
+
+    for(auto & e : new_coloring.shared) {
+      new_offsets[e.id] = counter;
+      new_index_map[counter++] = e.id;
+    } // for
+
+    for(auto & e : new_coloring.ghost) {
+      new_offsets[e.id] = counter;
+      new_index_map[counter++] = e.id;
+    } // for
+  } // scope
+
+  const size_t num_total = new_index_map.size();
+
+  //--------------------------------------------------------------------------//
+  // Release the MPI resources of the old ghost-copy metadata. The windows
+  // reference the old field buffers, and freeing them is collective.
+  //--------------------------------------------------------------------------//
+
+  auto & field_metadata = context_.registered_field_metadata();
+  for(auto fi : dense_fields) {
+    auto it = field_metadata.find(fi->fid);
+    if(it == field_metadata.end())
+      continue;
+
+    auto & md = it->second;
+    MPI_Win_free(&md.win);
+    for(auto & t : md.origin_types)
+      MPI_Type_free(&t.second);
+    for(auto & t : md.target_types)
+      MPI_Type_free(&t.second);
+    MPI_Group_free(&md.shared_users_grp);
+    MPI_Group_free(&md.ghost_owners_grp);
+    field_metadata.erase(it);
+  } // for
+
+  auto & sparse_field_metadata = context_.registered_sparse_field_metadata();
+  for(auto fi : ragged_fields) {
+    auto it = sparse_field_metadata.find(fi->fid);
+    if(it == sparse_field_metadata.end())
+      continue;
+
+    MPI_Group_free(&it->second.shared_users_grp);
+    MPI_Group_free(&it->second.ghost_owners_grp);
+    sparse_field_metadata.erase(it);
+  } // for
+
+  //--------------------------------------------------------------------------//
+  // Lay out the owned values in the new storage.
+  //--------------------------------------------------------------------------//
+
+  std::vector<size_t> owned_order(owned_ids.size());
+  for(size_t i = 0; i < owned_ids.size(); ++i)
+    owned_order[i] = new_offsets.at(owned_ids[i]);
+
+  for(size_t f = 0; f < dense_fields.size(); ++f) {
+    auto size = dense_fields[f]->size;
+    auto & storage = field_data[dense_fields[f]->fid];
+    field_storage_t buffer(num_total * size, storage.get_allocator());
+
+    for(size_t i = 0; i < owned_ids.size(); ++i)
+      std::memcpy(&buffer[owned_order[i] * size],
+        &owned_values.dense[f][i * size], size);
+
+    storage.swap(buffer);
+    context_.mark_field_written(dense_fields[f]->fid);
+  } // for
+
+  for(size_t f = 0; f < ragged_fields.size(); ++f) {
+    auto fid = ragged_fields[f]->fid;
+    auto serdez = context_.get_serdez(fid);
+    auto & old_field = sparse_field_data[fid];
+
+    for(size_t i = 0; i < old_field.num_total; ++i)
+      serdez->destroy(&old_field.rows[i * row_size]);
+
+    context_t::sparse_field_data_t new_field(old_field.type_size,
+      new_color_info.exclusive, new_color_info.shared, new_color_info.ghost,
+      old_field.max_entries_per_index);
+
+    for(size_t i = 0; i < owned_ids.size(); ++i)
+      serdez->deserialize(&new_field.rows[owned_order[i] * row_size],
+        &owned_values.ragged[f][owned_values.ragged_offsets[f][i]]);
+
+    old_field = std::move(new_field);
+    context_.mark_field_written(fid);
+  } // for
+
+  //--------------------------------------------------------------------------//
+  // Fill the ghost values from their new owners. Both sides walk the
+  // entities in id order, so no ids need to be sent.
+  //--------------------------------------------------------------------------//
+
+  std::vector<byte_buffer_t> ghost_sendbufs(comm_size);
+  for(auto & e : new_coloring.shared)
+    for(auto peer : e.shared)
+      pack_values(new_offsets.at(e.id), ghost_sendbufs[peer]);
+
+  auto ghost_recvbufs = exchange(ghost_sendbufs);
+
+  {
+    std::vector<const byte_t *> cursors(comm_size);
+    for(size_t r = 0; r < comm_size; ++r)
+      cursors[r] = ghost_recvbufs[r].data();
+
+    for(auto & e : new_coloring.ghost) {
+      const size_t local = new_offsets.at(e.id);
+      auto & p = cursors[e.rank];
+
+      for(auto fi : dense_fields) {
+        std::memcpy(&field_data[fi->fid][local * fi->size], p, fi->size);
+        p += fi->size;
+      } // for
+
+      for(auto fi : ragged_fields) {
+        auto serdez = context_.get_serdez(fi->fid);
+        size_t bytes;
+        topology::uncast(p, 1, &bytes);
+        serdez->deserialize(
+          &sparse_field_data[fi->fid].rows[local * row_size], p);
+        p += bytes;
+      } // for
+    } // for
+  } // scope
+
+  //--------------------------------------------------------------------------//
+  // Update the context.
+  //--------------------------------------------------------------------------//
+
+  coloring::mpi_communicator_t communicator;
+  auto coloring_info = communicator.gather_coloring_info(new_color_info);
+
+  context_.coloring(index_space) = new_coloring;
+  context_.coloring_info_map()[index_space] = coloring_info;
+
+  // This fixes the shared and ghost offsets used by the ghost copies.
+  remap_shared_entities(index_space);
+
+  context_.reverse_index_map(index_space).clear();
+  context_.add_index_map(index_space, new_index_map);
+
+  // Return the connectivity in the new local order.
+  {
+    std::vector<size_t> order(owned_ids.size());
+    for(size_t i = 0; i < owned_ids.size(); ++i)
+      order[owned_order[i]] = i;
+
+    connectivity.clear();
+    for(auto i : order) {
+      auto neighbors = owned_connectivity[i];
+      connectivity.append(neighbors.begin(), neighbors.end());
+    } // for
+  } // scope
+
+  // The ghost-copy metadata is rebuilt lazily the next time a handle to
+  // one of the fields is requested. Cached pointers to the old metadata
+  // and coloring information are stale, and so are the ghost schedules
+  // of the recorded traces.
+  context_.invalidate_metadata();
+  mpi_task_graph_t::instance().invalidate();
+} // rebalance
+
+/*!
+  Rebalance an index space with a colorer, e.g., \ref
+  coloring::parmetis_colorer_t, so that each rank holds an equal share of
+  the given per-entity work. The graph of the owned entities is colored
+  with the work as vertex weights, and the entities are migrated as by
+  \ref rebalance above.
+
+  @param index_space  The index space to rebalance.
+  @param colorer      The colorer that computes the new owners.
+  @param weights      The work of each local owned entity.
+  @param connectivity The neighbors of each local owned entity as global
+                      ids. On return, this holds the connectivity of the
+                      new owned entities in their new local order.
+
+  @ingroup mpi-execution
+ */
+
+inline void
+rebalance(size_t index_space,
+  coloring::colorer_t & colorer,
+  const std::vector<size_t> & weights,
+  coloring::crs_t & connectivity) {
+  auto dcrs = rebalance_detail::owned_graph(index_space, connectivity);
+
+  clog_assert(weights.size() == dcrs.size(),
+    "weights do not match the number of owned entities");
+
+  dcrs.vertex_weights = weights;
+  dcrs.num_constraints = 1;
+
+  rebalance(index_space, colorer.new_color(dcrs), connectivity);
+} // rebalance
+
+} // namespace execution
+} // namespace flecsi
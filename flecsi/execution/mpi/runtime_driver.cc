@@ -15,8 +15,10 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <fstream>
 
 #include <flecsi/data/data.h>
+#include <flecsi/execution/mpi/task_scheduler.h>
 #include <flecsi/execution/remap_shared.h>
 
 clog_register_tag(runtime_driver);
@@ -92,6 +94,12 @@ runtime_driver(int argc, char ** argv) {
 
   remap_shared_entities();
 
+  // Write the coloring quality report if it was requested.
+  if(!context_.coloring_report().empty() && context_.color() == 0) {
+    std::ofstream report(context_.coloring_report());
+    flecsi::coloring::write_json(report, context_.coloring_quality());
+  } // if
+
   // Setup maps from mesh to compacted (local) index space and vice versa
   //
   // This depends on the ordering of the BLIS data structure setup.
@@ -123,6 +131,9 @@ runtime_driver(int argc, char ** argv) {
     context_.top_level_driver()(argc, argv);
   }
 
+  // Wait for the asynchronously executed tasks.
+  mpi_task_scheduler_t::instance().fence();
+
 #else
 
   context_.advance_state();
@@ -137,6 +148,9 @@ runtime_driver(int argc, char ** argv) {
   // Execute the user driver.
   driver(argc, argv);
 
+  // Wait for the asynchronously executed tasks.
+  mpi_task_scheduler_t::instance().fence();
+
 #endif // FLECSI_ENABLE_DYNAMIC_CONTROL_MODEL
 
 } // runtime_driver
@@ -21,6 +21,7 @@
 
 #include <mpi.h>
 
+#include <flecsi/execution/common/instrumentation.h>
 #include <flecsi/execution/context.h>
 
 // Boost command-line options
@@ -35,8 +36,11 @@ using namespace boost::program_options;
 int
 main(int argc, char ** argv) {
 
-  // Initialize the MPI runtime
-  MPI_Init(&argc, &argv);
+  // Initialize the MPI runtime. Multiple threads are requested for the
+  // I/O thread of asynchronous checkpoints, which falls back to
+  // synchronous writes if they are not provided.
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
 
   // get the rank
   int rank{0};
@@ -56,7 +60,16 @@ main(int argc, char ** argv) {
   desc.add_options()("help,h", "Print this message and exit.")("tags,t",
     value(&tags)->implicit_value("0"),
     "Enable the specified output tags, e.g., --tags=tag1,tag2."
-    " Passing --tags by itself will print the available tags.");
+    " Passing --tags by itself will print the available tags.")(
+    "coloring-report", value<std::string>()->implicit_value("coloring.json"),
+    "Write a JSON report of the coloring quality of each index space.")(
+    "instrumentation-report",
+    value<std::string>()->implicit_value("instrumentation.json"),
+    "Write a JSON report of the task instrumentation of each rank, if it"
+    " is enabled.")("timeline",
+    value<std::string>()->implicit_value("timeline.json"),
+    "Record a Chrome trace of the tasks, ghost updates, reductions and"
+    " checkpoints of each rank.");
   variables_map vm;
   parsed_options parsed =
     command_line_parser(argc, argv).options(desc).allow_unregistered().run();
@@ -73,6 +86,21 @@ main(int argc, char ** argv) {
     return 1;
   } // if
 
+  if(vm.count("coloring-report")) {
+    flecsi::execution::context_t::instance().set_coloring_report(
+      vm["coloring-report"].as<std::string>());
+  } // if
+
+  if(vm.count("instrumentation-report")) {
+    flecsi::execution::instrumentation_registry_t::instance().set_report(
+      vm["instrumentation-report"].as<std::string>());
+  } // if
+
+  if(vm.count("timeline")) {
+    flecsi::execution::timeline_t::instance().start(
+      vm["timeline"].as<std::string>());
+  } // if
+
 #endif // FLECSI_ENABLE_BOOST
 
   int result{0};
@@ -93,6 +121,12 @@ main(int argc, char ** argv) {
 
     // Execute the flecsi runtime.
     result = flecsi::execution::context_t::instance().initialize(argc, argv);
+
+    // Report the task instrumentation of the ranks.
+    flecsi::execution::report_instrumentation();
+
+    // Write the timeline of the ranks, if it was recorded.
+    flecsi::execution::report_timeline();
   } // if
 
   // Shutdown the MPI runtime
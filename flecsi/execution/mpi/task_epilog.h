@@ -37,6 +37,7 @@
 #include <flecsi/coloring/mpi_utils.h>
 #include <flecsi/data/data.h>
 #include <flecsi/data/dense_accessor.h>
+#include <flecsi/execution/common/instrumentation.h>
 #include <flecsi/execution/context.h>
 
 #include <flecsi/utils/tuple_walker.h>
@@ -45,6 +46,30 @@
 namespace flecsi {
 namespace execution {
 
+/*!
+ The task_epilog_cache_t type holds the field metadata and coloring
+ information of the writable dense handles of the launches of a task,
+ in argument order, so that repeated launches with the same fields do
+ not look them up again. The entries are only valid for the metadata
+ generation of the context in which they were looked up.
+
+ @ingroup execution
+ */
+
+struct task_epilog_cache_t {
+
+  struct entry_t {
+    field_id_t fid;
+    size_t index_space;
+    context_t::field_metadata_t * metadata;
+    const context_t::coloring_info_t * coloring_info;
+  }; // struct entry_t
+
+  std::vector<entry_t> entries;
+  size_t generation = 0;
+
+}; // struct task_epilog_cache_t
+
 /*!
  The task_epilog_t type can be called to walk the task args after the
  task has run. This allows synchronization dependencies to be added
@@ -61,6 +86,13 @@ struct task_epilog_t : public flecsi::utils::tuple_walker_u<task_epilog_t> {
 
   task_epilog_t() = default;
 
+  /*!
+   Construct a task_epilog_t instance that uses and updates the cache of
+   a task.
+   */
+
+  task_epilog_t(task_epilog_cache_t & cache) : cache_(&cache) {}
+
   /*!
    FIXME: Need a description.
 
@@ -89,10 +121,11 @@ struct task_epilog_t : public flecsi::utils::tuple_walker_u<task_epilog_t> {
       return;
 
     auto & context = context_t::instance();
-    const int my_color = context.color();
-    auto & my_coloring_info = context.coloring_info(h.index_space).at(my_color);
+    context.mark_field_written(h.fid);
 
-    auto & field_metadata = context.registered_field_metadata().at(h.fid);
+    const auto & entry = dense_entry(h.fid, h.index_space);
+    auto & my_coloring_info = *entry.coloring_info;
+    auto & field_metadata = *entry.metadata;
 
     MPI_Win win = field_metadata.win;
 
@@ -106,8 +139,49 @@ struct task_epilog_t : public flecsi::utils::tuple_walker_u<task_epilog_t> {
 
     MPI_Win_complete(win);
     MPI_Win_wait(win);
+
+    instrument_ghost_update(h.fid, h.ghost_size * sizeof(T));
   } // handle
 
+  /*!
+   Return the field metadata and coloring information of the next
+   writable dense handle, from the cache if it holds the same field.
+   */
+
+  const task_epilog_cache_t::entry_t & dense_entry(field_id_t fid,
+    size_t index_space) {
+    const size_t position = dense_++;
+    auto & context = context_t::instance();
+
+    // The metadata or coloring information has been replaced, e.g., by a
+    // rebalance, since the entries were looked up.
+    if(cache_ && cache_->generation != context.metadata_generation()) {
+      cache_->entries.clear();
+      cache_->generation = context.metadata_generation();
+    } // if
+
+    if(cache_ && position < cache_->entries.size()) {
+      auto & entry = cache_->entries[position];
+      if(entry.fid == fid && entry.index_space == index_space) {
+        return entry;
+      } // if
+    } // if
+
+    entry_ = {fid, index_space, &context.registered_field_metadata().at(fid),
+      &context.coloring_info(index_space).at(context.color())};
+
+    if(cache_) {
+      if(position < cache_->entries.size()) {
+        cache_->entries[position] = entry_;
+      }
+      else {
+        cache_->entries.push_back(entry_);
+      } // if
+    } // if
+
+    return entry_;
+  } // dense_entry
+
   template<typename T, size_t PERMISSIONS>
   void handle(global_accessor_u<T, PERMISSIONS> & a) {
     auto & h = a.handle;
@@ -139,6 +213,7 @@ struct task_epilog_t : public flecsi::utils::tuple_walker_u<task_epilog_t> {
       return;
 
     auto & context = context_t::instance();
+    context.mark_field_written(h.fid);
     const int my_color = context.color();
     auto & my_coloring_info = context.coloring_info(h.index_space).at(my_color);
     auto index_coloring = context.coloring(h.index_space);
@@ -187,6 +262,9 @@ struct task_epilog_t : public flecsi::utils::tuple_walker_u<task_epilog_t> {
 
     MPI_Win_free(&win);
 
+    instrument_ghost_update(
+      h.fid, h.num_ghost_ * h.max_entries_per_index * sizeof(value_t));
+
     for(int i = 0; i < h.num_ghost_ * h.max_entries_per_index; i++)
       clog_rank(warn, 0) << "ghost after: " << ghost_data[i] << std::endl;
 
@@ -260,7 +338,9 @@ struct task_epilog_t : public flecsi::utils::tuple_walker_u<task_epilog_t> {
   } // handle
 
   template<typename T>
-  void handle(ragged_mutator<T> & m) {} // handle
+  void handle(ragged_mutator<T> & m) {
+    context_t::instance().mark_field_written(m.handle.fid);
+  } // handle
 
   template<typename T>
   void handle(sparse_mutator<T> & m) {
@@ -437,6 +517,11 @@ struct task_epilog_t : public flecsi::utils::tuple_walker_u<task_epilog_t> {
   template<typename T>
   void handle(T &) {} // handle
 
+private:
+  task_epilog_cache_t * cache_ = nullptr;
+  task_epilog_cache_t::entry_t entry_;
+  size_t dense_ = 0;
+
 }; // struct task_epilog_t
 
 } // namespace execution
@@ -0,0 +1,353 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <cinchlog.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "mpi.h"
+
+#include <flecsi/data/dense_accessor.h>
+#include <flecsi/execution/common/instrumentation.h>
+#include <flecsi/execution/context.h>
+#include <flecsi/execution/mpi/task_scheduler.h>
+#include <flecsi/utils/tuple_walker.h>
+
+namespace flecsi {
+namespace execution {
+
+/*!
+  The ghost_schedule_t type is the precomputed ghost update of a dense
+  field that was written by a task: the window of the field, and the
+  datatypes of the transfers from the owners of its ghosts.
+
+  @ingroup mpi-execution
+ */
+
+struct ghost_schedule_t {
+
+  struct transfer_t {
+    int owner;
+    MPI_Datatype origin_type;
+    MPI_Datatype target_type;
+  }; // struct transfer_t
+
+  /*!
+    Update the ghosts of the field. This is the ghost update of
+    task_epilog_t, without the lookups of the field metadata.
+   */
+
+  void execute() const {
+    MPI_Win_post(shared_users_grp, 0, win);
+    MPI_Win_start(ghost_owners_grp, 0, win);
+
+    for(const auto & transfer : transfers) {
+      MPI_Get(ghost_data, 1, transfer.origin_type, transfer.owner, 0, 1,
+        transfer.target_type, win);
+    } // for
+
+    MPI_Win_complete(win);
+    MPI_Win_wait(win);
+  } // execute
+
+  field_id_t fid;
+  void * ghost_data;
+  MPI_Win win;
+  MPI_Group shared_users_grp;
+  MPI_Group ghost_owners_grp;
+  std::vector<transfer_t> transfers;
+  size_t bytes;
+
+}; // struct ghost_schedule_t
+
+/*!
+  The ghost_schedules_t type computes the ghost schedules of the
+  writable dense accessors of the arguments of a task.
+
+  @ingroup mpi-execution
+ */
+
+struct ghost_schedules_t
+  : public flecsi::utils::tuple_walker_u<ghost_schedules_t> {
+
+  template<typename T,
+    size_t EXCLUSIVE_PERMISSIONS,
+    size_t SHARED_PERMISSIONS,
+    size_t GHOST_PERMISSIONS>
+  void handle(dense_accessor<T,
+    EXCLUSIVE_PERMISSIONS,
+    SHARED_PERMISSIONS,
+    GHOST_PERMISSIONS> & a) {
+    auto & h = a.handle;
+
+    if(EXCLUSIVE_PERMISSIONS == ro && SHARED_PERMISSIONS == ro)
+      return;
+
+    auto & context = context_t::instance();
+    auto & coloring_info =
+      context.coloring_info(h.index_space).at(context.color());
+    auto & field_metadata = context.registered_field_metadata().at(h.fid);
+
+    ghost_schedule_t schedule{h.fid, h.ghost_data, field_metadata.win,
+      field_metadata.shared_users_grp, field_metadata.ghost_owners_grp, {},
+      h.ghost_size * sizeof(T)};
+
+    for(auto ghost_owner : coloring_info.ghost_owners) {
+      schedule.transfers.push_back({int(ghost_owner),
+        field_metadata.origin_types[ghost_owner],
+        field_metadata.target_types[ghost_owner]});
+    } // for
+
+    schedules.push_back(std::move(schedule));
+  } // handle
+
+  template<typename T>
+  void handle(T &) {} // handle
+
+  std::vector<ghost_schedule_t> schedules;
+
+}; // struct ghost_schedules_t
+
+/*!
+  The mpi_task_graph_t type records the tasks that are launched in a
+  trace, with their field accesses and the ghost schedules of the fields
+  they write, on the first execution of the trace. The following
+  executions check that the same tasks are launched on the same fields,
+  and replay the recording instead of walking the task arguments again.
+
+  A recording is discarded when a launch does not match it, when the
+  field data or metadata of the context change, and when the traces are
+  invalidated, e.g., because the control model changed. The next
+  execution of the trace is then recorded again.
+
+  @ingroup mpi-execution
+ */
+
+struct mpi_task_graph_t {
+
+  /*!
+    A recorded task launch. Untracked tasks, whose arguments are not
+    only values, dense accessors and read-only global accessors, are
+    recorded by their key only, and executed normally.
+   */
+
+  struct task_t {
+
+    /*!
+      Update the ghosts of the fields written by the task.
+     */
+
+    void epilog() const {
+      auto & context = context_t::instance();
+
+      for(const auto & schedule : schedules) {
+        context.mark_field_written(schedule.fid);
+        schedule.execute();
+        instrument_ghost_update(schedule.fid, schedule.bytes);
+      } // for
+    } // epilog
+
+    size_t key;
+    bool tracked;
+    std::vector<task_access_t> accesses;
+    std::vector<ghost_schedule_t> schedules;
+
+  }; // struct task_t
+
+  using task_ptr_t = std::shared_ptr<const task_t>;
+
+  /*!
+    Return the task graph instance.
+   */
+
+  static mpi_task_graph_t & instance() {
+    static mpi_task_graph_t graph;
+    return graph;
+  } // instance
+
+  /*!
+    Begin a trace, which is replayed if it has been recorded with the
+    current fields, and recorded otherwise.
+   */
+
+  void begin(size_t trace) {
+    clog_assert(!tracing_, "traces cannot be nested");
+    tracing_ = true;
+
+    // The recorded ghost schedules point into the field data and
+    // metadata of the context, which are only valid for the metadata
+    // generation of the recording.
+    const size_t generation = context_t::instance().metadata_generation();
+
+    graph_ = &graphs_[trace];
+
+    if(graph_->complete && graph_->generation == generation) {
+      mode_ = replay;
+      next_ = 0;
+    }
+    else {
+      *graph_ = {generation, {}, false};
+      mode_ = record;
+    } // if
+  } // begin
+
+  /*!
+    End the trace in progress.
+   */
+
+  void end() {
+    clog_assert(tracing_, "no trace to end");
+    tracing_ = false;
+
+    if(mode_ == record) {
+      graph_->complete = true;
+    }
+    else if(mode_ == replay && next_ != graph_->tasks.size()) {
+      discard();
+    } // if
+
+    mode_ = none;
+  } // end
+
+  /*!
+    Discard all recordings. A trace in progress is neither recorded nor
+    replayed any further.
+   */
+
+  void invalidate() {
+    graphs_.clear();
+    graph_ = nullptr;
+    mode_ = none;
+  } // invalidate
+
+  /*!
+    Return whether a trace is recorded or replayed.
+   */
+
+  bool active() const {
+    return mode_ != none;
+  } // active
+
+  /*!
+    Record or replay the launch of a tracked task with the given field
+    accesses.
+
+    @param key       The task key.
+    @param accesses  The field accesses of the task.
+    @param schedules A callable object that returns the ghost schedules
+                     of the task, which is only called when recording.
+
+    @return The recorded launch, or null if the trace is not active or
+            the launch does not match the recording.
+   */
+
+  template<typename SCHEDULES>
+  task_ptr_t launch(size_t key,
+    std::vector<task_access_t> && accesses,
+    SCHEDULES && schedules) {
+    if(mode_ == record) {
+      auto task = std::make_shared<task_t>(
+        task_t{key, true, std::move(accesses), schedules()});
+      graph_->tasks.push_back(task);
+      return task;
+    } // if
+
+    if(mode_ == replay) {
+      if(next_ < graph_->tasks.size()) {
+        const auto & task = graph_->tasks[next_];
+
+        if(task->key == key && task->tracked &&
+           same(task->accesses, accesses)) {
+          ++next_;
+          return task;
+        } // if
+      } // if
+
+      discard();
+    } // if
+
+    return nullptr;
+  } // launch
+
+  /*!
+    Record or replay the launch of an untracked task.
+   */
+
+  void launch(size_t key) {
+    if(mode_ == record) {
+      graph_->tasks.push_back(std::make_shared<task_t>(task_t{key, false}));
+    }
+    else if(mode_ == replay) {
+      if(next_ < graph_->tasks.size() && graph_->tasks[next_]->key == key &&
+         !graph_->tasks[next_]->tracked) {
+        ++next_;
+        return;
+      } // if
+
+      discard();
+    } // if
+  } // launch
+
+private:
+  struct graph_t {
+    size_t generation;
+    std::vector<task_ptr_t> tasks;
+    bool complete;
+  }; // struct graph_t
+
+  enum mode_t { none, record, replay };
+
+  mpi_task_graph_t() = default;
+
+  static bool same(const std::vector<task_access_t> & a,
+    const std::vector<task_access_t> & b) {
+    if(a.size() != b.size()) {
+      return false;
+    } // if
+
+    for(size_t i = 0; i < a.size(); ++i) {
+      if(a[i].fid != b[i].fid || a[i].read != b[i].read ||
+         a[i].write != b[i].write || a[i].ghost_read != b[i].ghost_read) {
+        return false;
+      } // if
+    } // for
+
+    return true;
+  } // same
+
+  /*!
+    Discard the recording of the trace in progress, which is executed
+    without it from now on.
+   */
+
+  void discard() {
+    *graph_ = {};
+    mode_ = none;
+  } // discard
+
+  std::map<size_t, graph_t> graphs_;
+  graph_t * graph_ = nullptr;
+  mode_t mode_ = none;
+  size_t next_ = 0;
+  bool tracing_ = false;
+
+}; // struct mpi_task_graph_t
+
+} // namespace execution
+} // namespace flecsi
@@ -0,0 +1,320 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <cinchlog.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <flecsi/concurrency/thread_pool.h>
+#include <flecsi/data/common/privilege.h>
+#include <flecsi/data/dense_accessor.h>
+#include <flecsi/runtime/types.h>
+#include <flecsi/utils/tuple_walker.h>
+
+namespace flecsi {
+namespace execution {
+
+/*!
+  The task_access_t type describes the access of a task to a dense field.
+
+  @ingroup mpi-execution
+ */
+
+struct task_access_t {
+  field_id_t fid;
+
+  //! The task reads the exclusive, shared or ghost entities.
+  bool read;
+
+  //! The task writes the exclusive, shared or ghost entities.
+  bool write;
+
+  //! The task reads the ghost entities, which are updated by the epilog
+  //! of the last task that wrote the field.
+  bool ghost_read;
+
+}; // struct task_access_t
+
+/*!
+  The task_accesses_t type collects the field accesses of the dense
+  accessors of the arguments of a task.
+
+  @ingroup mpi-execution
+ */
+
+struct task_accesses_t : public flecsi::utils::tuple_walker_u<task_accesses_t> {
+
+  template<typename T,
+    size_t EXCLUSIVE_PERMISSIONS,
+    size_t SHARED_PERMISSIONS,
+    size_t GHOST_PERMISSIONS>
+  void handle(dense_accessor<T,
+    EXCLUSIVE_PERMISSIONS,
+    SHARED_PERMISSIONS,
+    GHOST_PERMISSIONS> & a) {
+    constexpr auto reads = [](size_t p) { return p == ro || p == rw; };
+    constexpr auto writes = [](size_t p) { return p == wo || p == rw; };
+
+    accesses.push_back({a.handle.fid,
+      reads(EXCLUSIVE_PERMISSIONS) || reads(SHARED_PERMISSIONS) ||
+        reads(GHOST_PERMISSIONS),
+      writes(EXCLUSIVE_PERMISSIONS) || writes(SHARED_PERMISSIONS) ||
+        writes(GHOST_PERMISSIONS),
+      reads(GHOST_PERMISSIONS)});
+  } // handle
+
+  template<typename T>
+  void handle(T &) {} // handle
+
+  std::vector<task_access_t> accesses;
+
+}; // struct task_accesses_t
+
+/*!
+  The mpi_task_scheduler_t type executes the tasks of a rank on a thread
+  pool, in an order that preserves the sequential semantics of their
+  launches: a task runs after the earlier tasks that write a field it
+  accesses, or read a field it writes, have finished.
+
+  The epilog of a task, which updates the ghosts of the fields it wrote,
+  communicates with the other ranks. The epilogs are therefore executed
+  by the launching thread in launch order, when a later task depends on
+  them, or when the task is waited on, so that all ranks call them in
+  the same order.
+
+  @ingroup mpi-execution
+ */
+
+struct mpi_task_scheduler_t {
+
+  struct node_t {
+    std::function<void()> body;
+    std::function<void()> epilog;
+    std::vector<std::shared_ptr<node_t>> successors;
+    size_t predecessors = 0;
+    bool done = false;
+    bool epilog_done = false;
+  }; // struct node_t
+
+  using node_ptr_t = std::shared_ptr<node_t>;
+
+  /*!
+    Return the scheduler instance.
+   */
+
+  static mpi_task_scheduler_t & instance() {
+    static mpi_task_scheduler_t scheduler;
+    return scheduler;
+  } // instance
+
+  /*!
+    Return the number of threads of the pool; zero if the tasks are
+    executed synchronously.
+   */
+
+  size_t threads() const {
+    return pool_ ? pool_->num_threads() : 0;
+  } // threads
+
+  /*!
+    Set the number of threads of the pool. If zero, the tasks are
+    executed synchronously. The pending tasks are finished first.
+   */
+
+  void set_threads(size_t threads) {
+    fence();
+    pool_.reset();
+
+    if(threads > 0) {
+      pool_ = std::make_unique<thread_pool>();
+      pool_->start(threads);
+    } // if
+  } // set_threads
+
+  /*!
+    Submit a task with the given field accesses. The body is executed on
+    the thread pool, and the epilog, if any, on the calling thread.
+
+    @return The node of the task, which can be waited on.
+   */
+
+  node_ptr_t submit(const std::vector<task_access_t> & accesses,
+    std::function<void()> body,
+    std::function<void()> epilog) {
+    clog_assert(pool_, "asynchronous tasks are not enabled");
+
+    auto node = std::make_shared<node_t>();
+    node->body = std::move(body);
+    node->epilog = std::move(epilog);
+
+    // The pending epilog of the last writer of a field updates its ghosts,
+    // and reads its shared entities on the other ranks.
+    for(const auto & access : accesses) {
+      auto & field = fields_[access.fid];
+      if(field.writer && (access.write || access.ghost_read)) {
+        flush(field.writer);
+      } // if
+    } // for
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      auto depend = [&](const node_ptr_t & predecessor) {
+        if(predecessor != node && !predecessor->done) {
+          predecessor->successors.push_back(node);
+          ++node->predecessors;
+        } // if
+      };
+
+      for(const auto & access : accesses) {
+        auto & field = fields_[access.fid];
+
+        if(field.writer) {
+          depend(field.writer);
+        } // if
+
+        if(access.write) {
+          for(auto & reader : field.readers) {
+            depend(reader);
+          } // for
+          field.writer = node;
+          field.readers.clear();
+        }
+        else {
+          auto finished = [](const node_ptr_t & reader) {
+            return reader->done;
+          };
+          field.readers.erase(std::remove_if(field.readers.begin(),
+                                field.readers.end(), finished),
+            field.readers.end());
+          field.readers.push_back(node);
+        } // if
+      } // for
+
+      ++pending_;
+
+      if(node->predecessors == 0) {
+        queue(node);
+      } // if
+    } // scope
+
+    if(node->epilog) {
+      epilogs_.push_back(node);
+    } // if
+
+    return node;
+  } // submit
+
+  /*!
+    Wait for a task and its epilog.
+   */
+
+  void wait(const node_ptr_t & node) {
+    flush(node);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&]() { return node->done; });
+  } // wait
+
+  /*!
+    Wait for all submitted tasks and their epilogs.
+   */
+
+  void fence() {
+    while(!epilogs_.empty()) {
+      flush(epilogs_.back());
+    } // while
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&]() { return pending_ == 0; });
+    fields_.clear();
+  } // fence
+
+private:
+  struct field_state_t {
+    node_ptr_t writer;
+    std::vector<node_ptr_t> readers;
+  }; // struct field_state_t
+
+  mpi_task_scheduler_t() = default;
+
+  /*!
+    Execute the pending epilogs in launch order, up to the one of the
+    given task.
+   */
+
+  void flush(const node_ptr_t & node) {
+    if(!node->epilog || node->epilog_done) {
+      return;
+    } // if
+
+    while(!node->epilog_done) {
+      node_ptr_t next = epilogs_.front();
+      epilogs_.pop_front();
+
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&]() { return next->done; });
+      } // scope
+
+      next->epilog();
+      next->epilog_done = true;
+    } // while
+  } // flush
+
+  /*!
+    Queue a task whose predecessors have finished. The mutex must be
+    held.
+   */
+
+  void queue(node_ptr_t node) {
+    pool_->queue([this, node]() {
+      node->body();
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      node->done = true;
+      --pending_;
+
+      for(auto & successor : node->successors) {
+        if(--successor->predecessors == 0) {
+          queue(successor);
+        } // if
+      } // for
+      node->successors.clear();
+
+      done_.notify_all();
+    });
+  } // queue
+
+  std::unique_ptr<thread_pool> pool_;
+  std::map<field_id_t, field_state_t> fields_;
+  std::deque<node_ptr_t> epilogs_;
+  std::mutex mutex_;
+  std::condition_variable done_;
+  size_t pending_ = 0;
+
+}; // struct mpi_task_scheduler_t
+
+} // namespace execution
+} // namespace flecsi
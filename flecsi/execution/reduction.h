@@ -95,7 +95,7 @@ struct max {
 
   using LHS = T;
   using RHS = T;
-  static constexpr T identity{};
+  static constexpr T identity{std::numeric_limits<T>::lowest()};
 
   template<bool EXCLUSIVE = true>
   static void apply(LHS & lhs, RHS rhs) {
@@ -177,7 +177,7 @@ struct product {
 
   using LHS = T;
   using RHS = T;
-  static constexpr T identity{};
+  static constexpr T identity{1};
 
   template<bool EXCLUSIVE = true>
   static void apply(LHS & lhs, RHS rhs) {
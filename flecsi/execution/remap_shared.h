@@ -12,13 +12,23 @@
    All rights reserved.
                                                                               */
 /*! @file */
+#include <limits>
+
 #include <flecsi/coloring/mpi_utils.h>
 
 namespace flecsi {
 namespace execution {
 
+/*!
+  Renumber the shared entities so that their offsets are relative to the
+  start of the shared region, and update the ghost offsets to match.
+
+  @param only The index space to remap. All index spaces are remapped
+              by default.
+ */
+
 inline void
-remap_shared_entities() {
+remap_shared_entities(size_t only = std::numeric_limits<size_t>::max()) {
   // TODO: Is this superseded by index_map/reverse_index_map?
   auto & context_ = context_t::instance();
   const auto & my_color = context_.color();
@@ -30,6 +40,9 @@ remap_shared_entities() {
     auto index_space = coloring_info_pair.first;
     auto & coloring_info = coloring_info_pair.second;
 
+    if(only != std::numeric_limits<size_t>::max() && index_space != only)
+      continue;
+
     auto & my_coloring_info = context_.coloring_info(index_space).at(my_color);
     auto & index_coloring = context_.coloring(index_space);
 
@@ -45,7 +58,7 @@ remap_shared_entities() {
     // gather the data to send into one buffer per rank
     size_t index = 0;
     std::unordered_map<size_t, std::vector<size_t>> send_buffers;
-    std::set<flecsi::coloring::entity_info_t> new_shared;
+    flecsi::utils::flat_set_u<flecsi::coloring::entity_info_t> new_shared;
 
     for(auto & shared : index_coloring.shared) {
       for(auto peer : shared.shared) {
@@ -101,7 +114,7 @@ remap_shared_entities() {
     MPI_Waitall(requests.size(), requests.data(), status.data());
 
     // now we can unpack the messages and reconstruct the ghost entities
-    std::set<flecsi::coloring::entity_info_t> new_ghost;
+    flecsi::utils::flat_set_u<flecsi::coloring::entity_info_t> new_ghost;
     std::fill(counts.begin(), counts.end(), 0);
 
     for(auto ghost : index_coloring.ghost) {
@@ -18,6 +18,7 @@
 #include <iostream>
 #include <string>
 
+#include <flecsi/control/runtime.h>
 #include <flecsi/execution/common/launch.h>
 #include <flecsi/execution/common/processor.h>
 #include <flecsi/utils/static_verify.h>
@@ -99,6 +100,38 @@ struct task_interface_u {
       RETURN, ARG_TUPLE>(std::forward<ARGS>(args)...);
   } // execute_task
 
+  /*!
+    Begin a trace of the tasks that are executed until the matching call
+    to end_trace. A sequence of tasks that is traced with the same id
+    on each iteration must be identical, so that the backend can replay
+    the analysis of its dependences.
+
+    @param trace The trace id.
+   */
+
+  static void begin_trace(size_t trace) {
+    EXECUTION_POLICY::begin_trace(trace);
+  } // begin_trace
+
+  /*!
+    End the trace with the given id.
+
+    @param trace The trace id.
+   */
+
+  static void end_trace(size_t trace) {
+    EXECUTION_POLICY::end_trace(trace);
+  } // end_trace
+
+  /*!
+    Discard the recorded traces, so that the next execution of each
+    trace is recorded again.
+   */
+
+  static void invalidate_traces() {
+    EXECUTION_POLICY::invalidate_traces();
+  } // invalidate_traces
+
   /*!
     Register a custom reduction operation.
 
@@ -157,6 +190,16 @@ namespace execution {
 
 using task_interface_t = task_interface_u<FLECSI_RUNTIME_EXECUTION_POLICY>;
 
+/*!
+  Trace the iterations of the traced cycles of the control model with
+  the runtime.
+ */
+
+inline bool task_trace_handler_registered =
+  control::runtime_t::instance().register_trace_handler(
+    {task_interface_t::begin_trace, task_interface_t::end_trace,
+      task_interface_t::invalidate_traces});
+
 /*!
   Use the execution policy to define the future type.
 
@@ -0,0 +1,153 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+//----------------------------------------------------------------------------//
+//! @file
+//! @date Initial file creation: Oct 19, 2026
+//----------------------------------------------------------------------------//
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <cinchlog.h>
+#include <cinchtest.h>
+
+#include <flecsi/data/data.h>
+#include <flecsi/execution/execution.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/empty_mesh_2d.h>
+
+#define INDEX_ID 0
+#define VERSIONS 1
+
+using namespace flecsi;
+using namespace supplemental;
+
+void set_task(dense_accessor<size_t, wo, wo, na> f, size_t value);
+flecsi_register_task_simple(set_task, loc, index);
+
+void increment_task(dense_accessor<size_t, rw, rw, na> f);
+flecsi_register_task_simple(increment_task, loc, index);
+
+void check_task(dense_accessor<size_t, ro, ro, ro> f, size_t value);
+flecsi_register_task_simple(check_task, loc, index);
+
+flecsi_register_data_client(empty_mesh_2d_t, meshes, mesh1);
+
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  f0,
+  size_t,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  f1,
+  size_t,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+
+namespace flecsi {
+namespace execution {
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  supplemental::coloring_map_t map;
+  map.vertices = 1;
+  map.cells = 0;
+
+  flecsi_execute_mpi_task(add_colorings, flecsi::supplemental, map);
+
+} // specialization_tlt_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+  auto ch = flecsi_get_client_handle(empty_mesh_2d_t, meshes, mesh1);
+  auto h0 = flecsi_get_handle(ch, name_space, f0, size_t, dense, INDEX_ID);
+  auto h1 = flecsi_get_handle(ch, name_space, f1, size_t, dense, INDEX_ID);
+
+  const size_t steps = 20;
+
+  // Advance two independent fields, as two physics packages would, and
+  // check the values, including the ghosts, after every step.
+  auto run = [&]() {
+    flecsi_execute_task_simple(set_task, index, h0, 0);
+    flecsi_execute_task_simple(set_task, index, h1, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    for(size_t step = 1; step <= steps; ++step) {
+      flecsi_execute_task_simple(increment_task, index, h0);
+      flecsi_execute_task_simple(increment_task, index, h1);
+      flecsi_execute_task_simple(check_task, index, h0, step);
+      flecsi_execute_task_simple(check_task, index, h1, step);
+    } // for
+    flecsi_execute_task_simple(check_task, index, h1, steps).wait();
+    mpi_execution_policy_t::fence();
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    return elapsed.count();
+  };
+
+  const double synchronous = run();
+  mpi_execution_policy_t::set_async_threads(2);
+  const double asynchronous = run();
+  mpi_execution_policy_t::set_async_threads(0);
+
+  if(context_t::instance().color() == 0) {
+    std::cout << "synchronous:  " << synchronous << " s" << std::endl
+              << "asynchronous: " << asynchronous << " s" << std::endl;
+  } // if
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(async_tasks, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
+
+void
+set_task(dense_accessor<size_t, wo, wo, na> f, size_t value) {
+  for(size_t i = 0; i < f.exclusive_size(); ++i)
+    f.exclusive(i) = value;
+  for(size_t i = 0; i < f.shared_size(); ++i)
+    f.shared(i) = value;
+} // set_task
+
+void
+increment_task(dense_accessor<size_t, rw, rw, na> f) {
+  // Stand in for the work of a physics package.
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  for(size_t i = 0; i < f.exclusive_size(); ++i)
+    ++f.exclusive(i);
+  for(size_t i = 0; i < f.shared_size(); ++i)
+    ++f.shared(i);
+} // increment_task
+
+void
+check_task(dense_accessor<size_t, ro, ro, ro> f, size_t value) {
+  for(size_t i = 0; i < f.exclusive_size(); ++i)
+    ASSERT_EQ(f.exclusive(i), value);
+  for(size_t i = 0; i < f.shared_size(); ++i)
+    ASSERT_EQ(f.shared(i), value);
+  for(size_t i = 0; i < f.ghost_size(); ++i)
+    ASSERT_EQ(f.ghost(i), value);
+} // check_task
@@ -0,0 +1,143 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <cinchtest.h>
+
+#include <flecsi/execution/common/instrumentation.h>
+
+using namespace flecsi::execution;
+
+TEST(instrumentation, merge) {
+  instrumentation_t a, b;
+
+  a.tasks[1].launches = 2;
+  a.tasks[1].seconds[size_t(task_phase_t::user)] = 1.0;
+  a.fields[7] = {1, 64};
+  a.reductions = 1;
+  a.reduction_wait = 0.5;
+
+  b.tasks[1].launches = 3;
+  b.tasks[1].seconds[size_t(task_phase_t::user)] = 2.0;
+  b.tasks[2].launches = 1;
+  b.fields[7] = {2, 128};
+  b.reductions = 2;
+  b.reduction_wait = 0.25;
+
+  a.merge(b);
+
+  ASSERT_EQ(a.tasks.size(), 2);
+  ASSERT_EQ(a.tasks[1].launches, 5);
+  ASSERT_EQ(a.tasks[1].seconds[size_t(task_phase_t::user)], 3.0);
+  ASSERT_EQ(a.tasks[2].launches, 1);
+  ASSERT_EQ(a.fields[7].updates, 3);
+  ASSERT_EQ(a.fields[7].bytes, 192);
+  ASSERT_EQ(a.reductions, 3);
+  ASSERT_EQ(a.reduction_wait, 0.75);
+} // TEST
+
+TEST(instrumentation, threads) {
+  auto & registry = instrumentation_registry_t::instance();
+
+  // The threads record into their own instrumentation, which is kept
+  // when they exit.
+  std::vector<std::thread> threads;
+  for(size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([]() {
+      for(size_t i = 0; i < 100; ++i) {
+        ++instrumentation_registry_t::local().tasks[100].launches;
+        instrumentation_registry_t::local().fields[100].bytes += 8;
+      } // for
+    });
+  } // for
+
+  for(auto & thread : threads) {
+    thread.join();
+  } // for
+
+  ++instrumentation_registry_t::local().tasks[100].launches;
+
+  const auto collected = registry.collect();
+  ASSERT_EQ(collected.tasks.at(100).launches, 401);
+  ASSERT_EQ(collected.fields.at(100).bytes, 3200);
+} // TEST
+
+TEST(instrumentation, recording) {
+  auto & registry = instrumentation_registry_t::instance();
+
+  instrument_task_name(200, "recorded_task");
+
+  for(size_t i = 0; i < 10; ++i) {
+    instrument_task_launch(200);
+    task_phase_timer_t timer(200, task_phase_t::user);
+  } // for
+
+  instrument_ghost_update(200, 1024);
+
+  {
+    reduction_timer_t timer(200);
+  } // scope
+
+  // The names are registered for the timeline, but nothing is recorded
+  // when the instrumentation is not compiled in.
+  const auto collected = registry.collect();
+  ASSERT_EQ(registry.task_name(200), "recorded_task");
+  ASSERT_EQ(registry.task_name(201), "201");
+
+  if constexpr(instrumentation_enabled) {
+    ASSERT_EQ(collected.tasks.at(200).launches, 10);
+    ASSERT_GE(collected.tasks.at(200).seconds[size_t(task_phase_t::user)],
+      0.0);
+    ASSERT_EQ(collected.fields.at(200).bytes, 1024);
+    ASSERT_GE(collected.reductions, 1);
+  }
+  else {
+    ASSERT_EQ(collected.tasks.count(200), 0);
+    ASSERT_EQ(collected.fields.count(200), 0);
+    ASSERT_EQ(collected.reductions, 0);
+  } // if
+} // TEST
+
+TEST(instrumentation, report) {
+  std::vector<instrumentation_t> ranks(2);
+
+  ranks[0].tasks[300].launches = 4;
+  ranks[0].tasks[300].seconds[size_t(task_phase_t::epilog)] = 1.5;
+  ranks[1].tasks[300].launches = 4;
+  ranks[1].tasks[300].seconds[size_t(task_phase_t::epilog)] = 2.5;
+  ranks[0].fields[3] = {4, 256};
+  ranks[1].fields[3] = {4, 512};
+  ranks[0].reductions = ranks[1].reductions = 2;
+  ranks[0].reduction_wait = 0.5;
+  ranks[1].reduction_wait = 1.5;
+
+  std::stringstream table;
+  write_table(table, ranks);
+
+  // The table holds the maximum over the ranks, and the total ghost
+  // bytes.
+  ASSERT_NE(table.str().find("2.5"), std::string::npos);
+  ASSERT_NE(table.str().find("768"), std::string::npos);
+  ASSERT_NE(table.str().find("1.5 s maximum"), std::string::npos);
+
+  std::stringstream json;
+  write_json(json, ranks);
+
+  ASSERT_NE(json.str().find("\"rank\": 1"), std::string::npos);
+  ASSERT_NE(json.str().find("\"epilog\": 2.5"), std::string::npos);
+  ASSERT_NE(json.str().find("\"bytes\": 512"), std::string::npos);
+} // TEST
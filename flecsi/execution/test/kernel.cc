@@ -0,0 +1,185 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#include <cinchtest.h>
+
+#include <flecsi/execution/kernel.h>
+
+using namespace flecsi;
+using namespace topology;
+
+struct object_id {
+  size_t id;
+
+  object_id(size_t id) : id(id) {}
+
+  size_t index_space_index() const {
+    return id;
+  }
+
+  bool operator<(const object_id & oid) const {
+    return id < oid.id;
+  }
+};
+
+struct object {
+  object(object_id id) : id(id) {}
+
+  using id_t = object_id;
+
+  object_id index_space_id() const {
+    return id;
+  }
+
+  object_id id;
+  double value = 0.0;
+};
+
+// Sum reduction operation, with the interface of the reduction types.
+struct sum_t {
+  using LHS = double;
+  using RHS = double;
+  static constexpr double identity{0.0};
+
+  template<bool EXCLUSIVE = true>
+  static void apply(LHS & lhs, RHS rhs) {
+    lhs += rhs;
+  } // apply
+};
+
+// Min reduction operation.
+struct min_t {
+  using LHS = double;
+  using RHS = double;
+  static constexpr double identity{std::numeric_limits<double>::max()};
+
+  template<bool EXCLUSIVE = true>
+  static void apply(LHS & lhs, RHS rhs) {
+    lhs = lhs < rhs ? lhs : rhs;
+  } // apply
+};
+
+using index_space_t = index_space_u<object *, true, true, false>;
+
+// The ids of the entities of a sorted index space filled in order are
+// contiguous, so that for_each_u takes its vectorized path.
+using sorted_index_space_t = index_space_u<object *, true, true, true>;
+
+template<typename INDEX_SPACE>
+void
+fill(INDEX_SPACE & is, size_t n) {
+  for(size_t i = 0; i < n; ++i) {
+    is << new object(i);
+  } // for
+} // fill
+
+template<typename INDEX_SPACE>
+void
+clear(INDEX_SPACE & is) {
+  for(size_t i = 0; i < is.size(); ++i) {
+    delete is[i];
+  } // for
+} // clear
+
+template<typename INDEX_SPACE>
+double
+run(processor_type_t processor) {
+  INDEX_SPACE is;
+
+  const size_t n = 100000;
+  fill(is, n);
+
+  task_processor_guard_t guard(processor);
+
+  for_each_u(is, [](object * o) { o->value = 0.5 * o->id.id; });
+
+  double total = 1.0;
+  reduce_each_u<sum_t>(
+    is, total, [](object * o, double & sum) { sum += o->value; });
+
+  EXPECT_EQ(total, 1.0 + 0.25 * n * (n - 1));
+
+  double minimum = 7.0;
+  reduce_each_u<min_t>(is, minimum, [](object * o, double & m) {
+    m = std::min(m, 1.0 + o->value);
+  });
+
+  EXPECT_EQ(minimum, 1.0);
+
+  clear(is);
+
+  return total;
+} // run
+
+TEST(kernel, for_each_reduce_each) {
+  ASSERT_EQ(run<index_space_t>(processor_type_t::loc),
+    run<index_space_t>(processor_type_t::omp));
+} // TEST
+
+TEST(kernel, sorted_contiguous) {
+  ASSERT_EQ(run<sorted_index_space_t>(processor_type_t::loc),
+    run<sorted_index_space_t>(processor_type_t::omp));
+
+  // Every entity is visited once, by the entity at its own id.
+  sorted_index_space_t is;
+  const size_t n = 10000;
+  fill(is, n);
+
+  task_processor_guard_t guard(processor_type_t::omp);
+  for_each_u(is, [](object * o) { o->value += 1.0 + o->id.id; });
+
+  for(size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(is[i]->id.id, i);
+    ASSERT_EQ(is[i]->value, 1.0 + i);
+  } // for
+
+  clear(is);
+} // TEST
+
+// Compare the time per entity of the serial and threaded kernels over a
+// large index space.
+TEST(kernel, benchmark) {
+  index_space_t is;
+  const size_t n = 1 << 22;
+  fill(is, n);
+
+  auto time = [&](processor_type_t processor) {
+    task_processor_guard_t guard(processor);
+    double total = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for_each_u(is, [](object * o) { o->value = 2.0 * o->id.id; });
+    reduce_each_u<sum_t>(
+      is, total, [](object * o, double & sum) { sum += o->value; });
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(total, double(n) * (n - 1));
+    return elapsed.count() / n;
+  };
+
+  const double serial = time(processor_type_t::loc);
+  const double threaded = time(processor_type_t::omp);
+
+  std::cout << "time per entity, serial:   " << serial * 1.e9 << " ns"
+            << std::endl
+            << "time per entity, threaded: " << threaded * 1.e9 << " ns"
+            << std::endl;
+
+  clear(is);
+} // TEST
@@ -0,0 +1,144 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+//----------------------------------------------------------------------------//
+//! @file
+//! @date Initial file creation: Oct 19, 2026
+//----------------------------------------------------------------------------//
+
+#include <chrono>
+#include <iostream>
+
+#include <cinchlog.h>
+#include <cinchtest.h>
+
+#include <flecsi/data/data.h>
+#include <flecsi/execution/execution.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/empty_mesh_2d.h>
+
+#define INDEX_ID 0
+#define VERSIONS 1
+
+using namespace flecsi;
+using namespace supplemental;
+
+template<size_t PERMISSIONS>
+using field_t = dense_accessor<double, PERMISSIONS, PERMISSIONS, ro>;
+
+void empty_ro_task(field_t<ro> f0, field_t<ro> f1, field_t<ro> f2,
+  field_t<ro> f3);
+flecsi_register_task_simple(empty_ro_task, loc, index);
+
+void empty_rw_task(field_t<rw> f0, field_t<rw> f1, field_t<rw> f2,
+  field_t<rw> f3);
+flecsi_register_task_simple(empty_rw_task, loc, index);
+
+flecsi_register_data_client(empty_mesh_2d_t, meshes, mesh1);
+
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  f0,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  f1,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  f2,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  f3,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+
+namespace flecsi {
+namespace execution {
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  supplemental::coloring_map_t map;
+  map.vertices = 1;
+  map.cells = 0;
+
+  flecsi_execute_mpi_task(add_colorings, flecsi::supplemental, map);
+
+} // specialization_tlt_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+  auto ch = flecsi_get_client_handle(empty_mesh_2d_t, meshes, mesh1);
+  auto h0 = flecsi_get_handle(ch, name_space, f0, double, dense, INDEX_ID);
+  auto h1 = flecsi_get_handle(ch, name_space, f1, double, dense, INDEX_ID);
+  auto h2 = flecsi_get_handle(ch, name_space, f2, double, dense, INDEX_ID);
+  auto h3 = flecsi_get_handle(ch, name_space, f3, double, dense, INDEX_ID);
+
+  // Read-only launches skip the handle walkers, while read-write ones
+  // update the ghosts of their fields.
+  const size_t ro_tasks = 1000000;
+  const size_t rw_tasks = 10000;
+
+  auto time = [](size_t tasks, auto && launch) {
+    auto start = std::chrono::steady_clock::now();
+    for(size_t t = 0; t < tasks; ++t) {
+      launch();
+    } // for
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    return elapsed.count() / tasks;
+  };
+
+  const double ro_time = time(ro_tasks, [&]() {
+    flecsi_execute_task_simple(empty_ro_task, index, h0, h1, h2, h3);
+  });
+  const double rw_time = time(rw_tasks, [&]() {
+    flecsi_execute_task_simple(empty_rw_task, index, h0, h1, h2, h3);
+  });
+
+  if(context_t::instance().color() == 0) {
+    std::cout << "launch overhead with 4 dense handles" << std::endl
+              << "  read-only:  " << ro_time * 1.e9 << " ns" << std::endl
+              << "  read-write: " << rw_time * 1.e9 << " ns" << std::endl;
+  } // if
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(launch_overhead, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
+
+void
+empty_ro_task(field_t<ro> f0, field_t<ro> f1, field_t<ro> f2, field_t<ro> f3) {
+} // empty_ro_task
+
+void
+empty_rw_task(field_t<rw> f0, field_t<rw> f1, field_t<rw> f2, field_t<rw> f3) {
+} // empty_rw_task
@@ -0,0 +1,156 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+//----------------------------------------------------------------------------//
+//! @file
+//! @date Initial file creation: Oct 19, 2026
+//----------------------------------------------------------------------------//
+
+#include <chrono>
+#include <iostream>
+
+#include <cinchlog.h>
+#include <cinchtest.h>
+
+#include <flecsi/data/data.h>
+#include <flecsi/execution/execution.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/empty_mesh_2d.h>
+
+#define INDEX_ID 0
+#define VERSIONS 1
+
+using namespace flecsi;
+using namespace supplemental;
+
+void set_task(
+  dense_accessor<size_t, flecsi::rw, flecsi::rw, flecsi::na> cell_ID,
+  const size_t value);
+flecsi_register_task_simple(set_task, loc, index);
+
+void increment_task(
+  dense_accessor<size_t, flecsi::rw, flecsi::rw, flecsi::na> cell_ID);
+flecsi_register_task_simple(increment_task, loc, index);
+
+void check_task(
+  dense_accessor<size_t, flecsi::ro, flecsi::ro, flecsi::ro> cell_ID,
+  const size_t value);
+flecsi_register_task_simple(check_task, loc, index);
+
+flecsi_register_data_client(empty_mesh_2d_t, meshes, mesh1);
+
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  field1,
+  size_t,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+
+namespace flecsi {
+namespace execution {
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  supplemental::coloring_map_t map;
+  map.vertices = 1;
+  map.cells = 0;
+
+  flecsi_execute_mpi_task(add_colorings, flecsi::supplemental, map);
+
+} // specialization_tlt_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+  auto ch = flecsi_get_client_handle(empty_mesh_2d_t, meshes, mesh1);
+  auto handle =
+    flecsi_get_handle(ch, name_space, field1, size_t, dense, INDEX_ID);
+
+  const size_t steps = 200;
+  const size_t trace_id = 1;
+  size_t value = 0;
+
+  // Execute the time steps, each of which increments the field and reads
+  // it back with its ghosts, and return the time per task.
+  auto run = [&](bool traced) {
+    flecsi_execute_task_simple(set_task, index, handle, value).wait();
+
+    auto start = std::chrono::steady_clock::now();
+    for(size_t step = 0; step < steps; ++step) {
+      // The first step also copies the ghosts of the initial values.
+      if(traced && step > 0)
+        flecsi_begin_trace(trace_id);
+
+      flecsi_execute_task_simple(increment_task, index, handle);
+      ++value;
+      flecsi_execute_task_simple(check_task, index, handle, value);
+
+      if(traced && step > 0)
+        flecsi_end_trace(trace_id);
+    } // for
+    flecsi_execute_task_simple(check_task, index, handle, value).wait();
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / (2 * steps + 1);
+  };
+
+  const double untraced = run(false);
+  const double traced = run(true);
+
+  if(context_t::instance().color() == 0) {
+    std::cout << "time per task without tracing: " << untraced * 1.e6
+              << " us" << std::endl
+              << "time per task with tracing:    " << traced * 1.e6 << " us"
+              << std::endl;
+  } // if
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(trace, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
+
+void
+set_task(dense_accessor<size_t, flecsi::rw, flecsi::rw, flecsi::na> cell_ID,
+  const size_t value) {
+  for(size_t i = 0; i < cell_ID.exclusive_size(); ++i)
+    cell_ID.exclusive(i) = value;
+  for(size_t i = 0; i < cell_ID.shared_size(); ++i)
+    cell_ID.shared(i) = value;
+} // set_task
+
+void
+increment_task(
+  dense_accessor<size_t, flecsi::rw, flecsi::rw, flecsi::na> cell_ID) {
+  for(size_t i = 0; i < cell_ID.exclusive_size(); ++i)
+    ++cell_ID.exclusive(i);
+  for(size_t i = 0; i < cell_ID.shared_size(); ++i)
+    ++cell_ID.shared(i);
+} // increment_task
+
+void
+check_task(dense_accessor<size_t, flecsi::ro, flecsi::ro, flecsi::ro> cell_ID,
+  const size_t value) {
+  for(size_t i = 0; i < cell_ID.exclusive_size(); ++i)
+    ASSERT_EQ(cell_ID.exclusive(i), value);
+  for(size_t i = 0; i < cell_ID.shared_size(); ++i)
+    ASSERT_EQ(cell_ID.shared(i), value);
+  for(size_t i = 0; i < cell_ID.ghost_size(); ++i)
+    ASSERT_EQ(cell_ID.ghost(i), value);
+} // check_task
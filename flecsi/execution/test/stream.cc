@@ -0,0 +1,286 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+//----------------------------------------------------------------------------//
+//! @file
+//! @date Initial file creation: Oct 19, 2026
+//----------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <cinchlog.h>
+#include <cinchtest.h>
+
+#include <flecsi/data/data.h>
+#include <flecsi/execution/execution.h>
+#include <flecsi/supplemental/mesh/empty_mesh_2d.h>
+
+#define INDEX_ID 0
+#define VERSIONS 1
+
+using namespace flecsi;
+using namespace supplemental;
+
+// The entities of each rank, so that the fields exceed the caches, and
+// the iterations of the kernels.
+const size_t entities = size_t(1) << 21;
+const size_t repeats = 10;
+
+template<size_t PERMISSIONS>
+using field_t = dense_accessor<double, PERMISSIONS, PERMISSIONS, na>;
+
+void init_task(field_t<wo> a, field_t<wo> b, field_t<wo> c);
+flecsi_register_task_simple(init_task, omp, index);
+
+void copy_task(field_t<wo> c, field_t<ro> a);
+flecsi_register_task_simple(copy_task, omp, index);
+
+void scale_task(field_t<wo> b, field_t<ro> c, double scalar);
+flecsi_register_task_simple(scale_task, omp, index);
+
+void add_task(field_t<wo> c, field_t<ro> a, field_t<ro> b);
+flecsi_register_task_simple(add_task, omp, index);
+
+void triad_task(field_t<wo> a, field_t<ro> b, field_t<ro> c, double scalar);
+flecsi_register_task_simple(triad_task, omp, index);
+
+void check_task(field_t<ro> a, field_t<ro> b, field_t<ro> c, double scalar);
+flecsi_register_task_simple(check_task, loc, index);
+
+flecsi_register_data_client(empty_mesh_2d_t, meshes, mesh1);
+
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  a,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  b,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  c,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  ft_a,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  ft_b,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  ft_c,
+  double,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+
+// The ft_ fields are touched first by the kernel threads, the others by
+// the thread that allocates them.
+flecsi_set_field_attribute(empty_mesh_2d_t,
+  name_space,
+  ft_a,
+  placement,
+  flecsi::data::placement_t::make_first_touch());
+flecsi_set_field_attribute(empty_mesh_2d_t,
+  name_space,
+  ft_b,
+  placement,
+  flecsi::data::placement_t::make_first_touch());
+flecsi_set_field_attribute(empty_mesh_2d_t,
+  name_space,
+  ft_c,
+  placement,
+  flecsi::data::placement_t::make_first_touch());
+
+namespace flecsi {
+namespace execution {
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  auto & context = context_t::instance();
+
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // Each rank owns its entities exclusively.
+  std::vector<coloring::entity_info_t> exclusive;
+  for(size_t i = 0; i < entities; ++i) {
+    exclusive.emplace_back(rank * entities + i, rank, i);
+  } // for
+
+  coloring::index_coloring_t coloring;
+  coloring.exclusive.insert(exclusive.begin(), exclusive.end());
+
+  std::unordered_map<size_t, coloring::coloring_info_t> coloring_info;
+  for(int r = 0; r < size; ++r) {
+    coloring_info[r] = {entities, 0, 0, {}, {}};
+  } // for
+
+  context.add_coloring(INDEX_ID, coloring, coloring_info);
+
+} // specialization_tlt_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+  auto ch = flecsi_get_client_handle(empty_mesh_2d_t, meshes, mesh1);
+
+  const double scalar = 3.0;
+
+  // Time the STREAM kernels over three fields, and return the best
+  // bandwidth of each, in bytes per second.
+  auto run = [&](auto a, auto b, auto c) {
+    flecsi_execute_task_simple(init_task, index, a, b, c);
+
+    std::vector<double> best(4, 0.0);
+    auto time = [&](size_t kernel, size_t arrays, auto && launch) {
+      MPI_Barrier(MPI_COMM_WORLD);
+      auto start = std::chrono::steady_clock::now();
+      launch();
+      std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+      const double bytes = arrays * entities * sizeof(double);
+      best[kernel] = std::max(best[kernel], bytes / elapsed.count());
+    };
+
+    for(size_t r = 0; r < repeats; ++r) {
+      time(0, 2, [&]() { flecsi_execute_task_simple(copy_task, index, c, a); });
+      time(1, 2, [&]() {
+        flecsi_execute_task_simple(scale_task, index, b, c, scalar);
+      });
+      time(2, 3, [&]() {
+        flecsi_execute_task_simple(add_task, index, c, a, b);
+      });
+      time(3, 3, [&]() {
+        flecsi_execute_task_simple(triad_task, index, a, b, c, scalar);
+      });
+    } // for
+
+    flecsi_execute_task_simple(check_task, index, a, b, c, scalar);
+
+    return best;
+  };
+
+  const auto serial = run(
+    flecsi_get_handle(ch, name_space, a, double, dense, 0),
+    flecsi_get_handle(ch, name_space, b, double, dense, 0),
+    flecsi_get_handle(ch, name_space, c, double, dense, 0));
+  const auto first_touch = run(
+    flecsi_get_handle(ch, name_space, ft_a, double, dense, 0),
+    flecsi_get_handle(ch, name_space, ft_b, double, dense, 0),
+    flecsi_get_handle(ch, name_space, ft_c, double, dense, 0));
+
+  if(context_t::instance().color() == 0) {
+    const char * kernels[] = {"copy", "scale", "add", "triad"};
+
+    std::cout << "best bandwidth per rank (GB/s): default, first touch"
+              << std::endl;
+    for(size_t k = 0; k < 4; ++k) {
+      std::cout << "  " << kernels[k] << ": " << serial[k] * 1.e-9 << ", "
+                << first_touch[k] * 1.e-9 << std::endl;
+    } // for
+  } // if
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(stream, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
+
+// The kernels use the static partition of the first touch.
+
+void
+init_task(field_t<wo> a, field_t<wo> b, field_t<wo> c) {
+#pragma omp parallel for schedule(static)
+  for(size_t i = 0; i < a.exclusive_size(); ++i) {
+    a.exclusive(i) = 1.0;
+    b.exclusive(i) = 2.0;
+    c.exclusive(i) = 0.0;
+  } // for
+} // init_task
+
+void
+copy_task(field_t<wo> c, field_t<ro> a) {
+#pragma omp parallel for schedule(static)
+  for(size_t i = 0; i < c.exclusive_size(); ++i) {
+    c.exclusive(i) = a.exclusive(i);
+  } // for
+} // copy_task
+
+void
+scale_task(field_t<wo> b, field_t<ro> c, double scalar) {
+#pragma omp parallel for schedule(static)
+  for(size_t i = 0; i < b.exclusive_size(); ++i) {
+    b.exclusive(i) = scalar * c.exclusive(i);
+  } // for
+} // scale_task
+
+void
+add_task(field_t<wo> c, field_t<ro> a, field_t<ro> b) {
+#pragma omp parallel for schedule(static)
+  for(size_t i = 0; i < c.exclusive_size(); ++i) {
+    c.exclusive(i) = a.exclusive(i) + b.exclusive(i);
+  } // for
+} // add_task
+
+void
+triad_task(field_t<wo> a, field_t<ro> b, field_t<ro> c, double scalar) {
+#pragma omp parallel for schedule(static)
+  for(size_t i = 0; i < a.exclusive_size(); ++i) {
+    a.exclusive(i) = b.exclusive(i) + scalar * c.exclusive(i);
+  } // for
+} // triad_task
+
+void
+check_task(field_t<ro> a, field_t<ro> b, field_t<ro> c, double scalar) {
+  // The values of the STREAM iterations, which are exact.
+  double ea = 1.0, eb = 2.0, ec = 0.0;
+  for(size_t r = 0; r < repeats; ++r) {
+    ec = ea;
+    eb = scalar * ec;
+    ec = ea + eb;
+    ea = eb + scalar * ec;
+  } // for
+
+  for(size_t i = 0; i < a.exclusive_size(); ++i) {
+    ASSERT_EQ(a.exclusive(i), ea);
+    ASSERT_EQ(b.exclusive(i), eb);
+    ASSERT_EQ(c.exclusive(i), ec);
+  } // for
+} // check_task
@@ -0,0 +1,171 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+//----------------------------------------------------------------------------//
+//! @file
+//! @date Initial file creation: Oct 19, 2026
+//----------------------------------------------------------------------------//
+
+#include <chrono>
+#include <iostream>
+
+#include <cinchlog.h>
+#include <cinchtest.h>
+
+#include <flecsi/control/runtime.h>
+#include <flecsi/data/data.h>
+#include <flecsi/execution/execution.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/empty_mesh_2d.h>
+
+#define INDEX_ID 0
+#define VERSIONS 1
+
+using namespace flecsi;
+using namespace supplemental;
+
+void set_task(dense_accessor<size_t, wo, wo, na> f, size_t value);
+flecsi_register_task_simple(set_task, loc, index);
+
+void increment_task(dense_accessor<size_t, rw, rw, ro> f);
+flecsi_register_task_simple(increment_task, loc, index);
+
+void copy_task(dense_accessor<size_t, ro, ro, ro> from,
+  dense_accessor<size_t, wo, wo, na> to);
+flecsi_register_task_simple(copy_task, loc, index);
+
+void check_task(dense_accessor<size_t, ro, ro, ro> f, size_t value);
+flecsi_register_task_simple(check_task, loc, index);
+
+flecsi_register_data_client(empty_mesh_2d_t, meshes, mesh1);
+
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  f0,
+  size_t,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+flecsi_register_field(empty_mesh_2d_t,
+  name_space,
+  f1,
+  size_t,
+  dense,
+  VERSIONS,
+  INDEX_ID);
+
+namespace flecsi {
+namespace execution {
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  supplemental::coloring_map_t map;
+  map.vertices = 1;
+  map.cells = 0;
+
+  flecsi_execute_mpi_task(add_colorings, flecsi::supplemental, map);
+
+} // specialization_tlt_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+  auto ch = flecsi_get_client_handle(empty_mesh_2d_t, meshes, mesh1);
+  auto h0 = flecsi_get_handle(ch, name_space, f0, size_t, dense, INDEX_ID);
+  auto h1 = flecsi_get_handle(ch, name_space, f1, size_t, dense, INDEX_ID);
+
+  const size_t steps = 1000;
+
+  // Each step updates f0 and copies it to f1, and checks the values,
+  // including the ghosts. The traces are invalidated halfway, as when
+  // the control model changes, and are then recorded again.
+  auto run = [&](bool trace) {
+    flecsi_execute_task_simple(set_task, index, h0, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    for(size_t step = 1; step <= steps; ++step) {
+      if(trace) {
+        flecsi_begin_trace(0);
+      } // if
+
+      flecsi_execute_task_simple(increment_task, index, h0);
+      flecsi_execute_task_simple(copy_task, index, h0, h1);
+      flecsi_execute_task_simple(check_task, index, h1, step);
+
+      if(trace) {
+        flecsi_end_trace(0);
+      } // if
+
+      if(step == steps / 2) {
+        control::runtime_t::instance().invalidate_traces();
+      } // if
+    } // for
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / steps;
+  };
+
+  const double untraced = run(false);
+  const double traced = run(true);
+
+  if(context_t::instance().color() == 0) {
+    std::cout << "time per step" << std::endl
+              << "  untraced: " << untraced * 1.e6 << " us" << std::endl
+              << "  traced:   " << traced * 1.e6 << " us" << std::endl;
+  } // if
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(task_graph, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
+
+void
+set_task(dense_accessor<size_t, wo, wo, na> f, size_t value) {
+  for(size_t i = 0; i < f.exclusive_size(); ++i)
+    f.exclusive(i) = value;
+  for(size_t i = 0; i < f.shared_size(); ++i)
+    f.shared(i) = value;
+} // set_task
+
+void
+increment_task(dense_accessor<size_t, rw, rw, ro> f) {
+  for(size_t i = 0; i < f.exclusive_size(); ++i)
+    ++f.exclusive(i);
+  for(size_t i = 0; i < f.shared_size(); ++i)
+    ++f.shared(i);
+} // increment_task
+
+void
+copy_task(dense_accessor<size_t, ro, ro, ro> from,
+  dense_accessor<size_t, wo, wo, na> to) {
+  for(size_t i = 0; i < from.exclusive_size(); ++i)
+    to.exclusive(i) = from.exclusive(i);
+  for(size_t i = 0; i < from.shared_size(); ++i)
+    to.shared(i) = from.shared(i);
+} // copy_task
+
+void
+check_task(dense_accessor<size_t, ro, ro, ro> f, size_t value) {
+  for(size_t i = 0; i < f.exclusive_size(); ++i)
+    ASSERT_EQ(f.exclusive(i), value);
+  for(size_t i = 0; i < f.shared_size(); ++i)
+    ASSERT_EQ(f.shared(i), value);
+  for(size_t i = 0; i < f.ghost_size(); ++i)
+    ASSERT_EQ(f.ghost(i), value);
+} // check_task
@@ -0,0 +1,133 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <cinchtest.h>
+
+#include <flecsi/execution/common/instrumentation.h>
+
+using namespace flecsi::execution;
+
+TEST(timeline, buffer) {
+  timeline_buffer_t buffer(4, 3);
+
+  for(int64_t e = 0; e < 6; ++e) {
+    buffer.push(e, e + 1, 10, timeline_kind_t::user);
+  } // for
+
+  // The oldest events have been overwritten.
+  std::vector<timeline_event_t> events;
+  buffer.collect(events);
+
+  ASSERT_EQ(events.size(), 4);
+  for(size_t e = 0; e < 4; ++e) {
+    ASSERT_EQ(events[e].begin, int64_t(e + 2));
+    ASSERT_EQ(events[e].thread, 3);
+  } // for
+} // TEST
+
+TEST(timeline, chrome_trace) {
+  std::vector<std::vector<timeline_event_t>> ranks(2);
+  ranks[0].push_back({1000, 3000, 5, timeline_kind_t::user, 0});
+  ranks[0].push_back({3000, 4500, 5, timeline_kind_t::epilog, 0});
+  ranks[1].push_back({2000, 6000, 0, timeline_kind_t::allreduce, 1});
+
+  std::stringstream trace;
+  timeline_t::write_chrome_trace(trace, ranks, {{5, "advance"}});
+
+  // The events are complete events, in microseconds.
+  const std::string json = trace.str();
+  ASSERT_NE(json.find("\"traceEvents\""), std::string::npos);
+  ASSERT_NE(json.find("\"name\": \"rank 1\""), std::string::npos);
+  ASSERT_NE(json.find("\"name\": \"advance\", \"cat\": \"user\", \"ph\": "
+                      "\"X\", \"ts\": 1, \"dur\": 2, \"pid\": 0"),
+    std::string::npos);
+  ASSERT_NE(json.find("\"name\": \"advance epilog\""), std::string::npos);
+  ASSERT_NE(json.find("\"name\": \"allreduce\""), std::string::npos);
+  ASSERT_NE(json.find("\"pid\": 1, \"tid\": 1"), std::string::npos);
+} // TEST
+
+TEST(timeline, escaped_names) {
+  std::vector<std::vector<timeline_event_t>> ranks(1);
+  ranks[0].push_back({1000, 3000, 7, timeline_kind_t::user, 0});
+
+  std::stringstream trace;
+  timeline_t::write_chrome_trace(trace, ranks, {{7, "a \"b\"\\c\n"}});
+
+  // Quotes, backslashes and control characters are escaped.
+  const std::string json = trace.str();
+  ASSERT_NE(json.find("\"name\": \"a \\\"b\\\"\\\\c\\u000a\""),
+    std::string::npos);
+} // TEST
+
+TEST(timeline, recording) {
+  const std::string filename = "timeline_test.json";
+
+  // Nothing is recorded until the timeline is started.
+  {
+    task_phase_timer_t timer(400, task_phase_t::user);
+  } // scope
+
+  ASSERT_FALSE(timeline_t::enabled());
+
+  timeline_t::instance().start(filename);
+  instrument_task_name(400, "recorded_task");
+
+  // The threads record into their own buffers.
+  std::vector<std::thread> threads;
+  for(size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([]() {
+      for(size_t i = 0; i < 10; ++i) {
+        task_phase_timer_t timer(400, task_phase_t::user);
+      } // for
+    });
+  } // for
+
+  for(auto & thread : threads) {
+    thread.join();
+  } // for
+
+  {
+    reduction_timer_t timer(400);
+    timeline_scope_t scope(timeline_kind_t::checkpoint);
+  } // scope
+
+  report_timeline();
+
+  std::ifstream file(filename);
+  std::stringstream trace;
+  trace << file.rdbuf();
+  std::remove(filename.c_str());
+
+  const std::string json = trace.str();
+  size_t events = 0;
+  std::set<std::string> tids;
+  for(size_t p = json.find("\"ph\": \"X\""); p != std::string::npos;
+      p = json.find("\"ph\": \"X\"", p + 1)) {
+    ++events;
+    const size_t tid = json.find("\"tid\": ", p);
+    tids.insert(json.substr(tid, json.find('}', tid) - tid));
+  } // for
+
+  ASSERT_EQ(events, 42);
+  ASSERT_EQ(tids.size(), 5);
+  ASSERT_NE(json.find("\"name\": \"recorded_task\""), std::string::npos);
+  ASSERT_NE(json.find("\"name\": \"checkpoint\""), std::string::npos);
+} // TEST
@@ -292,8 +292,7 @@ add_colorings(int dummy) {
 
         // Collect all colors with whom we require communication
         // to send shared information.
-        cell_color_info.shared_users =
-          flecsi::utils::set_union(cell_color_info.shared_users, i);
+        cell_color_info.shared_users.insert(i.begin(), i.end());
       }
       else {
         cells.exclusive.insert(flecsi::coloring::entity_info_t(
@@ -343,7 +342,7 @@ add_colorings(int dummy) {
 
   // Assign vertex ownership
   std::vector<std::set<size_t>> vertex_requests(size);
-  std::set<flecsi::coloring::entity_info_t> vertex_info;
+  flecsi::utils::flat_set_u<flecsi::coloring::entity_info_t> vertex_info;
 
   size_t offset(0);
   for(auto i : vertex_closure) {
@@ -416,8 +415,7 @@ add_colorings(int dummy) {
 
       // Collect all colors with whom we require communication
       // to send shared information.
-      vertex_color_info.shared_users =
-        flecsi::utils::set_union(vertex_color_info.shared_users, i.shared);
+      vertex_color_info.shared_users.insert(i.shared.begin(), i.shared.end());
     }
     else {
       vertices.exclusive.insert(i);
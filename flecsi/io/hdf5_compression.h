@@ -0,0 +1,91 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Triad National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <cmath>
+
+#include <hdf5.h>
+
+#include "flecsi/data/common/compression.h"
+
+namespace flecsi {
+namespace io {
+
+/*!
+  The registered identifier of the zstd HDF5 filter plugin.
+ */
+
+constexpr H5Z_filter_t hdf5_zstd_filter = 32015;
+
+/*!
+  Add the filters of a compression to a dataset creation property list,
+  whose dataset must be chunked. Lossless compression shuffles the bytes
+  of the values, so that the bytes of equal significance are adjacent,
+  and then compresses them with zstd if its HDF5 filter plugin is
+  available, and with deflate otherwise. Lossy compression rounds
+  floating-point values to the number of decimal digits that keeps them
+  within the error bound before compressing them, and is lossless for
+  other types.
+ */
+
+inline void
+set_hdf5_compression(hid_t dataset_creation_plist_id,
+  hid_t type,
+  const data::compression_t & compression) {
+  if(compression.mode == data::compression_t::none)
+    return;
+
+  const bool lossy = compression.mode == data::compression_t::lossy &&
+                     H5Tget_class(type) == H5T_FLOAT &&
+                     compression.error_bound > 0.0;
+
+  if(lossy) {
+    // Scaling to D decimal digits has an error of less than 1e-D.
+    const int digits =
+      std::max(0, int(std::ceil(-std::log10(compression.error_bound))));
+    H5Pset_scaleoffset(dataset_creation_plist_id, H5Z_SO_FLOAT_DSCALE, digits);
+  }
+  else if(H5Tget_size(type) > 1) {
+    H5Pset_shuffle(dataset_creation_plist_id);
+  } // if
+
+  const unsigned level = unsigned(std::min(std::max(compression.level, 1), 9));
+  if(H5Zfilter_avail(hdf5_zstd_filter) > 0) {
+    H5Pset_filter(dataset_creation_plist_id, hdf5_zstd_filter,
+      H5Z_FLAG_OPTIONAL, 1, &level);
+  }
+  else {
+    H5Pset_deflate(dataset_creation_plist_id, level);
+  } // if
+} // set_hdf5_compression
+
+/*!
+  Return the compression of a field in checkpoints. Checkpoints are
+  restart files, so lossy compression is only applied to them if
+  lossy_checkpoints is set, and is lossless otherwise.
+ */
+
+inline data::compression_t
+checkpoint_compression(data::compression_t compression,
+  bool lossy_checkpoints) {
+  if(compression.mode == data::compression_t::lossy && !lossy_checkpoints)
+    compression.mode = data::compression_t::lossless;
+  return compression;
+} // checkpoint_compression
+
+} // namespace io
+} // namespace flecsi
@@ -0,0 +1,59 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Triad National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <hdf5.h>
+
+#include "flecsi/data/common/scalar_type.h"
+
+namespace flecsi {
+namespace io {
+
+/*!
+  Return the native HDF5 type of a scalar type. Opaque data are stored
+  as bytes.
+ */
+
+inline hid_t
+hdf5_type(data::scalar_type_t type) {
+  switch(type) {
+    case data::scalar_type_t::int8:
+      return H5T_NATIVE_INT8;
+    case data::scalar_type_t::uint8:
+      return H5T_NATIVE_UINT8;
+    case data::scalar_type_t::int16:
+      return H5T_NATIVE_INT16;
+    case data::scalar_type_t::uint16:
+      return H5T_NATIVE_UINT16;
+    case data::scalar_type_t::int32:
+      return H5T_NATIVE_INT32;
+    case data::scalar_type_t::uint32:
+      return H5T_NATIVE_UINT32;
+    case data::scalar_type_t::int64:
+      return H5T_NATIVE_INT64;
+    case data::scalar_type_t::uint64:
+      return H5T_NATIVE_UINT64;
+    case data::scalar_type_t::float32:
+      return H5T_NATIVE_FLOAT;
+    case data::scalar_type_t::float64:
+      return H5T_NATIVE_DOUBLE;
+    default:
+      return H5T_NATIVE_UCHAR;
+  } // switch
+} // hdf5_type
+
+} // namespace io
+} // namespace flecsi
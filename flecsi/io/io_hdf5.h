@@ -87,6 +87,20 @@ struct io_interface : public IO_POLICY {
     return IO_POLICY::recover_data(
       hdf5_file, launch_space, hdf5_region_vector, attach_flag);
   }
+
+  void checkpoint_data_attached(hdf5_t & hdf5_file,
+    launch_space_t launch_space,
+    std::vector<hdf5_region_t> & hdf5_region_vector) {
+    return IO_POLICY::checkpoint_data_attached(
+      hdf5_file, launch_space, hdf5_region_vector);
+  }
+
+  void recover_data_attached(hdf5_t & hdf5_file,
+    launch_space_t launch_space,
+    std::vector<hdf5_region_t> & hdf5_region_vector) {
+    return IO_POLICY::recover_data_attached(
+      hdf5_file, launch_space, hdf5_region_vector);
+  }
 }; // struct io_interface
 
 //----------------------------------------------------------------------------//
@@ -16,6 +16,8 @@
 /*!  @file */
 
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <hdf5.h>
 #include <legion.h>
@@ -28,8 +30,11 @@
 
 #include <cinchlog.h>
 
+#include "flecsi/execution/common/timeline.h"
 #include "flecsi/execution/context.h"
 #include "flecsi/execution/legion/internal_task.h"
+#include "flecsi/io/hdf5_compression.h"
+#include "flecsi/io/hdf5_type.h"
 #include "flecsi/utils/serialize.h"
 
 clog_register_tag(io);
@@ -58,7 +63,162 @@ inline void recover_without_attach_task(const Legion::Task * task,
   Legion::Runtime * runtime);
 
 /*----------------------------------------------------------------------------*
-  HDF5 descriptor of one logical region, not called by users.
+  Field information of a Legion field, not called by users.
+ *----------------------------------------------------------------------------*/
+inline const execution::context_t::field_info_t *
+legion_hdf5_field_info(Legion::FieldID fid) {
+  for(const auto & fi : execution::context_t::instance().registered_fields()) {
+    if(fi.fid == fid)
+      return &fi;
+  }
+  return nullptr;
+} // legion_hdf5_field_info
+
+/*----------------------------------------------------------------------------*
+  Ragged and sparse fields hold pointers to their entries, so that they
+  cannot be attached and are stored in their serialized form.
+ *----------------------------------------------------------------------------*/
+inline bool
+legion_hdf5_is_serialized(Legion::FieldID fid) {
+  const auto * fi = legion_hdf5_field_info(fid);
+  return fi != nullptr && (fi->storage_class == data::ragged ||
+                             fi->storage_class == data::sparse);
+} // legion_hdf5_is_serialized
+
+/*----------------------------------------------------------------------------*
+  HDF5 type of the values of a field, not called by users. Fields that
+  are not registered or that are not built from a single scalar type are
+  stored as bytes. The caller closes the type.
+ *----------------------------------------------------------------------------*/
+inline hid_t
+legion_hdf5_field_type(Legion::FieldID fid, size_t size) {
+  if(legion_hdf5_is_serialized(fid))
+    return H5Tvlen_create(H5T_NATIVE_UCHAR);
+
+  const auto * fi = legion_hdf5_field_info(fid);
+  const size_t scalar_size =
+    fi != nullptr ? data::scalar_type_size(fi->scalar_type) : 0;
+  if(scalar_size == 0 || size % scalar_size != 0) {
+    hsize_t dims[1] = {size};
+    return H5Tarray_create2(H5T_NATIVE_UCHAR, 1, dims);
+  }
+  if(size == scalar_size)
+    return H5Tcopy(hdf5_type(fi->scalar_type));
+  hsize_t dims[1] = {size / scalar_size};
+  return H5Tarray_create2(hdf5_type(fi->scalar_type), 1, dims);
+} // legion_hdf5_field_type
+
+/*----------------------------------------------------------------------------*
+  Write the values of one field of a mapped region to its dataset, not
+  called by users.
+ *----------------------------------------------------------------------------*/
+inline void
+legion_hdf5_write_field(hid_t file_id,
+  const char * dataset_name,
+  const Legion::PhysicalRegion & region,
+  Legion::FieldID fid,
+  const Legion::Rect<1> & rect,
+  size_t field_size) {
+  hid_t dataset_id = H5Dopen2(file_id, dataset_name, H5P_DEFAULT);
+  if(dataset_id < 0) {
+    std::ostringstream os;
+    os << "H5Dopen2 failed: " << dataset_id;
+    clog_error(os.str());
+    H5Fclose(file_id);
+    assert(0);
+  }
+
+  if(!rect.empty()) {
+    const Legion::FieldAccessor<READ_ONLY, char, 1, Legion::coord_t,
+      Realm::AffineAccessor<char, 1, Legion::coord_t>>
+      acc_fid(region, fid, field_size);
+    const char * field_data = acc_fid.ptr(rect.lo);
+    hid_t type_id = legion_hdf5_field_type(fid, field_size);
+
+    if(legion_hdf5_is_serialized(fid)) {
+      const auto * serdez = execution::context_t::instance().get_serdez(fid);
+      assert(serdez);
+      const size_t count = rect.volume();
+      std::vector<size_t> offsets(count + 1, 0);
+      for(size_t i = 0; i < count; ++i) {
+        offsets[i + 1] =
+          offsets[i] + serdez->serialized_size(field_data + i * field_size);
+      } // for
+
+      std::vector<unsigned char> buffer(offsets[count]);
+      std::vector<hvl_t> rows(count);
+      for(size_t i = 0; i < count; ++i) {
+        serdez->serialize(field_data + i * field_size, &buffer[offsets[i]]);
+        rows[i].len = offsets[i + 1] - offsets[i];
+        rows[i].p = &buffer[offsets[i]];
+      } // for
+      H5Dwrite(dataset_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, rows.data());
+    }
+    else {
+      H5Dwrite(dataset_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, field_data);
+    } // if
+
+    H5Tclose(type_id);
+  } // if
+
+  H5Dclose(dataset_id);
+} // legion_hdf5_write_field
+
+/*----------------------------------------------------------------------------*
+  Read the values of one field of a mapped region from its dataset, not
+  called by users.
+ *----------------------------------------------------------------------------*/
+inline void
+legion_hdf5_read_field(hid_t file_id,
+  const char * dataset_name,
+  const Legion::PhysicalRegion & region,
+  Legion::FieldID fid,
+  const Legion::Rect<1> & rect,
+  size_t field_size) {
+  hid_t dataset_id = H5Dopen2(file_id, dataset_name, H5P_DEFAULT);
+  if(dataset_id < 0) {
+    std::ostringstream os;
+    os << "H5Dopen2 failed: " << dataset_id;
+    clog_error(os.str());
+    H5Fclose(file_id);
+    assert(0);
+  }
+
+  if(!rect.empty()) {
+    const Legion::FieldAccessor<WRITE_DISCARD, char, 1, Legion::coord_t,
+      Realm::AffineAccessor<char, 1, Legion::coord_t>>
+      acc_fid(region, fid, field_size);
+    char * field_data = acc_fid.ptr(rect.lo);
+    hid_t type_id = legion_hdf5_field_type(fid, field_size);
+
+    if(legion_hdf5_is_serialized(fid)) {
+      const auto * serdez = execution::context_t::instance().get_serdez(fid);
+      assert(serdez);
+      const size_t count = rect.volume();
+      std::vector<hvl_t> rows(count);
+      H5Dread(dataset_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, rows.data());
+      for(size_t i = 0; i < count; ++i) {
+        serdez->deserialize(field_data + i * field_size, rows[i].p);
+      } // for
+
+      hid_t dataspace_id = H5Dget_space(dataset_id);
+      H5Dvlen_reclaim(type_id, dataspace_id, H5P_DEFAULT, rows.data());
+      H5Sclose(dataspace_id);
+    }
+    else {
+      H5Dread(dataset_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, field_data);
+    } // if
+
+    H5Tclose(type_id);
+  } // if
+
+  H5Dclose(dataset_id);
+} // legion_hdf5_read_field
+
+/*----------------------------------------------------------------------------*
+  HDF5 descriptor of one logical region, not called by users. Regions
+  without a logical partition, such as the region of the global fields,
+  are stored whole in the first file.
  *----------------------------------------------------------------------------*/
 struct legion_hdf5_region_t {
   legion_hdf5_region_t(Legion::LogicalRegion lr,
@@ -325,25 +485,22 @@ struct legion_hdf5_t {
 
     for(legion_hdf5_region_t & lr_it : hdf5_region_vector) {
 
-      hid_t dataspace_id = -1;
-      if(lr_it.logical_region.get_index_space().get_dim() == 1) {
-        Legion::LogicalRegion sub_lr = runtime->get_logical_subregion_by_color(
-          ctx, lr_it.logical_partition, file_idx);
-        Legion::Domain domain =
-          runtime->get_index_space_domain(ctx, sub_lr.get_index_space());
-        hsize_t dims[1];
-        dims[0] = domain.get_volume();
-        dataspace_id = H5Screate_simple(1, dims, NULL);
-      }
-      else {
-        Legion::LogicalRegion sub_lr = runtime->get_logical_subregion_by_color(
+      // Regions that are not partitioned go to the first file.
+      const bool global =
+        lr_it.logical_partition == Legion::LogicalPartition::NO_PART;
+      if(global && file_idx != 0)
+        continue;
+
+      Legion::LogicalRegion sub_lr = lr_it.logical_region;
+      if(!global) {
+        sub_lr = runtime->get_logical_subregion_by_color(
           ctx, lr_it.logical_partition, file_idx);
-        Legion::Domain domain =
-          runtime->get_index_space_domain(ctx, sub_lr.get_index_space());
-        hsize_t dims[1];
-        dims[0] = domain.get_volume();
-        dataspace_id = H5Screate_simple(1, dims, NULL);
       }
+      Legion::Domain domain =
+        runtime->get_index_space_domain(ctx, sub_lr.get_index_space());
+      hsize_t dims[1];
+      dims[0] = domain.get_volume();
+      hid_t dataspace_id = H5Screate_simple(1, dims, NULL);
       if(dataspace_id < 0) {
         std::ostringstream os;
         os << "H5Screate_simple failed: " << dataspace_id;
@@ -351,32 +508,46 @@ struct legion_hdf5_t {
         H5Fclose(hdf5_file_id);
         return false;
       }
-#if 0
-      hid_t group_id = H5Gcreate2(file_id, (*lr_it).logical_region_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-      if (group_id < 0) {
-        printf("H5Gcreate2 failed: %lld\n", (long long)group_id);
-        H5Sclose(dataspace_id);
-        H5Fclose(hdf5_file_id);
-        return false;
-      }
-#endif
       for(std::pair<const Legion::FieldID, std::string> & it :
         lr_it.field_string_map) {
         const char * dataset_name = (it.second).c_str();
-        hid_t dataset = H5Dcreate2(hdf5_file_id, dataset_name, H5T_IEEE_F64LE,
-          dataspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        hid_t type_id = legion_hdf5_field_type(it.first,
+          runtime->get_field_size(
+            ctx, lr_it.logical_region.get_field_space(), it.first));
+
+        // Compressed datasets are chunked, and filtered as they are
+        // written by the tasks that do not attach the file.
+        hid_t dataset_creation_plist_id = H5Pcreate(H5P_DATASET_CREATE);
+        const auto * fi = legion_hdf5_field_info(it.first);
+        if(compressed && fi != nullptr && dims[0] > 0 &&
+           !legion_hdf5_is_serialized(it.first)) {
+          const auto compression = checkpoint_compression(
+            execution::context_t::instance()
+              .field_attribute<data::compression_t>(*fi),
+            lossy_checkpoints);
+          if(compression.mode != data::compression_t::none) {
+            hsize_t chunk[1] = {std::min<hsize_t>(dims[0],
+              std::max<hsize_t>(1, chunk_bytes / H5Tget_size(type_id)))};
+            H5Pset_chunk(dataset_creation_plist_id, 1, chunk);
+            set_hdf5_compression(
+              dataset_creation_plist_id, type_id, compression);
+          }
+        }
+
+        hid_t dataset = H5Dcreate2(hdf5_file_id, dataset_name, type_id,
+          dataspace_id, H5P_DEFAULT, dataset_creation_plist_id, H5P_DEFAULT);
+        H5Pclose(dataset_creation_plist_id);
+        H5Tclose(type_id);
         if(dataset < 0) {
           std::ostringstream os;
           os << "H5Dcreate2 failed: " << dataset;
           clog_error(os.str());
-          //    H5Gclose(group_id);
           H5Sclose(dataspace_id);
           H5Fclose(hdf5_file_id);
           return false;
         }
         H5Dclose(dataset);
       }
-      //   H5Gclose(group_id);
       H5Sclose(dataspace_id);
     }
     H5Fflush(hdf5_file_id, H5F_SCOPE_LOCAL);
@@ -388,6 +559,19 @@ struct legion_hdf5_t {
   int num_files;
   std::vector<legion_hdf5_region_t> hdf5_region_vector;
   std::map<std::string, hid_t> hdf5_group_map;
+
+  // Whether the datasets of fields with a registered compression are
+  // chunked and filtered when they are created. Filtered datasets cannot
+  // be attached, so compressed files are only written and read by the
+  // tasks that do not attach them.
+  bool compressed = false;
+
+  // Whether lossy field compression is applied to the checkpoint, which
+  // is otherwise compressed losslessly, so that restarts are exact.
+  bool lossy_checkpoints = false;
+
+  // The size of the chunks of compressed datasets, in bytes.
+  static constexpr hsize_t chunk_bytes = hsize_t(1) << 20;
 };
 
 /*----------------------------------------------------------------------------*
@@ -411,9 +595,14 @@ struct legion_policy_t {
         runtime->destroy_index_space(ctx, it.second);
       }
     }
+    for(std::pair<const Legion::LogicalRegion, Legion::LogicalRegion> & it :
+      attach_lr_map) {
+      runtime->destroy_logical_region(ctx, it.second);
+    }
     file_is_map.clear();
     file_ip_map.clear();
     file_lp_map.clear();
+    attach_lr_map.clear();
   }
 
   //----------------------------------------------------------------------------//
@@ -502,119 +691,372 @@ struct legion_policy_t {
     Legion::IndexSpace launch_space,
     std::vector<legion_hdf5_region_t> & hdf5_region_vector,
     bool attach_flag) {
-    std::string file_name = hdf5_file.file_name;
-
-    Legion::Runtime * runtime = Legion::Runtime::get_runtime();
-    Legion::Context ctx = Legion::Runtime::get_context();
+    execution::context_t & context_ = execution::context_t::instance();
+    auto task_id = context_.task_id<flecsi_internal_task_key(
+      checkpoint_without_attach_task)>();
 
-    std::vector<std::map<Legion::FieldID, std::string>> field_string_map_vector;
-    for(legion_hdf5_region_t & it : hdf5_region_vector) {
-      field_string_map_vector.push_back(it.field_string_map);
+    {
+      clog_tag_guard(io);
+      clog(info) << "Start checkpoint file " << hdf5_file.file_name
+                 << " regions size " << hdf5_region_vector.size() << std::endl;
     }
 
-    std::vector<std::byte> task_args;
-    task_args = utils::serial_put(std::tie(field_string_map_vector, file_name));
+    clog_assert(!(attach_flag && hdf5_file.compressed),
+      "compressed files cannot be attached");
+
+    if(attach_flag) {
+      std::vector<legion_hdf5_region_t> serialized_region_vector;
+      std::vector<legion_hdf5_region_t> attached_region_vector =
+        split_serialized_fields(hdf5_region_vector, serialized_region_vector);
+      auto attach_task_id = context_.task_id<flecsi_internal_task_key(
+        checkpoint_with_attach_task)>();
+      launch_io_tasks(attach_task_id, hdf5_file.file_name, launch_space,
+        attached_region_vector, true);
+      launch_io_tasks(task_id, hdf5_file.file_name, launch_space,
+        serialized_region_vector, true);
+    }
+    else {
+      launch_io_tasks(task_id, hdf5_file.file_name, launch_space,
+        hdf5_region_vector, true);
+    }
+  } // checkpoint_data
 
+  //----------------------------------------------------------------------------//
+  // Implementation of legion_io_policy_t::recover_data.
+  //----------------------------------------------------------------------------//
+  void recover_data(legion_hdf5_t & hdf5_file,
+    Legion::IndexSpace launch_space,
+    std::vector<legion_hdf5_region_t> & hdf5_region_vector,
+    bool attach_flag) {
     execution::context_t & context_ = execution::context_t::instance();
-
     auto task_id =
-      attach_flag
-        ? context_
-            .task_id<flecsi_internal_task_key(checkpoint_with_attach_task)>()
-        : context_.task_id<flecsi_internal_task_key(
-            checkpoint_without_attach_task)>();
-
-    Legion::IndexLauncher checkpoint_launcher(task_id, launch_space,
-      Legion::TaskArgument((void *)(task_args.data()), task_args.size()),
-      Legion::ArgumentMap());
+      context_.task_id<flecsi_internal_task_key(recover_without_attach_task)>();
 
-    int idx = 0;
-    for(legion_hdf5_region_t & it : hdf5_region_vector) {
-      checkpoint_launcher.add_region_requirement(
-        Legion::RegionRequirement(it.logical_partition, 0 /*projection ID*/,
-          READ_ONLY, EXCLUSIVE, it.logical_region));
+    {
+      clog_tag_guard(io);
+      clog(info) << "Start recover file " << hdf5_file.file_name
+                 << " regions size " << hdf5_region_vector.size() << std::endl;
+    }
 
-      std::map<Legion::FieldID, std::string> & field_string_map =
-        it.field_string_map;
-      for(std::pair<const Legion::FieldID, std::string> & it :
-        field_string_map) {
-        checkpoint_launcher.region_requirements[idx].add_field(it.first);
-      }
-      idx++;
+    clog_assert(!(attach_flag && hdf5_file.compressed),
+      "compressed files cannot be attached");
+
+    if(attach_flag) {
+      std::vector<legion_hdf5_region_t> serialized_region_vector;
+      std::vector<legion_hdf5_region_t> attached_region_vector =
+        split_serialized_fields(hdf5_region_vector, serialized_region_vector);
+      auto attach_task_id =
+        context_.task_id<flecsi_internal_task_key(recover_with_attach_task)>();
+      launch_io_tasks(attach_task_id, hdf5_file.file_name, launch_space,
+        attached_region_vector, false);
+      launch_io_tasks(task_id, hdf5_file.file_name, launch_space,
+        serialized_region_vector, false);
     }
+    else {
+      launch_io_tasks(task_id, hdf5_file.file_name, launch_space,
+        hdf5_region_vector, false);
+    }
+  } // recover_data
 
+  //----------------------------------------------------------------------------//
+  // Implementation of legion_io_policy_t::checkpoint_data_attached.
+  //
+  // Unlike checkpoint_data, the files are attached from the calling task
+  // to regions that are created once and reused by every checkpoint, and
+  // the values of all the colors are copied by a single index copy, so
+  // that the files are written concurrently.
+  //----------------------------------------------------------------------------//
+  void checkpoint_data_attached(legion_hdf5_t & hdf5_file,
+    Legion::IndexSpace launch_space,
+    std::vector<legion_hdf5_region_t> & hdf5_region_vector) {
     {
       clog_tag_guard(io);
-      clog(info) << "Start checkpoint file " << file_name << " regions size "
-                 << hdf5_region_vector.size() << std::endl;
+      clog(info) << "Start attached checkpoint file " << hdf5_file.file_name
+                 << " regions size " << hdf5_region_vector.size() << std::endl;
     }
 
-    Legion::FutureMap fumap =
-      runtime->execute_index_space(ctx, checkpoint_launcher);
-    fumap.wait_all_results();
-  } // checkpoint_data
+    clog_assert(!hdf5_file.compressed, "compressed files cannot be attached");
+
+    std::vector<legion_hdf5_region_t> serialized_region_vector;
+    for(legion_hdf5_region_t & it :
+      split_serialized_fields(hdf5_region_vector, serialized_region_vector)) {
+      copy_attached(hdf5_file.file_name, launch_space, it, true);
+    }
+
+    execution::context_t & context_ = execution::context_t::instance();
+    auto task_id = context_.task_id<flecsi_internal_task_key(
+      checkpoint_without_attach_task)>();
+    launch_io_tasks(task_id, hdf5_file.file_name, launch_space,
+      serialized_region_vector, true);
+  } // checkpoint_data_attached
 
   //----------------------------------------------------------------------------//
-  // Implementation of legion_io_policy_t::recover_data.
+  // Implementation of legion_io_policy_t::recover_data_attached.
   //----------------------------------------------------------------------------//
-  void recover_data(legion_hdf5_t & hdf5_file,
+  void recover_data_attached(legion_hdf5_t & hdf5_file,
     Legion::IndexSpace launch_space,
+    std::vector<legion_hdf5_region_t> & hdf5_region_vector) {
+    {
+      clog_tag_guard(io);
+      clog(info) << "Start attached recover file " << hdf5_file.file_name
+                 << " regions size " << hdf5_region_vector.size() << std::endl;
+    }
+
+    clog_assert(!hdf5_file.compressed, "compressed files cannot be attached");
+
+    std::vector<legion_hdf5_region_t> serialized_region_vector;
+    for(legion_hdf5_region_t & it :
+      split_serialized_fields(hdf5_region_vector, serialized_region_vector)) {
+      copy_attached(hdf5_file.file_name, launch_space, it, false);
+    }
+
+    execution::context_t & context_ = execution::context_t::instance();
+    auto task_id =
+      context_.task_id<flecsi_internal_task_key(recover_without_attach_task)>();
+    launch_io_tasks(task_id, hdf5_file.file_name, launch_space,
+      serialized_region_vector, false);
+  } // recover_data_attached
+
+private:
+  //----------------------------------------------------------------------------//
+  // Move the ragged and sparse fields of the regions to the descriptors
+  // in serialized_region_vector, and return the descriptors of the other
+  // fields.
+  //----------------------------------------------------------------------------//
+  static std::vector<legion_hdf5_region_t> split_serialized_fields(
     std::vector<legion_hdf5_region_t> & hdf5_region_vector,
-    bool attach_flag) {
-    std::string file_name = hdf5_file.file_name;
+    std::vector<legion_hdf5_region_t> & serialized_region_vector) {
+    std::vector<legion_hdf5_region_t> attached_region_vector;
+    for(legion_hdf5_region_t & it : hdf5_region_vector) {
+      legion_hdf5_region_t attached(
+        it.logical_region, it.logical_partition, it.logical_region_name);
+      legion_hdf5_region_t serialized(
+        it.logical_region, it.logical_partition, it.logical_region_name);
+      for(std::pair<const Legion::FieldID, std::string> & f :
+        it.field_string_map) {
+        if(legion_hdf5_is_serialized(f.first))
+          serialized.field_string_map.insert(f);
+        else
+          attached.field_string_map.insert(f);
+      }
+      if(!attached.field_string_map.empty())
+        attached_region_vector.push_back(attached);
+      if(!serialized.field_string_map.empty())
+        serialized_region_vector.push_back(serialized);
+    }
+    return attached_region_vector;
+  } // split_serialized_fields
 
+  //----------------------------------------------------------------------------//
+  // Launch an I/O task on the regions: an index launch with one point per
+  // file for the partitioned regions, and a single task on the first file
+  // for the others.
+  //----------------------------------------------------------------------------//
+  void launch_io_tasks(Legion::TaskID task_id,
+    std::string file_name,
+    Legion::IndexSpace launch_space,
+    std::vector<legion_hdf5_region_t> & hdf5_region_vector,
+    bool checkpoint) {
     Legion::Runtime * runtime = Legion::Runtime::get_runtime();
     Legion::Context ctx = Legion::Runtime::get_context();
 
+    std::vector<legion_hdf5_region_t> partitioned_region_vector;
+    std::vector<legion_hdf5_region_t> global_region_vector;
+    for(legion_hdf5_region_t & it : hdf5_region_vector) {
+      if(it.logical_partition == Legion::LogicalPartition::NO_PART)
+        global_region_vector.push_back(it);
+      else
+        partitioned_region_vector.push_back(it);
+    }
+
+    Legion::FutureMap fumap;
+    Legion::Future fu;
+
+    if(!partitioned_region_vector.empty()) {
+      std::vector<std::byte> task_args =
+        io_task_args(file_name, partitioned_region_vector);
+      Legion::IndexLauncher io_launcher(task_id, launch_space,
+        Legion::TaskArgument((void *)(task_args.data()), task_args.size()),
+        Legion::ArgumentMap());
+      io_launcher.tag = MAPPER_IO_LAUNCH;
+
+      for(legion_hdf5_region_t & it : partitioned_region_vector) {
+        io_launcher.add_region_requirement(
+          Legion::RegionRequirement(it.logical_partition, 0 /*projection ID*/,
+            io_privilege(it, checkpoint), EXCLUSIVE, it.logical_region));
+        for(std::pair<const Legion::FieldID, std::string> & f :
+          it.field_string_map) {
+          io_launcher.region_requirements.back().add_field(f.first);
+        }
+      }
+      fumap = runtime->execute_index_space(ctx, io_launcher);
+    }
+
+    if(!global_region_vector.empty()) {
+      std::vector<std::byte> task_args =
+        io_task_args(file_name, global_region_vector);
+      Legion::TaskLauncher io_launcher(task_id,
+        Legion::TaskArgument((void *)(task_args.data()), task_args.size()));
+
+      for(legion_hdf5_region_t & it : global_region_vector) {
+        io_launcher.add_region_requirement(
+          Legion::RegionRequirement(it.logical_region,
+            io_privilege(it, checkpoint), EXCLUSIVE, it.logical_region));
+        for(std::pair<const Legion::FieldID, std::string> & f :
+          it.field_string_map) {
+          io_launcher.region_requirements.back().add_field(f.first);
+        }
+      }
+      fu = runtime->execute_task(ctx, io_launcher);
+    }
+
+    if(!partitioned_region_vector.empty())
+      fumap.wait_all_results();
+    if(!global_region_vector.empty())
+      fu.wait();
+  } // launch_io_tasks
+
+  //----------------------------------------------------------------------------//
+  // Serialize the arguments of an I/O task.
+  //----------------------------------------------------------------------------//
+  static std::vector<std::byte> io_task_args(std::string file_name,
+    std::vector<legion_hdf5_region_t> & hdf5_region_vector) {
     std::vector<std::map<Legion::FieldID, std::string>> field_string_map_vector;
     for(legion_hdf5_region_t & it : hdf5_region_vector) {
       field_string_map_vector.push_back(it.field_string_map);
     }
+    return utils::serial_put(std::tie(field_string_map_vector, file_name));
+  } // io_task_args
 
-    std::vector<std::byte> task_args;
-    task_args = utils::serial_put(std::tie(field_string_map_vector, file_name));
+  //----------------------------------------------------------------------------//
+  // Privilege of an I/O task on a region. Ragged and sparse fields are
+  // recovered into their existing rows, which must therefore be valid.
+  //----------------------------------------------------------------------------//
+  static Legion::PrivilegeMode io_privilege(
+    legion_hdf5_region_t & hdf5_region,
+    bool checkpoint) {
+    if(checkpoint)
+      return READ_ONLY;
+    for(std::pair<const Legion::FieldID, std::string> & f :
+      hdf5_region.field_string_map) {
+      if(legion_hdf5_is_serialized(f.first))
+        return READ_WRITE;
+    }
+    return WRITE_DISCARD;
+  } // io_privilege
 
-    execution::context_t & context_ = execution::context_t::instance();
+  //----------------------------------------------------------------------------//
+  // Return the region to which the files of a region are attached. It is
+  // created by the first checkpoint or recovery of the region, and reused
+  // by the next ones.
+  //----------------------------------------------------------------------------//
+  Legion::LogicalRegion attach_region(Legion::LogicalRegion lr) {
+    auto it = attach_lr_map.find(lr);
+    if(it == attach_lr_map.end()) {
+      Legion::Runtime * runtime = Legion::Runtime::get_runtime();
+      Legion::Context ctx = Legion::Runtime::get_context();
+      it = attach_lr_map
+             .emplace(lr, runtime->create_logical_region(
+                            ctx, lr.get_index_space(), lr.get_field_space()))
+             .first;
+    }
+    return it->second;
+  } // attach_region
 
-    auto task_id =
-      attach_flag
-        ? context_.task_id<flecsi_internal_task_key(recover_with_attach_task)>()
-        : context_
-            .task_id<flecsi_internal_task_key(recover_without_attach_task)>();
-
-    Legion::IndexLauncher recover_launcher(task_id, launch_space,
-      Legion::TaskArgument((void *)(task_args.data()), task_args.size()),
-      Legion::ArgumentMap());
-    int idx = 0;
-    for(legion_hdf5_region_t & it : hdf5_region_vector) {
-      recover_launcher.add_region_requirement(
-        Legion::RegionRequirement(it.logical_partition, 0 /*projection ID*/,
-          WRITE_DISCARD, EXCLUSIVE, it.logical_region));
+  //----------------------------------------------------------------------------//
+  // Copy a region to or from its files. The file of every color is
+  // attached to the corresponding subregion of the attach region, the
+  // colors are copied by one index copy, and the files are then detached
+  // together.
+  //----------------------------------------------------------------------------//
+  void copy_attached(const std::string & file_name,
+    Legion::IndexSpace launch_space,
+    legion_hdf5_region_t & hdf5_region,
+    bool checkpoint) {
+    Legion::Runtime * runtime = Legion::Runtime::get_runtime();
+    Legion::Context ctx = Legion::Runtime::get_context();
 
-      std::map<Legion::FieldID, std::string> & field_string_map =
-        it.field_string_map;
-      for(std::pair<const Legion::FieldID, std::string> & it :
-        field_string_map) {
-        recover_launcher.region_requirements[idx].add_field(it.first);
+    std::map<Legion::FieldID, const char *> field_map;
+    for(std::pair<const Legion::FieldID, std::string> & f :
+      hdf5_region.field_string_map) {
+      field_map.insert(std::make_pair(f.first, (f.second).c_str()));
+    }
+
+    const bool global =
+      hdf5_region.logical_partition == Legion::LogicalPartition::NO_PART;
+    Legion::LogicalRegion region = hdf5_region.logical_region;
+    Legion::LogicalRegion attach_lr = attach_region(region);
+    std::vector<Legion::PhysicalRegion> attached_prs;
+
+    auto attach = [&](Legion::LogicalRegion lr, int file_idx) {
+      std::string fname = file_name + std::to_string(file_idx);
+      Legion::AttachLauncher hdf5_attach_launcher(
+        EXTERNAL_HDF5_FILE, lr, attach_lr);
+      hdf5_attach_launcher.attach_hdf5(fname.c_str(), field_map,
+        checkpoint ? LEGION_FILE_READ_WRITE : LEGION_FILE_READ_ONLY);
+      attached_prs.push_back(
+        runtime->attach_external_resource(ctx, hdf5_attach_launcher));
+    };
+
+    auto add_fields = [&](auto & copy_launcher) {
+      for(std::pair<const Legion::FieldID, const char *> & f : field_map) {
+        copy_launcher.add_src_field(0, f.first);
+        copy_launcher.add_dst_field(0, f.first);
       }
-      idx++;
+    };
+
+    Legion::LogicalRegion src_lr = checkpoint ? region : attach_lr;
+    Legion::LogicalRegion dst_lr = checkpoint ? attach_lr : region;
+
+    if(global) {
+      attach(attach_lr, 0);
+
+      Legion::CopyLauncher copy_launcher;
+      copy_launcher.add_copy_requirements(
+        Legion::RegionRequirement(src_lr, READ_ONLY, EXCLUSIVE, src_lr),
+        Legion::RegionRequirement(dst_lr, WRITE_DISCARD, EXCLUSIVE, dst_lr));
+      add_fields(copy_launcher);
+      runtime->issue_copy_operation(ctx, copy_launcher);
     }
+    else {
+      Legion::LogicalPartition attach_lp = runtime->get_logical_partition(
+        ctx, attach_lr, hdf5_region.logical_partition.get_index_partition());
+
+      Legion::Domain colors =
+        runtime->get_index_space_domain(ctx, launch_space);
+      for(Legion::Domain::DomainPointIterator c(colors); c; c++) {
+        attach(runtime->get_logical_subregion_by_color(ctx, attach_lp, c.p),
+          c.p.point_data[0]);
+      }
 
-    {
-      clog_tag_guard(io);
-      clog(info) << "Start recover file " << file_name << " regions size "
-                 << hdf5_region_vector.size() << std::endl;
+      Legion::LogicalPartition src_lp =
+        checkpoint ? hdf5_region.logical_partition : attach_lp;
+      Legion::LogicalPartition dst_lp =
+        checkpoint ? attach_lp : hdf5_region.logical_partition;
+
+      Legion::IndexCopyLauncher copy_launcher(launch_space);
+      copy_launcher.add_copy_requirements(
+        Legion::RegionRequirement(
+          src_lp, 0 /*projection ID*/, READ_ONLY, EXCLUSIVE, src_lr),
+        Legion::RegionRequirement(
+          dst_lp, 0 /*projection ID*/, WRITE_DISCARD, EXCLUSIVE, dst_lr));
+      add_fields(copy_launcher);
+      runtime->issue_copy_operation(ctx, copy_launcher);
     }
 
-    Legion::FutureMap fumap =
-      runtime->execute_index_space(ctx, recover_launcher);
-    fumap.wait_all_results();
-  } // recover_data
+    std::vector<Legion::Future> detached;
+    for(Legion::PhysicalRegion & pr : attached_prs) {
+      detached.push_back(runtime->detach_external_resource(ctx, pr, true));
+    }
+    for(Legion::Future & fu : detached) {
+      fu.wait();
+    }
+  } // copy_attached
 
-private:
   std::map<size_t, Legion::IndexSpace> file_is_map;
   std::map<size_t, Legion::IndexPartition> file_ip_map;
   std::map<size_t, Legion::LogicalPartition> file_lp_map;
+  std::map<Legion::LogicalRegion, Legion::LogicalRegion> attach_lr_map;
 
 }; // struct legion_policy_t
 
@@ -624,7 +1066,11 @@ checkpoint_with_attach_task(const Legion::Task * task,
   Legion::Context ctx,
   Legion::Runtime * runtime) {
 
-  const int point = task->index_point.point_data[0];
+  execution::timeline_scope_t scope(execution::timeline_kind_t::checkpoint);
+
+  // Single tasks work on the regions stored in the first file.
+  const int point =
+    task->is_index_space ? int(task->index_point.point_data[0]) : 0;
 
   const std::byte * task_args = (const std::byte *)task->args;
 
@@ -699,7 +1145,11 @@ checkpoint_without_attach_task(const Legion::Task * task,
   Legion::Context ctx,
   Legion::Runtime * runtime) {
 
-  const int point = task->index_point.point_data[0];
+  execution::timeline_scope_t scope(execution::timeline_kind_t::checkpoint);
+
+  // Single tasks work on the regions stored in the first file.
+  const int point =
+    task->is_index_space ? int(task->index_point.point_data[0]) : 0;
 
   const std::byte * task_args = (const std::byte *)task->args;
 
@@ -725,28 +1175,16 @@ checkpoint_without_attach_task(const Legion::Task * task,
 
   for(unsigned int rid = 0; rid < regions.size(); rid++) {
     std::set<Legion::FieldID> field_set = task->regions[rid].privilege_fields;
+    Legion::LogicalRegion lr = task->regions[rid].region;
+    Legion::Rect<1> rect =
+      runtime->get_index_space_domain(ctx, lr.get_index_space());
     std::map<Legion::FieldID, std::string>::iterator map_it;
     for(Legion::FieldID it : field_set) {
       map_it = field_string_map_vector[rid].find(it);
       if(map_it != field_string_map_vector[rid].end()) {
-        const Legion::FieldAccessor<READ_ONLY, double, 1, Legion::coord_t,
-          Realm::AffineAccessor<double, 1, Legion::coord_t>>
-          acc_fid(regions[rid], it);
-        Legion::Rect<1> rect = runtime->get_index_space_domain(
-          ctx, task->regions[rid].region.get_index_space());
-        const double * dset_data = acc_fid.ptr(rect.lo);
-        hid_t dataset_id =
-          H5Dopen2(file_id, (map_it->second).c_str(), H5P_DEFAULT);
-        if(dataset_id < 0) {
-          std::ostringstream os;
-          os << "H5Dopen2 failed: " << dataset_id;
-          clog_error(os.str());
-          H5Fclose(file_id);
-          assert(0);
-        }
-        H5Dwrite(
-          dataset_id, H5T_IEEE_F64LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, dset_data);
-        H5Dclose(dataset_id);
+        legion_hdf5_write_field(file_id, (map_it->second).c_str(),
+          regions[rid], it, rect,
+          runtime->get_field_size(ctx, lr.get_field_space(), it));
       }
       else {
         assert(0);
@@ -772,7 +1210,11 @@ recover_with_attach_task(const Legion::Task * task,
   const std::vector<Legion::PhysicalRegion> & regions,
   Legion::Context ctx,
   Legion::Runtime * runtime) {
-  const int point = task->index_point.point_data[0];
+  execution::timeline_scope_t scope(execution::timeline_kind_t::recover);
+
+  // Single tasks work on the regions stored in the first file.
+  const int point =
+    task->is_index_space ? int(task->index_point.point_data[0]) : 0;
 
   const std::byte * task_args = (const std::byte *)task->args;
 
@@ -846,7 +1288,11 @@ recover_without_attach_task(const Legion::Task * task,
   const std::vector<Legion::PhysicalRegion> & regions,
   Legion::Context ctx,
   Legion::Runtime * runtime) {
-  const int point = task->index_point.point_data[0];
+  execution::timeline_scope_t scope(execution::timeline_kind_t::recover);
+
+  // Single tasks work on the regions stored in the first file.
+  const int point =
+    task->is_index_space ? int(task->index_point.point_data[0]) : 0;
 
   const std::byte * task_args = (const std::byte *)task->args;
 
@@ -872,28 +1318,16 @@ recover_without_attach_task(const Legion::Task * task,
 
   for(unsigned int rid = 0; rid < regions.size(); rid++) {
     std::set<Legion::FieldID> field_set = task->regions[rid].privilege_fields;
+    Legion::LogicalRegion lr = task->regions[rid].region;
+    Legion::Rect<1> rect =
+      runtime->get_index_space_domain(ctx, lr.get_index_space());
     std::map<Legion::FieldID, std::string>::iterator map_it;
     for(Legion::FieldID it : field_set) {
       map_it = field_string_map_vector[rid].find(it);
       if(map_it != field_string_map_vector[rid].end()) {
-        const Legion::FieldAccessor<WRITE_DISCARD, double, 1, Legion::coord_t,
-          Realm::AffineAccessor<double, 1, Legion::coord_t>>
-          acc_fid(regions[rid], it);
-        Legion::Rect<1> rect = runtime->get_index_space_domain(
-          ctx, task->regions[rid].region.get_index_space());
-        double * dset_data = acc_fid.ptr(rect.lo);
-        hid_t dataset_id =
-          H5Dopen2(file_id, (map_it->second).c_str(), H5P_DEFAULT);
-        if(dataset_id < 0) {
-          std::ostringstream os;
-          os << "H5Dopen2 failed: " << dataset_id;
-          clog_error(os.str());
-          H5Fclose(file_id);
-          assert(0);
-        }
-        H5Dread(
-          dataset_id, H5T_IEEE_F64LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, dset_data);
-        H5Dclose(dataset_id);
+        legion_hdf5_read_field(file_id, (map_it->second).c_str(),
+          regions[rid], it, rect,
+          runtime->get_field_size(ctx, lr.get_field_space(), it));
       }
       else {
         assert(0);
@@ -909,6 +1343,8 @@ recover_without_attach_task(const Legion::Task * task,
                  << field_string_map_vector.size() << std::endl;
     }
   }
+
+  H5Fclose(file_id);
 } // recover_without_attach_task
 
 } // namespace io
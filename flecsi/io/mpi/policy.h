@@ -15,24 +15,219 @@
 
 /*!  @file */
 
+#include <algorithm>
 #include <cmath>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
+#include <deque>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <set>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <cinchlog.h>
+#include <fcntl.h>
 #include <hdf5.h>
 #include <mpi.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include "flecsi/coloring/dcrs_utils.h"
 #include "flecsi/data/common/row_vector.h"
 #include "flecsi/data/common/serdez.h"
 #include "flecsi/data/data_constants.h"
+#include "flecsi/execution/common/timeline.h"
 #include "flecsi/execution/context.h"
+#include "flecsi/execution/mpi/task_scheduler.h"
+#include "flecsi/io/hdf5_compression.h"
+#include "flecsi/io/hdf5_type.h"
+
+clog_register_tag(io);
 
 namespace flecsi {
 namespace io {
 
 struct mpi_policy_t {
 
+  /*!
+    A snapshot of the data of one field, or of restart metadata, in the
+    layout in which it is written to the checkpoint file. Synchronous
+    checkpoint fields do not copy dense fields, but write them from their
+    storage, which is then referenced by external.
+
+    The type of the values is kept as a scalar type, so that staging
+    does not call HDF5, which may be busy on the I/O thread.
+   */
+
+  struct staged_field_t {
+    std::string dataset_name;
+    data::scalar_type_t scalar_type;
+    hsize_t count;
+    std::vector<unsigned char> buffer;
+    const void * external = nullptr;
+    std::vector<std::pair<std::string, std::uint64_t>> attributes;
+    data::compression_t compression;
+
+    const void * data() const {
+      return external ? external : buffer.data();
+    } // data
+
+    //! The size in bytes of a value; opaque data are stored as bytes.
+    size_t type_size() const {
+      const size_t size = data::scalar_type_size(scalar_type);
+      return size ? size : 1;
+    } // type_size
+
+    //! The HDF5 type of the values. Only call this where HDF5 may be used.
+    hid_t type() const {
+      return hdf5_type(scalar_type);
+    } // type
+  }; // struct staged_field_t
+
+  /*!
+    A snapshot of all fields that is written to one checkpoint file. An
+    incremental snapshot only holds the fields that were modified since
+    the checkpoint that it is based on.
+   */
+
+  struct staged_checkpoint_t {
+    std::string file_name;
+    std::string base;
+    std::vector<staged_field_t> fields;
+    std::vector<std::pair<std::string, std::uint64_t>> attributes;
+  }; // struct staged_checkpoint_t
+
+  /*!
+    The aggregation of the ranks of a file. The ranks are split into
+    groups of clients, whose data are gathered by the first rank of the
+    group, its aggregator, which takes part in the HDF5 operations on
+    behalf of the group.
+   */
+
+  struct aggregation_t {
+    MPI_Comm clients = MPI_COMM_NULL;
+    MPI_Comm aggregators = MPI_COMM_NULL;
+
+    // The ranks of the clients among the ranks of the file.
+    std::vector<int> ranks;
+  }; // struct aggregation_t
+
+  /*!
+    A block of a dataset, i.e., its offset and number of elements.
+   */
+
+  using block_t = std::pair<hsize_t, hsize_t>;
+
+  /*!
+    State of the I/O thread that drains asynchronous checkpoints. At
+    most two snapshots exist at any time: the one being written, and
+    one waiting for it. The storage of written snapshots is reused.
+   */
+
+  struct async_state_t {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<staged_checkpoint_t> queue;
+    staged_checkpoint_t spare;
+    bool busy = false;
+    bool done = false;
+    bool threaded = false;
+    MPI_Comm comm = MPI_COMM_NULL;
+    aggregation_t aggregation;
+  }; // struct async_state_t
+
+  /*!
+    A file of the local checkpoint tier, memory-mapped for writing when
+    it is created, or for reading when it is opened. The file is
+    unmapped and closed on destruction.
+   */
+
+  struct local_mapping_t {
+    unsigned char * data = nullptr;
+    size_t size = 0;
+    int fd = -1;
+
+    local_mapping_t() = default;
+    local_mapping_t(const local_mapping_t &) = delete;
+    local_mapping_t & operator=(const local_mapping_t &) = delete;
+
+    ~local_mapping_t() {
+      if(data != nullptr)
+        munmap(data, size);
+      if(fd >= 0)
+        close(fd);
+    } // ~local_mapping_t
+
+    bool create(const std::string & path, size_t bytes) {
+      fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+      if(fd < 0 || ftruncate(fd, off_t(bytes)) != 0)
+        return false;
+      return map(bytes, PROT_READ | PROT_WRITE, MAP_SHARED);
+    } // create
+
+    bool open_file(const std::string & path) {
+      struct stat st;
+      fd = open(path.c_str(), O_RDONLY);
+      if(fd < 0 || fstat(fd, &st) != 0)
+        return false;
+      return map(size_t(st.st_size), PROT_READ, MAP_PRIVATE);
+    } // open_file
+
+  private:
+    bool map(size_t bytes, int protection, int flags) {
+      size = bytes;
+      if(size == 0)
+        return true;
+      void * p = mmap(nullptr, size, protection, flags, fd, 0);
+      if(p == MAP_FAILED)
+        return false;
+      data = static_cast<unsigned char *>(p);
+      return true;
+    } // map
+  }; // struct local_mapping_t
+
+  /*!
+    The header of a file of the local checkpoint tier. It is followed by
+    one record per field, whose data are padded to eight bytes. The file
+    is complete once its last write has been mapped.
+   */
+
+  struct local_header_t {
+    char magic[8];
+    std::uint64_t version;
+    std::uint64_t world_size;
+    std::uint64_t rank;
+    std::uint64_t num_fields;
+    std::uint64_t bytes;
+    std::uint64_t complete;
+  }; // struct local_header_t
+
+  struct local_record_t {
+    std::uint64_t fid;
+    std::uint64_t storage_class;
+    std::uint64_t bytes;
+  }; // struct local_record_t
+
+  mpi_policy_t() {}
+
+  mpi_policy_t(const mpi_policy_t &) = delete;
+  mpi_policy_t & operator=(const mpi_policy_t &) = delete;
+
+  ~mpi_policy_t() {
+    stop_async();
+    free_aggregation(aggregation_);
+  } // ~mpi_policy_t
+
   bool create_hdf5_file(hid_t & hdf5_file_id,
     const std::string & file_name,
     MPI_Comm mpi_hdf5_comm) {
@@ -129,8 +324,10 @@ struct mpi_policy_t {
 
   bool create_hdf5_dataset(const hid_t hdf5_file_id,
     const std::string & dataset_name,
-    int buffer_size,
-    MPI_Comm mpi_hdf5_comm) {
+    hid_t type,
+    hsize_t buffer_size,
+    MPI_Comm mpi_hdf5_comm,
+    const data::compression_t & compression = {}) {
     int rank;
     MPI_Comm_rank(mpi_hdf5_comm, &rank);
 
@@ -145,19 +342,35 @@ struct mpi_policy_t {
     // arg 3 and arg 4 as err(max moves to arg 5).
     hid_t file_dataspace_id = H5Screate_simple(ndims, dims, NULL);
 
-    // Creates a new dataset and links to file
-    hid_t link_creation_plist_id = H5P_DEFAULT; // Link creation property list
-    hid_t dataset_creation_plist_id =
-      H5P_DEFAULT; // Dataset creation property list
+    // The groups of the index spaces are created with their datasets.
+    hid_t link_creation_plist_id = H5Pcreate(H5P_LINK_CREATE);
+    H5Pset_create_intermediate_group(link_creation_plist_id, 1);
+
+    // Datasets are chunked, and chunks that are not written are not
+    // filled, so that the file only holds the data that were written.
+    // Compressed chunks are filtered as they are written.
+    hid_t dataset_creation_plist_id = H5Pcreate(H5P_DATASET_CREATE);
+    if(buffer_size > 0) {
+      hsize_t chunk[ndims];
+      chunk[0] = std::min(buffer_size,
+        std::max<hsize_t>(1, chunk_bytes / H5Tget_size(type)));
+      H5Pset_chunk(dataset_creation_plist_id, ndims, chunk);
+      H5Pset_fill_time(dataset_creation_plist_id, H5D_FILL_TIME_NEVER);
+      set_hdf5_compression(dataset_creation_plist_id, type, compression);
+    } // if
+
     hid_t dataset_access_plist_id = H5P_DEFAULT; // Dataset access property list
     hid_t dataset_id = H5Dcreate2(hdf5_file_id, // Arg 1: location identifier
       dataset_name.c_str(), // Arg 2: dataset name
-      H5T_NATIVE_B32, // Arg 3: datatype identifier
+      type, // Arg 3: datatype identifier
       file_dataspace_id, // Arg 4: dataspace identifier
       link_creation_plist_id, // Arg 5: link creation property list
       dataset_creation_plist_id, // Arg 6: dataset creation property list
       dataset_access_plist_id); // Arg 7: dataset access property list
 
+    H5Pclose(link_creation_plist_id);
+    H5Pclose(dataset_creation_plist_id);
+
     if(dataset_id < 0 && rank == 0) {
       std::cout << " H5Dcreate2 failed: " << dataset_id << std::endl;
       H5Sclose(file_dataspace_id);
@@ -177,13 +390,31 @@ struct mpi_policy_t {
 
   bool write_data_to_hdf5(const hid_t & hdf5_file_id,
     const std::string & dataset_name,
+    hid_t type,
     const void * buffer,
-    int nsize,
-    int displ,
+    hsize_t nsize,
+    hsize_t displ,
     MPI_Comm mpi_hdf5_comm,
-    const int * offset_buf = nullptr) {
-    int rank;
+    const std::uint64_t * offset_buf = nullptr) {
+    return write_data_to_hdf5(hdf5_file_id, dataset_name, type, buffer,
+      std::vector<block_t>{{displ, nsize}}, mpi_hdf5_comm, offset_buf);
+  }
+
+  /*!
+    Write the blocks of a dataset, whose elements are contiguous in the
+    buffer.
+   */
+
+  bool write_data_to_hdf5(const hid_t & hdf5_file_id,
+    const std::string & dataset_name,
+    hid_t type,
+    const void * buffer,
+    const std::vector<block_t> & blocks,
+    MPI_Comm mpi_hdf5_comm,
+    const std::uint64_t * offset_buf = nullptr) {
+    int rank, size;
     MPI_Comm_rank(mpi_hdf5_comm, &rank);
+    MPI_Comm_size(mpi_hdf5_comm, &size);
 
     hid_t data_access_plist_id = H5P_DEFAULT;
     hid_t dataset_id =
@@ -194,19 +425,8 @@ struct mpi_policy_t {
       return false;
     }
 
-    const int ndims = 1;
-    hsize_t count[1];
-    hsize_t offset[1];
-    count[0] = nsize;
-    offset[0] = displ;
-    hid_t mem_dataspace_id = H5Screate_simple(ndims, count, NULL);
-
-    /*
-     * Select hyperslab in the file.
-     */
-    hid_t file_dataspace_id = H5Dget_space(dataset_id);
-    H5Sselect_hyperslab(
-      file_dataspace_id, H5S_SELECT_SET, offset, NULL, count, NULL);
+    hid_t mem_dataspace_id, file_dataspace_id;
+    select_hyperslab(dataset_id, blocks, mem_dataspace_id, file_dataspace_id);
 
     // Create property list for collective dataset write.
     hid_t xfer_plist_id = H5Pcreate(H5P_DATASET_XFER);
@@ -217,23 +437,27 @@ struct mpi_policy_t {
 
     if(offset_buf) {
       herr_t status;
-      hsize_t dims[1] = {static_cast<hsize_t>(new_world_size + 1)};
+      hsize_t dims[1] = {static_cast<hsize_t>(size + 1)};
       hid_t attribute_space_id = H5Screate_simple(1, dims, NULL);
-      hid_t attribute_id = H5Acreate(dataset_id, "offsets", H5T_NATIVE_B32,
+      hid_t attribute_id = H5Acreate(dataset_id, "offsets", H5T_NATIVE_UINT64,
         attribute_space_id, H5P_DEFAULT, H5P_DEFAULT);
 
-      status = H5Awrite(attribute_id, H5T_NATIVE_B32, offset_buf);
+      status = H5Awrite(attribute_id, H5T_NATIVE_UINT64, offset_buf);
       assert(status == 0);
       status = H5Aclose(attribute_id);
       assert(status == 0);
+      status = H5Sclose(attribute_space_id);
+      assert(status == 0);
     }
 
     herr_t status;
-    status = H5Dwrite(dataset_id, H5T_NATIVE_B32, mem_dataspace_id,
-      file_dataspace_id, xfer_plist_id, buffer);
+    status = H5Dwrite(dataset_id, type, mem_dataspace_id, file_dataspace_id,
+      xfer_plist_id, buffer);
     assert(status == 0);
     status = H5Pclose(xfer_plist_id);
     assert(status == 0);
+    H5Sclose(mem_dataspace_id);
+    H5Sclose(file_dataspace_id);
     status = H5Dclose(dataset_id);
     assert(status == 0);
     return true;
@@ -241,9 +465,24 @@ struct mpi_policy_t {
 
   bool read_data_from_hdf5(const hid_t & hdf5_file_id,
     const std::string & dataset_name,
+    hid_t type,
+    void * buffer,
+    hsize_t nsize,
+    hsize_t displ,
+    MPI_Comm mpi_hdf5_comm) {
+    return read_data_from_hdf5(hdf5_file_id, dataset_name, type, buffer,
+      std::vector<block_t>{{displ, nsize}}, mpi_hdf5_comm);
+  }
+
+  /*!
+    Read the blocks of a dataset contiguously into the buffer.
+   */
+
+  bool read_data_from_hdf5(const hid_t & hdf5_file_id,
+    const std::string & dataset_name,
+    hid_t type,
     void * buffer,
-    int nsize,
-    int displ,
+    const std::vector<block_t> & blocks,
     MPI_Comm mpi_hdf5_comm) {
     int rank;
     MPI_Comm_rank(mpi_hdf5_comm, &rank);
@@ -257,36 +496,200 @@ struct mpi_policy_t {
       return false;
     }
 
-    const int ndims = 1;
-    hsize_t count[1];
-    hsize_t offset[1];
-    count[0] = nsize;
-    offset[0] = displ;
-    hid_t mem_dataspace_id = H5Screate_simple(ndims, count, NULL);
-
-    /*
-     * Select hyperslab in the file.
-     */
-    hid_t file_dataspace_id = H5Dget_space(dataset_id);
-    H5Sselect_hyperslab(
-      file_dataspace_id, H5S_SELECT_SET, offset, NULL, count, NULL);
+    hid_t mem_dataspace_id, file_dataspace_id;
+    select_hyperslab(dataset_id, blocks, mem_dataspace_id, file_dataspace_id);
 
     // Create property list for collective dataset write.
     hid_t xfer_plist_id = H5Pcreate(H5P_DATASET_XFER);
     H5Pset_dxpl_mpio(xfer_plist_id, H5FD_MPIO_COLLECTIVE);
 
     herr_t status;
-    status = H5Dread(dataset_id, H5T_NATIVE_B32, mem_dataspace_id,
-      file_dataspace_id, xfer_plist_id, buffer);
+    status = H5Dread(dataset_id, type, mem_dataspace_id, file_dataspace_id,
+      xfer_plist_id, buffer);
     assert(status == 0);
     status = H5Pclose(xfer_plist_id);
     assert(status == 0);
+    H5Sclose(mem_dataspace_id);
+    H5Sclose(file_dataspace_id);
     H5Dclose(dataset_id);
     assert(status == 0);
     return true;
   }
 
+  /*!
+    Select the blocks of a dataset, which must be in increasing order
+    and must not overlap, and a matching memory dataspace. Ranks without
+    data select nothing, so that they can still take part in collective
+    operations.
+   */
+
+  void select_hyperslab(hid_t dataset_id,
+    const std::vector<block_t> & blocks,
+    hid_t & mem_dataspace_id,
+    hid_t & file_dataspace_id) {
+    const int ndims = 1;
+    hsize_t nsize[1] = {0};
+    for(const auto & block : blocks) {
+      nsize[0] += block.second;
+    } // for
+    mem_dataspace_id = H5Screate_simple(ndims, nsize, NULL);
+
+    /*
+     * Select hyperslab in the file.
+     */
+    file_dataspace_id = H5Dget_space(dataset_id);
+    H5Sselect_none(file_dataspace_id);
+    if(nsize[0] == 0) {
+      H5Sselect_none(mem_dataspace_id);
+    } // if
+
+    for(const auto & block : blocks) {
+      if(block.second == 0)
+        continue;
+      hsize_t offset[1] = {block.first};
+      hsize_t count[1] = {block.second};
+      H5Sselect_hyperslab(
+        file_dataspace_id, H5S_SELECT_OR, offset, NULL, count, NULL);
+    } // for
+  } // select_hyperslab
+
+  /*!
+    Write an integer attribute of an object of a file.
+
+    @param object_name The path of the object, e.g., "." for the root
+                       group.
+   */
+
+  void write_attribute(const hid_t hdf5_file_id,
+    const std::string & object_name,
+    const std::string & attribute_name,
+    std::uint64_t value) {
+    hid_t attribute_space_id = H5Screate(H5S_SCALAR);
+    hid_t attribute_id = H5Acreate_by_name(hdf5_file_id, object_name.c_str(),
+      attribute_name.c_str(), H5T_NATIVE_UINT64, attribute_space_id,
+      H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    assert(attribute_id >= 0);
+
+    herr_t status;
+    status = H5Awrite(attribute_id, H5T_NATIVE_UINT64, &value);
+    assert(status == 0);
+    status = H5Aclose(attribute_id);
+    assert(status == 0);
+    status = H5Sclose(attribute_space_id);
+    assert(status == 0);
+  } // write_attribute
+
+  /*!
+    Write an array of integers as an attribute of an object of a file.
+   */
+
+  void write_attribute(const hid_t hdf5_file_id,
+    const std::string & object_name,
+    const std::string & attribute_name,
+    const std::vector<std::uint64_t> & values) {
+    hsize_t dims[1] = {values.size()};
+    hid_t attribute_space_id = H5Screate_simple(1, dims, NULL);
+    hid_t attribute_id = H5Acreate_by_name(hdf5_file_id, object_name.c_str(),
+      attribute_name.c_str(), H5T_NATIVE_UINT64, attribute_space_id,
+      H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    assert(attribute_id >= 0);
+
+    herr_t status;
+    status = H5Awrite(attribute_id, H5T_NATIVE_UINT64, values.data());
+    assert(status == 0);
+    status = H5Aclose(attribute_id);
+    assert(status == 0);
+    status = H5Sclose(attribute_space_id);
+    assert(status == 0);
+  } // write_attribute
+
+  /*!
+    Write a string attribute of an object of a file.
+   */
+
+  void write_attribute(const hid_t hdf5_file_id,
+    const std::string & object_name,
+    const std::string & attribute_name,
+    const std::string & value) {
+    hid_t type = H5Tcopy(H5T_C_S1);
+    H5Tset_size(type, std::max<size_t>(1, value.size()));
+    hid_t attribute_space_id = H5Screate(H5S_SCALAR);
+    hid_t attribute_id = H5Acreate_by_name(hdf5_file_id, object_name.c_str(),
+      attribute_name.c_str(), type, attribute_space_id, H5P_DEFAULT,
+      H5P_DEFAULT, H5P_DEFAULT);
+    assert(attribute_id >= 0);
+
+    herr_t status;
+    status = H5Awrite(attribute_id, type, value.c_str());
+    assert(status == 0);
+    status = H5Aclose(attribute_id);
+    assert(status == 0);
+    H5Sclose(attribute_space_id);
+    H5Tclose(type);
+  } // write_attribute
+
+  /*!
+    Read a string attribute of an object of a file.
+   */
+
+  std::string read_string_attribute(const hid_t hdf5_file_id,
+    const std::string & object_name,
+    const std::string & attribute_name) {
+    hid_t attribute_id = H5Aopen_by_name(hdf5_file_id, object_name.c_str(),
+      attribute_name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+    clog_assert(attribute_id >= 0, object_name << " has no attribute "
+                                               << attribute_name);
+
+    hid_t type = H5Aget_type(attribute_id);
+    std::string value(H5Tget_size(type), '\0');
+    herr_t status;
+    status = H5Aread(attribute_id, type, &value[0]);
+    assert(status == 0);
+    H5Tclose(type);
+    status = H5Aclose(attribute_id);
+    assert(status == 0);
+    return value.substr(0, value.find('\0'));
+  } // read_string_attribute
+
+  /*!
+    Read an integer attribute of an object of a file.
+   */
+
+  std::uint64_t read_attribute(const hid_t hdf5_file_id,
+    const std::string & object_name,
+    const std::string & attribute_name) {
+    hid_t attribute_id = H5Aopen_by_name(hdf5_file_id, object_name.c_str(),
+      attribute_name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+    clog_assert(attribute_id >= 0, object_name << " has no attribute "
+                                               << attribute_name);
+
+    std::uint64_t value;
+    herr_t status;
+    status = H5Aread(attribute_id, H5T_NATIVE_UINT64, &value);
+    assert(status == 0);
+    status = H5Aclose(attribute_id);
+    assert(status == 0);
+    return value;
+  } // read_attribute
+
   void create_hdf5_comm() {
+    if(mpi_hdf5_comm != MPI_COMM_NULL) {
+      if(hdf5_comm_ranks_per_file == ranks_per_file &&
+         hdf5_comm_ranks_per_aggregator == ranks_per_aggregator)
+        return;
+
+      // The I/O thread uses a copy of the old communicators.
+      stop_async();
+      free_aggregation(aggregation_);
+      MPI_Comm_free(&mpi_hdf5_comm);
+    } // if
+
+    hdf5_comm_ranks_per_file = ranks_per_file;
+    hdf5_comm_ranks_per_aggregator = ranks_per_aggregator;
+
+    // Incremental checkpoints must use the same files as their bases.
+    last_checkpoint_.clear();
+
     MPI_Comm_size(MPI_COMM_WORLD, &world_size);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
@@ -301,135 +704,424 @@ struct mpi_policy_t {
 
     MPI_Comm_size(new_comm, &new_world_size);
     MPI_Comm_rank(new_comm, &new_rank);
-  }
-
-  void checkpoint_field(const hid_t hdf5_file_id,
-    const std::string & field_name,
-    const void * buffer,
-    const int size) {
-    // TODO:  do these calcs only once per index space
-    int nsize = std::ceil(((double)size) / sizeof(std::uint32_t));
-    int sum_nsize;
-    MPI_Allreduce(&nsize, &sum_nsize, 1, MPI_INT, MPI_SUM, mpi_hdf5_comm);
-    int displ;
-    MPI_Exscan(&nsize, &displ, 1, MPI_INT, MPI_SUM, mpi_hdf5_comm);
-    if(new_rank == 0)
-      displ = 0;
 
-    bool return_val = false;
+    aggregation_ = create_aggregation(mpi_hdf5_comm);
+  }
 
-    return_val = create_hdf5_dataset(
-      hdf5_file_id, field_name.data(), sum_nsize, mpi_hdf5_comm);
-    assert(return_val);
+  /*!
+    Split the ranks of a file into groups of ranks_per_aggregator
+    consecutive ranks, or into the ranks of each shared-memory node if
+    ranks_per_aggregator is zero.
+   */
 
-    return_val = write_data_to_hdf5(
-      hdf5_file_id, field_name.data(), buffer, nsize, displ, mpi_hdf5_comm);
-    assert(return_val);
-  } // checkpoint_field
+  aggregation_t create_aggregation(MPI_Comm comm) {
+    int comm_rank;
+    MPI_Comm_rank(comm, &comm_rank);
 
-  void checkpoint_field_ragged(const hid_t hdf5_file_id,
-    const std::string & field_name,
-    const std::vector<uint8_t> & rows,
-    const int nrows,
-    const size_t fid) {
+    aggregation_t aggregation;
+    if(ranks_per_aggregator > 0) {
+      MPI_Comm_split(comm, comm_rank / ranks_per_aggregator, comm_rank,
+        &aggregation.clients);
+    }
+    else {
+      MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, comm_rank,
+        MPI_INFO_NULL, &aggregation.clients);
+    } // if
+
+    int clients_size, clients_rank;
+    MPI_Comm_size(aggregation.clients, &clients_size);
+    MPI_Comm_rank(aggregation.clients, &clients_rank);
+
+    aggregation.ranks.resize(clients_size);
+    MPI_Allgather(&comm_rank, 1, MPI_INT, aggregation.ranks.data(), 1,
+      MPI_INT, aggregation.clients);
+
+    MPI_Comm_split(comm, clients_rank == 0 ? 0 : MPI_UNDEFINED, comm_rank,
+      &aggregation.aggregators);
+
+    return aggregation;
+  } // create_aggregation
+
+  void free_aggregation(aggregation_t & aggregation) {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if(!finalized) {
+      if(aggregation.clients != MPI_COMM_NULL)
+        MPI_Comm_free(&aggregation.clients);
+      if(aggregation.aggregators != MPI_COMM_NULL)
+        MPI_Comm_free(&aggregation.aggregators);
+    } // if
+    aggregation = aggregation_t();
+  } // free_aggregation
+
+  /*!
+    Return the blocks of a dataset that hold the contributions of the
+    clients of an aggregator, given the offsets of the contributions of
+    all ranks of the file.
+   */
+
+  std::vector<block_t> client_blocks(const aggregation_t & aggregation,
+    const std::vector<std::uint64_t> & offset_buf) {
+    std::vector<block_t> blocks;
+    for(int r : aggregation.ranks) {
+      const hsize_t displ = offset_buf[r];
+      const hsize_t nsize = offset_buf[r + 1] - offset_buf[r];
+      if(!blocks.empty() &&
+         blocks.back().first + blocks.back().second == displ) {
+        blocks.back().second += nsize;
+      }
+      else {
+        blocks.push_back({displ, nsize});
+      } // if
+    } // for
+    return blocks;
+  } // client_blocks
+
+  /*!
+    Send the contributions of the clients of an aggregator to it, which
+    stores them contiguously, in the order of the ranks.
+
+    @param bytes      The size of an element.
+    @param local      The contribution of this rank.
+    @param aggregated The contributions of the clients, on the
+                      aggregator.
+   */
+
+  void gather_contributions(const aggregation_t & aggregation,
+    size_t bytes,
+    const std::vector<std::uint64_t> & offset_buf,
+    const void * local,
+    unsigned char * aggregated) {
+    exchange_contributions(aggregation, bytes, offset_buf,
+      const_cast<void *>(local), aggregated, true);
+  } // gather_contributions
+
+  /*!
+    Send the contributions that an aggregator has read to its clients.
+   */
+
+  void scatter_contributions(const aggregation_t & aggregation,
+    size_t bytes,
+    const std::vector<std::uint64_t> & offset_buf,
+    const unsigned char * aggregated,
+    void * local) {
+    exchange_contributions(aggregation, bytes, offset_buf, local,
+      const_cast<unsigned char *>(aggregated), false);
+  } // scatter_contributions
+
+  void exchange_contributions(const aggregation_t & aggregation,
+    size_t bytes,
+    const std::vector<std::uint64_t> & offset_buf,
+    void * local,
+    unsigned char * aggregated,
+    bool gather) {
+    int clients_rank;
+    MPI_Comm_rank(aggregation.clients, &clients_rank);
+
+    auto size = [&](int r) { return offset_buf[r + 1] - offset_buf[r]; };
+
+    // The contributions are transferred as bytes, in pieces whose size
+    // fits in an MPI count.
+    const int tag = 0;
+    std::vector<MPI_Request> requests;
+    if(clients_rank != 0) {
+      const size_t count = size(aggregation.ranks[clients_rank]) * bytes;
+      post_transfer(
+        local, count, 0, tag, aggregation.clients, gather, requests);
+    }
+    else {
+      // The contribution of the aggregator is copied.
+      const std::uint64_t own = size(aggregation.ranks[0]);
+      if(gather)
+        std::memcpy(aggregated, local, own * bytes);
+      else
+        std::memcpy(local, aggregated, own * bytes);
+
+      unsigned char * position = aggregated + own * bytes;
+      for(size_t c = 1; c < aggregation.ranks.size(); ++c) {
+        const size_t count = size(aggregation.ranks[c]) * bytes;
+        post_transfer(position, count, int(c), tag, aggregation.clients,
+          !gather, requests);
+        position += count;
+      } // for
+    } // if
+    MPI_Waitall(int(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+  } // exchange_contributions
+
+  /*!
+    Serialize the rows of a ragged field. The storage of the buffer is
+    reused if it is large enough.
+   */
+
+  void serialize_ragged(const std::vector<uint8_t> & rows,
+    const size_t nrows,
+    const size_t fid,
+    std::vector<unsigned char> & buffer) {
     auto & context = execution::context_t::instance();
     auto serdez = context.get_serdez(fid);
-    int nsize = 0;
-    int row_vector_size = sizeof(data::row_vector_u<uint8_t>);
-    for(int i = 0; i < nrows; ++i) {
-      nsize += serdez->serialized_size(&rows[i * row_vector_size]);
+    size_t nbytes = 0;
+    const size_t row_vector_size = sizeof(data::row_vector_u<uint8_t>);
+    for(size_t i = 0; i < nrows; ++i) {
+      nbytes += serdez->serialized_size(&rows[i * row_vector_size]);
     }
-    // TODO:  handle case where this doesn't divide evenly
-    nsize /= sizeof(std::uint32_t);
-
-    int sum_nsize;
-    MPI_Allreduce(&nsize, &sum_nsize, 1, MPI_INT, MPI_SUM, mpi_hdf5_comm);
-    int displ;
-    MPI_Exscan(&nsize, &displ, 1, MPI_INT, MPI_SUM, mpi_hdf5_comm);
-    if(new_rank == 0)
-      displ = 0;
-    std::vector<int> offset_buf(new_world_size + 1);
-    MPI_Allgather(
-      &displ, 1, MPI_INT, offset_buf.data(), 1, MPI_INT, mpi_hdf5_comm);
-    offset_buf[new_world_size] = sum_nsize;
 
-    bool return_val = false;
-    return_val = create_hdf5_dataset(
-      hdf5_file_id, field_name.data(), sum_nsize, mpi_hdf5_comm);
-    assert(return_val);
+    buffer.resize(nbytes);
 
-    std::vector<std::uint32_t> buffer(nsize);
     const char * row_ptr = (char *)rows.data();
     char * buf_ptr = (char *)buffer.data();
-    for(int i = 0; i < nrows; ++i) {
-      int item_size = serdez->serialize(row_ptr, buf_ptr);
+    for(size_t i = 0; i < nrows; ++i) {
+      size_t item_size = serdez->serialize(row_ptr, buf_ptr);
       row_ptr += row_vector_size;
       buf_ptr += item_size;
     }
-
-    return_val = write_data_to_hdf5(hdf5_file_id, field_name, buffer.data(),
-      nsize, displ, mpi_hdf5_comm, offset_buf.data());
-    assert(return_val);
-  } // checkpoint_field_ragged
-
-  void recover_field(const hid_t hdf5_file_id,
-    const std::string & field_name,
-    void * buffer,
-    const int size) {
-    int nsize = std::ceil(((double)size) / sizeof(std::uint32_t));
-    int displ;
-    MPI_Exscan(&nsize, &displ, 1, MPI_INT, MPI_SUM, mpi_hdf5_comm);
-    if(new_rank == 0)
-      displ = 0;
+  } // serialize_ragged
+
+  /*!
+    Write the contributions of all ranks of a communicator to one
+    dataset. The offsets of the contributions are stored as an
+    attribute, so that the contribution of each rank can be found on
+    restart without knowing the sizes of the others.
+
+    The contributions are gathered by the aggregators, which write the
+    contributions of their clients together.
+   */
+
+  void write_field(const hid_t hdf5_file_id,
+    const staged_field_t & staged,
+    MPI_Comm comm,
+    const aggregation_t & aggregation) {
+    int comm_size;
+    MPI_Comm_size(comm, &comm_size);
+
+    std::uint64_t nsize = staged.count;
+    std::vector<std::uint64_t> offset_buf(comm_size + 1, 0);
+    MPI_Allgather(&nsize, 1, MPI_UINT64_T, offset_buf.data() + 1, 1,
+      MPI_UINT64_T, comm);
+    std::partial_sum(offset_buf.begin(), offset_buf.end(), offset_buf.begin());
+
+    const auto blocks = client_blocks(aggregation, offset_buf);
+    const void * data = staged.data();
+    std::vector<unsigned char> aggregated;
+    if(aggregation.ranks.size() > 1) {
+      const size_t bytes = staged.type_size();
+      if(aggregation.aggregators != MPI_COMM_NULL) {
+        hsize_t count = 0;
+        for(const auto & block : blocks) {
+          count += block.second;
+        } // for
+        aggregated.resize(count * bytes);
+      } // if
+      gather_contributions(
+        aggregation, bytes, offset_buf, data, aggregated.data());
+      data = aggregated.data();
+    } // if
+
+    if(aggregation.aggregators == MPI_COMM_NULL)
+      return;
 
     bool return_val = false;
+    return_val = create_hdf5_dataset(hdf5_file_id, staged.dataset_name,
+      staged.type(), offset_buf[comm_size], aggregation.aggregators,
+      staged.compression);
+    assert(return_val);
 
-    return_val = read_data_from_hdf5(
-      hdf5_file_id, field_name.data(), buffer, nsize, displ, mpi_hdf5_comm);
+    return_val = write_data_to_hdf5(hdf5_file_id, staged.dataset_name,
+      staged.type(), data, blocks, aggregation.aggregators);
     assert(return_val);
-  } // recover_field
 
-  void recover_field_ragged(const hid_t hdf5_file_id,
-    const std::string & field_name,
-    const std::vector<uint8_t> & rows,
-    const int nrows,
-    const size_t fid) {
+    write_attribute(hdf5_file_id, staged.dataset_name, "offsets", offset_buf);
+    for(const auto & attribute : staged.attributes) {
+      write_attribute(hdf5_file_id, staged.dataset_name, attribute.first,
+        attribute.second);
+    } // for
+  } // write_field
+
+  /*!
+    Return the HDF5 type in which the values of a field are stored.
+    Ragged and sparse fields are stored in their serialized form.
+   */
+
+  static hid_t field_type(const execution::context_t::field_info_t & info) {
+    return hdf5_type(field_scalar_type(info));
+  } // field_type
+
+  /*!
+    Return the scalar type in which the values of a field are stored,
+    without calling HDF5. See field_type().
+   */
+
+  static data::scalar_type_t field_scalar_type(
+    const execution::context_t::field_info_t & info) {
+    const size_t scalar_size = data::scalar_type_size(info.scalar_type);
+    if(info.storage_class != data::dense || scalar_size == 0 ||
+       info.size % scalar_size != 0)
+      return data::scalar_type_t::opaque;
+    return info.scalar_type;
+  } // field_scalar_type
+
+  /*!
+    Return the name of the dataset of a field.
+   */
+
+  static std::string dataset_name(
+    const execution::context_t::field_info_t & info) {
+    return index_space_group(info.index_space) + "/fid_" +
+           std::to_string(info.fid);
+  } // dataset_name
+
+  /*!
+    Return the name of the group of the datasets of an index space.
+   */
+
+  static std::string index_space_group(size_t index_space) {
+    return "index_space_" + std::to_string(index_space);
+  } // index_space_group
+
+  /*!
+    Read the offsets of the contributions of the ranks that wrote a
+    dataset.
+   */
+
+  std::vector<std::uint64_t> read_offsets(
+    const hid_t hdf5_file_id, const std::string & dataset_name) {
     hid_t attribute_id = H5Aopen_by_name(
-      hdf5_file_id, field_name.c_str(), "offsets", H5P_DEFAULT, H5P_DEFAULT);
-    std::vector<int> offset_buf(new_world_size + 1);
+      hdf5_file_id, dataset_name.c_str(), "offsets", H5P_DEFAULT, H5P_DEFAULT);
+    clog_assert(attribute_id >= 0, "dataset " << dataset_name
+                                              << " has no offsets attribute");
+
+    hid_t attribute_space_id = H5Aget_space(attribute_id);
+    std::vector<std::uint64_t> offset_buf(
+      H5Sget_simple_extent_npoints(attribute_space_id));
+    H5Sclose(attribute_space_id);
+
     herr_t status;
-    status = H5Aread(attribute_id, H5T_NATIVE_B32, offset_buf.data());
+    status = H5Aread(attribute_id, H5T_NATIVE_UINT64, offset_buf.data());
     assert(status == 0);
     status = H5Aclose(attribute_id);
     assert(status == 0);
+    return offset_buf;
+  } // read_offsets
 
-    int nsize = offset_buf[new_rank + 1] - offset_buf[new_rank];
-    int displ = offset_buf[new_rank];
-    std::vector<std::uint32_t> buffer(nsize);
+  /*!
+    Read the contribution of one of the ranks that wrote a dataset.
 
-    bool return_val = false;
-    return_val = read_data_from_hdf5(
-      hdf5_file_id, field_name, buffer.data(), nsize, displ, mpi_hdf5_comm);
+    @param type     The type of the elements in memory.
+    @param position The position of the rank among the ranks that wrote
+                    the file.
+    @param buffer   The contribution, which is resized to fit.
+   */
+
+  void read_contribution(const hid_t hdf5_file_id,
+    const std::string & dataset_name,
+    hid_t type,
+    int position,
+    MPI_Comm comm,
+    std::vector<unsigned char> & buffer) {
+    auto offset_buf = read_offsets(hdf5_file_id, dataset_name);
+    hsize_t nsize = offset_buf[position + 1] - offset_buf[position];
+    buffer.resize(nsize * H5Tget_size(type));
+
+    bool return_val = read_data_from_hdf5(hdf5_file_id, dataset_name, type,
+      buffer.data(), nsize, offset_buf[position], comm);
     assert(return_val);
+  } // read_contribution
+
+  /*!
+    Check that a checkpoint file has the layout written by this policy.
+   */
+
+  void check_version(const hid_t hdf5_file_id,
+    const std::string & file_name) {
+    clog_assert(H5Aexists(hdf5_file_id, "version") > 0 &&
+                  read_attribute(hdf5_file_id, ".", "version") == version,
+      file_name << " is not a checkpoint of version " << version);
+  } // check_version
+
+  /*!
+    Return whether a file has a dataset.
+   */
+
+  bool has_dataset(const hid_t hdf5_file_id, const std::string & name) {
+    // The groups on the path are checked first.
+    for(size_t end = name.find('/'); end != std::string::npos;
+        end = name.find('/', end + 1)) {
+      if(H5Lexists(hdf5_file_id, name.substr(0, end).c_str(), H5P_DEFAULT) <=
+         0)
+        return false;
+    } // for
+
+    return H5Lexists(hdf5_file_id, name.c_str(), H5P_DEFAULT) > 0;
+  } // has_dataset
+
+  /*!
+    Return the file of a chain of incremental checkpoints that holds a
+    dataset. The chain starts with the most recent checkpoint, and the
+    checkpoints that it is based on are opened when they are needed.
+
+    @param chain  The open files of the chain.
+    @param suffix The suffix of the files of the chain, i.e., the index
+                  of the file.
+   */
+
+  hid_t find_dataset(std::vector<hid_t> & chain,
+    const std::string & suffix,
+    const std::string & name,
+    MPI_Comm comm) {
+    for(size_t i = 0;; ++i) {
+      if(i == chain.size()) {
+        clog_assert(H5Aexists(chain.back(), "base") > 0,
+          "dataset " << name << " is not in the checkpoint");
+
+        std::string file_name =
+          read_string_attribute(chain.back(), ".", "base") + suffix;
+        hid_t hdf5_file_id = -1;
+        bool return_val = open_hdf5_file(hdf5_file_id, file_name, comm);
+        clog_assert(return_val, "cannot open checkpoint file " << file_name);
+        check_version(hdf5_file_id, file_name);
+        chain.push_back(hdf5_file_id);
+      } // if
+
+      if(has_dataset(chain[i], name))
+        return chain[i];
+    } // for
+  } // find_dataset
+
+  /*!
+    Close the files of a chain of incremental checkpoints.
+   */
+
+  void close_chain(std::vector<hid_t> & chain, MPI_Comm comm) {
+    for(auto & hdf5_file_id : chain) {
+      bool return_val = close_hdf5_file(hdf5_file_id, comm);
+      assert(return_val);
+    } // for
+    chain.clear();
+  } // close_chain
 
-    auto & context = execution::context_t::instance();
-    auto serdez = context.get_serdez(fid);
-    char * row_ptr = (char *)rows.data();
-    const char * buf_ptr = (char *)buffer.data();
-    int row_vector_size = sizeof(data::row_vector_u<uint8_t>);
-    for(int i = 0; i < nrows; ++i) {
-      int item_size = serdez->deserialize(row_ptr, buf_ptr);
-      row_ptr += row_vector_size;
-      buf_ptr += item_size;
-    }
+  void checkpoint_all_fields(const std::string & file_name_in) {
+    checkpoint_fields(file_name_in, false);
+  } // checkpoint_all_fields
 
-  } // recover_field_ragged
+  /*!
+    Checkpoint the fields that were modified since the last checkpoint,
+    which the new checkpoint is based on. Recovering the new checkpoint
+    also reads the unmodified fields from the checkpoints that it is
+    based on, which must therefore be kept. If there is no previous
+    checkpoint, all fields are written.
 
-  void checkpoint_all_fields(const std::string & file_name_in) {
-    // TODO:  make this happen only once
+    Modifications are tracked by the write epochs of the context.
+   */
+
+  void checkpoint_modified_fields(const std::string & file_name_in) {
+    checkpoint_fields(file_name_in, true);
+  } // checkpoint_modified_fields
+
+  void checkpoint_fields(const std::string & file_name_in, bool incremental) {
+    execution::timeline_scope_t scope(execution::timeline_kind_t::checkpoint);
+    // HDF5 may not be used while an asynchronous checkpoint is written.
+    wait_checkpoint();
     create_hdf5_comm();
 
-    hid_t hdf5_file_id = -1;
     bool return_val = false;
 
     // initialize HDF5 library
@@ -441,50 +1133,18 @@ struct mpi_policy_t {
     if(rank == 0)
       std::cout << "Creating HDF5 file " << std::endl << world_size;
 
-    std::string file_name = file_name_in + std::to_string(new_color);
-    return_val = create_hdf5_file(hdf5_file_id, file_name, mpi_hdf5_comm);
-    assert(return_val);
-
-    // checkpoint
+    // checkpoint, without copying dense fields
     if(rank == 0)
       std::cout << "Writing checkpoint" << std::endl;
-    auto & context = execution::context_t::instance();
-    const auto & field_data = context.registered_field_data();
-    const auto & sparse_field_data = context.registered_sparse_field_data();
-    const auto & field_info = context.registered_fields();
-    for(const auto & info : field_info) {
-      switch(info.storage_class) {
-        case data::dense: {
-          size_t fid = info.fid;
-          std::string field_name = "fid_" + std::to_string(fid);
-          auto & data = field_data.at(fid);
-          // TODO:  handle case where this doesn't divide evenly
-          int size = data.size();
-          const void * buffer = data.data();
-          checkpoint_field(hdf5_file_id, field_name, buffer, size);
-        } break;
-
-        case data::ragged:
-        case data::sparse: {
-          size_t fid = info.fid;
-          std::string field_name = "fid_" + std::to_string(fid);
-          auto & data = sparse_field_data.at(fid);
-          int nrows = data.num_total;
-          const auto & rows = data.rows;
-          checkpoint_field_ragged(hdf5_file_id, field_name, rows, nrows, fid);
-        } break;
-
-        default:
-          // do nothing
-          break;
-      }
-    }
-
-    return_val = close_hdf5_file(hdf5_file_id, mpi_hdf5_comm);
-    assert(return_val);
-  } // checkpoint_all_fields
+    staged_checkpoint_t checkpoint;
+    snapshot_all_fields(file_name_in, checkpoint, false, incremental);
+    write_checkpoint(checkpoint, mpi_hdf5_comm, aggregation_);
+  } // checkpoint_fields
 
   void recover_all_fields(const std::string & file_name_in) {
+    execution::timeline_scope_t scope(execution::timeline_kind_t::recover);
+    wait_checkpoint();
+    execution::mpi_task_scheduler_t::instance().fence();
     create_hdf5_comm();
 
     hid_t hdf5_file_id = -1;
@@ -493,59 +1153,57 @@ struct mpi_policy_t {
     // recover
     if(rank == 0)
       std::cout << "Recovering checkpoint" << std::endl;
-    std::string file_name = file_name_in + std::to_string(new_color);
-    return_val = open_hdf5_file(hdf5_file_id, file_name, mpi_hdf5_comm);
-    assert(return_val);
+    const std::string suffix = std::to_string(new_color);
+    std::string file_name = file_name_in + suffix;
+    std::vector<hid_t> chain;
+    if(aggregation_.aggregators != MPI_COMM_NULL) {
+      return_val =
+        open_hdf5_file(hdf5_file_id, file_name, aggregation_.aggregators);
+      assert(return_val);
+      check_version(hdf5_file_id, file_name);
+      chain.push_back(hdf5_file_id);
+    } // if
 
     auto & context = execution::context_t::instance();
     auto & field_data = context.registered_field_data();
-    const auto & sparse_field_data = context.registered_sparse_field_data();
+    auto & sparse_field_data = context.registered_sparse_field_data();
     const auto & field_info = context.registered_fields();
-    auto & index_space_info = context.sparse_index_space_info_map();
+    std::vector<unsigned char> buffer;
     for(const auto & info : field_info) {
       switch(info.storage_class) {
         case data::dense: {
-          size_t fid = info.fid;
-          size_t is = info.index_space;
-          std::string field_name = "fid_" + std::to_string(fid);
-          auto it = field_data.find(fid);
-          if(it == field_data.end()) {
-            // instantiate field if not already there
-            const auto & color_info =
-              (context.coloring_info(is)).at(context.color());
-            size_t size = info.size * (color_info.exclusive +
-                                        color_info.shared + color_info.ghost);
-            context.register_field_data(fid, size);
-            it = field_data.find(fid);
-          }
-          assert(it != field_data.end() && "messed up");
-          auto & data = field_data.at(fid);
-          size_t size = data.size();
-          void * buffer = data.data();
-          recover_field(hdf5_file_id, field_name, buffer, size);
+          instantiate_field(info);
+          auto & data = field_data.at(info.fid);
+          const std::string name = dataset_name(info);
+          const hid_t type = field_type(info);
+
+          // read in place
+          auto offset_buf = chain_offsets(chain, suffix, name);
+          hsize_t nsize = offset_buf[new_rank + 1] - offset_buf[new_rank];
+          clog_assert(nsize * H5Tget_size(type) == data.size(),
+            "field " << info.fid << " does not match the checkpoint");
+          read_field(chain, suffix, name, type, offset_buf, data.data());
         } break;
 
         case data::ragged:
         case data::sparse: {
-          size_t fid = info.fid;
-          size_t is = info.index_space;
-          std::string field_name = "fid_" + std::to_string(fid);
-          auto it = sparse_field_data.find(fid);
-          if(it == sparse_field_data.end()) {
-            // instantiate field if not already there
-            const auto & color_info =
-              (context.coloring_info(is)).at(context.color());
-            const auto & is_info = index_space_info.at(is);
-            const auto max_entries_per_index = is_info.max_entries_per_index;
-            context.register_sparse_field_data(
-              fid, info.size, color_info, max_entries_per_index);
-            it = sparse_field_data.find(fid);
+          instantiate_field(info);
+          auto & data = sparse_field_data.at(info.fid);
+          const std::string name = dataset_name(info);
+          auto offset_buf = chain_offsets(chain, suffix, name);
+          buffer.resize(offset_buf[new_rank + 1] - offset_buf[new_rank]);
+          read_field(
+            chain, suffix, name, H5T_NATIVE_UCHAR, offset_buf, buffer.data());
+
+          auto serdez = context.get_serdez(info.fid);
+          char * row_ptr = (char *)data.rows.data();
+          const char * buf_ptr = (char *)buffer.data();
+          const size_t row_vector_size = sizeof(data::row_vector_u<uint8_t>);
+          for(size_t i = 0; i < data.num_total; ++i) {
+            size_t item_size = serdez->deserialize(row_ptr, buf_ptr);
+            row_ptr += row_vector_size;
+            buf_ptr += item_size;
           }
-          assert(it != sparse_field_data.end() && "messed up");
-          auto & data = sparse_field_data.at(fid);
-          int nrows = data.num_total;
-          const auto & rows = data.rows;
-          recover_field_ragged(hdf5_file_id, field_name, rows, nrows, fid);
         } break;
 
         default:
@@ -554,11 +1212,1098 @@ struct mpi_policy_t {
       }
     }
 
-    return_val = close_hdf5_file(hdf5_file_id, mpi_hdf5_comm);
-    assert(return_val);
+    close_chain(chain, aggregation_.aggregators);
+
+    // The fields now match the checkpoint, which can be the base of the
+    // next incremental checkpoint.
+    last_checkpoint_ = file_name_in;
+    last_checkpoint_epoch_ = context.write_epoch();
   } // recover_all_fields
 
+  /*!
+    Return the offsets of the contributions of the ranks of this file to
+    a dataset of a chain of incremental checkpoints. The aggregators
+    read them for their clients.
+   */
+
+  std::vector<std::uint64_t> chain_offsets(std::vector<hid_t> & chain,
+    const std::string & suffix,
+    const std::string & name) {
+    std::vector<std::uint64_t> offset_buf(new_world_size + 1);
+    if(aggregation_.aggregators != MPI_COMM_NULL) {
+      hid_t file = find_dataset(chain, suffix, name, aggregation_.aggregators);
+      offset_buf = read_offsets(file, name);
+      clog_assert(offset_buf.size() == size_t(new_world_size) + 1,
+        "dataset " << name << " was written by a different number of ranks");
+    } // if
+
+    MPI_Bcast(offset_buf.data(), new_world_size + 1, MPI_UINT64_T, 0,
+      aggregation_.clients);
+    return offset_buf;
+  } // chain_offsets
+
+  /*!
+    Read the contribution of this rank to a dataset of a chain of
+    incremental checkpoints. The aggregators read the contributions of
+    their clients together, and send them to the clients.
+   */
+
+  void read_field(std::vector<hid_t> & chain,
+    const std::string & suffix,
+    const std::string & name,
+    hid_t type,
+    const std::vector<std::uint64_t> & offset_buf,
+    void * buffer) {
+    const bool aggregator = aggregation_.aggregators != MPI_COMM_NULL;
+    const auto blocks = client_blocks(aggregation_, offset_buf);
+    const size_t bytes = H5Tget_size(type);
+
+    std::vector<unsigned char> aggregated;
+    void * data = buffer;
+    if(aggregator && aggregation_.ranks.size() > 1) {
+      hsize_t count = 0;
+      for(const auto & block : blocks) {
+        count += block.second;
+      } // for
+      aggregated.resize(count * bytes);
+      data = aggregated.data();
+    } // if
+
+    if(aggregator) {
+      hid_t file = find_dataset(chain, suffix, name, aggregation_.aggregators);
+      bool return_val = read_data_from_hdf5(
+        file, name, type, data, blocks, aggregation_.aggregators);
+      assert(return_val);
+    } // if
+
+    if(aggregation_.ranks.size() > 1) {
+      scatter_contributions(
+        aggregation_, bytes, offset_buf, aggregated.data(), buffer);
+    } // if
+  } // read_field
+
+  /*!
+    Recover all fields from a checkpoint that was written on a different
+    number of ranks, or with a different coloring of the index spaces.
+
+    The contributions of the ranks that wrote the checkpoint are divided
+    evenly among the current ranks, which read them independently. The
+    values of the exclusive and shared entities are then sent to a home
+    rank, chosen by the global id, from which every rank requests the
+    values of its exclusive, shared and ghost entities. Each entity is
+    thus identified by its global id, and the same index map must be
+    used on restart as on checkpoint.
+
+    The checkpoint must include the restart metadata that is written by
+    checkpoint_all_fields() and checkpoint_all_fields_async(). Fields
+    that an incremental checkpoint does not hold are read from the
+    checkpoints that it is based on.
+   */
+
+  void recover_all_fields_redistributed(const std::string & file_name_in) {
+    execution::timeline_scope_t scope(execution::timeline_kind_t::recover);
+    wait_checkpoint();
+    execution::mpi_task_scheduler_t::instance().fence();
+
+    herr_t status = H5open();
+    assert(status == 0);
+
+    int comm_size, comm_rank;
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &comm_rank);
+
+    if(comm_rank == 0)
+      std::cout << "Recovering checkpoint" << std::endl;
+
+    hid_t hdf5_file_id = -1;
+    bool return_val = false;
+
+    // The number of ranks that wrote the checkpoint, and ranks per file.
+    return_val =
+      open_hdf5_file(hdf5_file_id, file_name_in + "0", MPI_COMM_SELF);
+    clog_assert(return_val, "cannot open checkpoint " << file_name_in);
+    check_version(hdf5_file_id, file_name_in + "0");
+    const int old_size = read_attribute(hdf5_file_id, ".", "world_size");
+    const int old_ranks_per_file =
+      read_attribute(hdf5_file_id, ".", "ranks_per_file");
+    close_hdf5_file(hdf5_file_id, MPI_COMM_SELF);
+
+    auto & context = execution::context_t::instance();
+    auto & field_data = context.registered_field_data();
+    auto & sparse_field_data = context.registered_sparse_field_data();
+
+    // The fields of each index space.
+    std::map<size_t, std::vector<const execution::context_t::field_info_t *>>
+      fields;
+    for(const auto & info : context.registered_fields()) {
+      if(info.storage_class == data::dense ||
+         info.storage_class == data::ragged ||
+         info.storage_class == data::sparse) {
+        instantiate_field(info);
+        fields[info.index_space].push_back(&info);
+      } // if
+    } // for
+
+    const int row_vector_size = sizeof(data::row_vector_u<uint8_t>);
+
+    // The records of the owned entities of each index space, by home
+    // rank. A record holds the global id, followed by the values of the
+    // fields, where ragged values are preceded by their size in bytes.
+    std::map<size_t, std::vector<std::vector<unsigned char>>> records;
+    for(const auto & f : fields)
+      records[f.first].resize(comm_size);
+
+    const int first = int(std::int64_t(old_size) * comm_rank / comm_size);
+    const int last = int(std::int64_t(old_size) * (comm_rank + 1) / comm_size);
+
+    for(int old_rank = first; old_rank < last; ++old_rank) {
+      const int position = old_rank % old_ranks_per_file;
+      const std::string suffix = std::to_string(old_rank / old_ranks_per_file);
+      std::string file_name = file_name_in + suffix;
+      return_val = open_hdf5_file(hdf5_file_id, file_name, MPI_COMM_SELF);
+      clog_assert(return_val, "cannot open checkpoint file " << file_name);
+      std::vector<hid_t> chain = {hdf5_file_id};
+
+      for(const auto & f : fields) {
+        const std::string group = index_space_group(f.first);
+        std::vector<unsigned char> gids;
+        read_contribution(hdf5_file_id, group + "/gids", H5T_NATIVE_UINT64,
+          position, MPI_COMM_SELF, gids);
+        std::uint64_t owned;
+        return_val = read_data_from_hdf5(hdf5_file_id, group + "/owned",
+          H5T_NATIVE_UINT64, &owned, 1, position, MPI_COMM_SELF);
+        assert(return_val);
+
+        std::vector<std::vector<unsigned char>> values(f.second.size());
+        std::vector<const char *> cursors;
+        for(size_t v = 0; v < f.second.size(); ++v) {
+          const auto & info = *f.second[v];
+          const std::string name = dataset_name(info);
+          hid_t file = find_dataset(chain, suffix, name, MPI_COMM_SELF);
+          read_contribution(
+            file, name, field_type(info), position, MPI_COMM_SELF, values[v]);
+          cursors.push_back(reinterpret_cast<const char *>(values[v].data()));
+        } // for
+
+        auto gid = reinterpret_cast<const std::uint64_t *>(gids.data());
+        std::vector<char> row(row_vector_size);
+        for(size_t i = 0; i < owned; ++i) {
+          auto & buffer = records[f.first][gid[i] % comm_size];
+          topology::cast_insert(reinterpret_cast<const size_t *>(&gid[i]), 1,
+            buffer);
+
+          for(size_t v = 0; v < f.second.size(); ++v) {
+            const auto & info = *f.second[v];
+            if(info.storage_class == data::dense) {
+              auto bytes = values[v].data() + i * info.size;
+              buffer.insert(buffer.end(), bytes, bytes + info.size);
+            }
+            else {
+              // The values are not aligned, so the size of a row is only
+              // known once it is deserialized.
+              auto serdez = context.get_serdez(info.fid);
+              std::fill(row.begin(), row.end(), 0);
+              size_t size = serdez->deserialize(row.data(), cursors[v]);
+              serdez->destroy(row.data());
+
+              auto bytes = reinterpret_cast<const unsigned char *>(cursors[v]);
+              topology::cast_insert(&size, 1, buffer);
+              buffer.insert(buffer.end(), bytes, bytes + size);
+              cursors[v] += size;
+            } // if
+          } // for
+        } // for
+      } // for
+
+      close_chain(chain, MPI_COMM_SELF);
+      hdf5_file_id = -1;
+    } // for
+
+    for(const auto & f : fields) {
+      // Store the records at their home ranks.
+      auto received = coloring::exchange(records[f.first]);
+      records[f.first].clear();
+
+      auto record_size = [&](const unsigned char * p) {
+        const unsigned char * start = p;
+        p += sizeof(size_t);
+        for(auto info : f.second) {
+          if(info->storage_class == data::dense) {
+            p += info->size;
+          }
+          else {
+            size_t size;
+            std::memcpy(&size, p, sizeof(size_t));
+            p += sizeof(size_t) + size;
+          } // if
+        } // for
+        return size_t(p - start);
+      }; // record_size
+
+      std::unordered_map<size_t, std::pair<const unsigned char *, size_t>>
+        directory;
+      for(const auto & buffer : received) {
+        for(auto p = buffer.data(); p != buffer.data() + buffer.size();) {
+          size_t gid;
+          std::memcpy(&gid, p, sizeof(size_t));
+          size_t size = record_size(p);
+          directory[gid] = {p, size};
+          p += size;
+        } // for
+      } // for
+
+      // Request the records of all local entities from their home ranks.
+      const auto & index_map = context.index_map(f.first);
+      std::vector<std::vector<size_t>> requests(comm_size);
+      for(const auto & entry : index_map)
+        requests[entry.second % comm_size].push_back(entry.second);
+
+      auto requested = coloring::exchange(requests);
+
+      std::vector<std::vector<unsigned char>> replies(comm_size);
+      for(int r = 0; r < comm_size; ++r) {
+        for(auto gid : requested[r]) {
+          auto it = directory.find(gid);
+          clog_assert(it != directory.end(),
+            "entity " << gid << " is not in the checkpoint");
+          replies[r].insert(replies[r].end(), it->second.first,
+            it->second.first + it->second.second);
+        } // for
+      } // for
+
+      auto answers = coloring::exchange(replies);
+
+      // The records arrive in the order of the requests.
+      std::vector<const unsigned char *> cursors(comm_size);
+      for(int r = 0; r < comm_size; ++r)
+        cursors[r] = answers[r].data();
+
+      for(const auto & entry : index_map) {
+        auto & p = cursors[entry.second % comm_size];
+        p += sizeof(size_t);
+
+        for(auto info : f.second) {
+          if(info->storage_class == data::dense) {
+            std::memcpy(field_data.at(info->fid).data() +
+                          entry.first * info->size,
+              p, info->size);
+            p += info->size;
+          }
+          else {
+            size_t size;
+            std::memcpy(&size, p, sizeof(size_t));
+            p += sizeof(size_t);
+
+            auto & data = sparse_field_data.at(info->fid);
+            auto serdez = context.get_serdez(info->fid);
+            serdez->deserialize(
+              data.rows.data() + entry.first * row_vector_size, p);
+            p += size;
+          } // if
+        } // for
+      } // for
+    } // for
+
+    // The checkpoint was written by a different number of ranks, so it
+    // cannot be the base of an incremental checkpoint, whose datasets
+    // are read by rank. Mark the recovered fields written, so that the
+    // next incremental checkpoint holds all of them, rather than being
+    // based on a checkpoint taken before the recovery.
+    last_checkpoint_ = file_name_in;
+    last_checkpoint_epoch_ = context.write_epoch();
+
+    for(const auto & f : fields) {
+      for(auto info : f.second)
+        context.mark_field_written(info->fid);
+    } // for
+  } // recover_all_fields_redistributed
+
+  /*!
+    Checkpoint all fields to the local tier. Each rank maps a file in
+    local_directory, on node-local storage, and copies its field data
+    into it. The file is also copied to a partner rank on another node,
+    when there is one, so that a checkpoint survives the loss of a node.
+    Every local_flush_interval-th local checkpoint is also written to an
+    HDF5 checkpoint of the same name in the background.
+   */
+
+  void checkpoint_all_fields_local(const std::string & file_name_in) {
+    execution::timeline_scope_t scope(execution::timeline_kind_t::checkpoint);
+    // Tasks that write the fields may still be running.
+    execution::mpi_task_scheduler_t::instance().fence();
+
+    int comm_rank, comm_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &comm_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+
+    auto & context = execution::context_t::instance();
+    const auto & field_data = context.registered_field_data();
+    const auto & sparse_field_data = context.registered_sparse_field_data();
+
+    // Lay out the records, serializing ragged and sparse fields.
+    std::vector<std::pair<const execution::context_t::field_info_t *,
+      std::pair<const void *, size_t>>>
+      records;
+    size_t bytes = sizeof(local_header_t);
+    size_t b = 0;
+    for(const auto & info : context.registered_fields()) {
+      const void * data;
+      size_t size;
+      if(info.storage_class == data::dense) {
+        const auto & dense = field_data.at(info.fid);
+        data = dense.data();
+        size = dense.size();
+      }
+      else if(info.storage_class == data::ragged ||
+              info.storage_class == data::sparse) {
+        if(local_buffers_.size() <= b)
+          local_buffers_.resize(b + 1);
+        auto & buffer = local_buffers_[b++];
+        const auto & sparse = sparse_field_data.at(info.fid);
+        serialize_ragged(sparse.rows, sparse.num_total, info.fid, buffer);
+        data = buffer.data();
+        size = buffer.size();
+      }
+      else {
+        continue;
+      } // if
+
+      records.push_back({&info, {data, size}});
+      bytes += sizeof(local_record_t) + local_padded(size);
+    } // for
+
+    local_mapping_t own;
+    const std::string path = local_file_name(file_name_in, comm_rank, false);
+    clog_assert(own.create(path, bytes), "cannot map " << path);
+
+    local_header_t header = {{'f', 'l', 'e', 'c', 's', 'i', 'l', 't'},
+      version, std::uint64_t(comm_size), std::uint64_t(comm_rank),
+      records.size(), bytes, 0};
+    std::memcpy(own.data, &header, sizeof(header));
+
+    unsigned char * p = own.data + sizeof(header);
+    for(const auto & record : records) {
+      local_record_t r = {record.first->fid, record.first->storage_class,
+        record.second.second};
+      std::memcpy(p, &r, sizeof(r));
+      p += sizeof(r);
+      if(r.bytes > 0)
+        std::memcpy(p, record.second.first, r.bytes);
+      p += local_padded(r.bytes);
+    } // for
+
+    // Mark the file complete once its contents are written.
+    header.complete = 1;
+    std::memcpy(own.data, &header, sizeof(header));
+    msync(own.data, own.size, MS_ASYNC);
+
+    if(comm_size > 1) {
+      const auto partners = local_partners(comm_rank, comm_size);
+      const int partner = partners.first;
+      const int source = partners.second;
+
+      std::uint64_t send_size = bytes, recv_size = 0;
+      MPI_Sendrecv(&send_size, 1, MPI_UINT64_T, partner, local_tag,
+        &recv_size, 1, MPI_UINT64_T, source, local_tag, MPI_COMM_WORLD,
+        MPI_STATUS_IGNORE);
+
+      local_mapping_t copy;
+      const std::string copy_path =
+        local_file_name(file_name_in, source, true);
+      clog_assert(
+        copy.create(copy_path, recv_size), "cannot map " << copy_path);
+
+      std::vector<MPI_Request> requests;
+      post_local_transfer(own.data, bytes, partner, true, requests);
+      post_local_transfer(copy.data, recv_size, source, false, requests);
+      MPI_Waitall(
+        int(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+      msync(copy.data, copy.size, MS_ASYNC);
+    } // if
+
+    if(local_flush_interval > 0 &&
+       ++local_checkpoints_ % size_t(local_flush_interval) == 0) {
+      checkpoint_all_fields_async(file_name_in);
+      last_flushed_local_ = file_name_in;
+    } // if
+  } // checkpoint_all_fields_local
+
+  /*!
+    Recover all fields from the local tier. Each rank maps its own file
+    and copies the data back into the storage of the fields. A rank that
+    lost its file, e.g., because it was restarted on another node,
+    receives the copy of its partner instead.
+
+    @return Whether all ranks found their data. Otherwise the fields are
+            not modified, and the HDF5 checkpoint should be recovered.
+   */
+
+  bool recover_all_fields_local(const std::string & file_name_in) {
+    execution::timeline_scope_t scope(execution::timeline_kind_t::recover);
+    wait_checkpoint();
+    execution::mpi_task_scheduler_t::instance().fence();
+
+    int comm_rank, comm_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &comm_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+
+    local_mapping_t own;
+    int found =
+      own.open_file(local_file_name(file_name_in, comm_rank, false)) &&
+      valid_local(own.data, own.size, comm_size, comm_rank);
+    const unsigned char * data = found ? own.data : nullptr;
+    std::vector<unsigned char> received;
+
+    if(comm_size > 1) {
+      const auto partners = local_partners(comm_rank, comm_size);
+      const int partner = partners.first;
+      const int source = partners.second;
+
+      std::vector<int> found_all(comm_size);
+      MPI_Allgather(
+        &found, 1, MPI_INT, found_all.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+      // Send the copy that we hold to its rank if that rank lost its file.
+      std::vector<MPI_Request> requests;
+      local_mapping_t copy;
+      std::uint64_t copy_size = 0;
+      if(!found_all[source]) {
+        if(copy.open_file(local_file_name(file_name_in, source, true)) &&
+           valid_local(copy.data, copy.size, comm_size, source))
+          copy_size = copy.size;
+        requests.emplace_back();
+        MPI_Isend(&copy_size, 1, MPI_UINT64_T, source, local_tag,
+          MPI_COMM_WORLD, &requests.back());
+        post_local_transfer(copy.data, copy_size, source, true, requests);
+      } // if
+
+      if(!found) {
+        std::uint64_t size = 0;
+        MPI_Recv(&size, 1, MPI_UINT64_T, partner, local_tag, MPI_COMM_WORLD,
+          MPI_STATUS_IGNORE);
+        received.resize(size);
+        post_local_transfer(received.data(), size, partner, false, requests);
+      } // if
+
+      MPI_Waitall(
+        int(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+
+      if(!found && !received.empty()) {
+        found = valid_local(
+          received.data(), received.size(), comm_size, comm_rank);
+        data = received.data();
+      } // if
+    } // if
+
+    MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if(!found)
+      return false;
+
+    auto & context = execution::context_t::instance();
+    auto & field_data = context.registered_field_data();
+    auto & sparse_field_data = context.registered_sparse_field_data();
+    std::map<size_t, const execution::context_t::field_info_t *> infos;
+    for(const auto & info : context.registered_fields())
+      infos[info.fid] = &info;
+
+    local_header_t header;
+    std::memcpy(&header, data, sizeof(header));
+    const unsigned char * p = data + sizeof(header);
+    for(size_t i = 0; i < header.num_fields; ++i) {
+      local_record_t r;
+      std::memcpy(&r, p, sizeof(r));
+      p += sizeof(r);
+
+      auto it = infos.find(r.fid);
+      clog_assert(it != infos.end(),
+        "field " << r.fid << " of the local checkpoint is not registered");
+      const auto & info = *it->second;
+      instantiate_field(info);
+
+      if(info.storage_class == data::dense) {
+        auto & dense = field_data.at(info.fid);
+        clog_assert(r.bytes == dense.size(),
+          "field " << info.fid << " does not match the local checkpoint");
+        if(r.bytes > 0)
+          std::memcpy(dense.data(), p, r.bytes);
+      }
+      else {
+        auto & sparse = sparse_field_data.at(info.fid);
+        auto serdez = context.get_serdez(info.fid);
+        char * row_ptr = (char *)sparse.rows.data();
+        const char * buf_ptr = (const char *)p;
+        const size_t row_vector_size = sizeof(data::row_vector_u<uint8_t>);
+        for(size_t j = 0; j < sparse.num_total; ++j) {
+          buf_ptr += serdez->deserialize(row_ptr, buf_ptr);
+          row_ptr += row_vector_size;
+        } // for
+      } // if
+
+      p += local_padded(r.bytes);
+    } // for
+
+    // The fields now match the local checkpoint. If all ranks flushed it
+    // to HDF5, it is the base of the next incremental checkpoint.
+    // Otherwise there is no base, and the next checkpoint writes all
+    // fields.
+    int flushed = last_flushed_local_ == file_name_in;
+    MPI_Allreduce(
+      MPI_IN_PLACE, &flushed, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if(flushed)
+      last_checkpoint_ = file_name_in;
+    else
+      last_checkpoint_.clear();
+    last_checkpoint_epoch_ = context.write_epoch();
+    return true;
+  } // recover_all_fields_local
+
+  /*!
+    Start a checkpoint of all fields without waiting for it to be
+    written. The field data are copied into a staging area, which is
+    then written to the checkpoint file by a dedicated I/O thread, on
+    its own communicator, while the computation continues.
+
+    If a checkpoint is still being written, and another one is waiting
+    for it, this blocks until the first one is done. If MPI does not
+    provide MPI_THREAD_MULTIPLE, the snapshot is written immediately.
+
+    Call wait_checkpoint() to make sure that a checkpoint is complete.
+   */
+
+  void checkpoint_all_fields_async(const std::string & file_name_in) {
+    checkpoint_fields_async(file_name_in, false);
+  } // checkpoint_all_fields_async
+
+  /*!
+    Start an incremental checkpoint without waiting for it to be
+    written. See checkpoint_modified_fields().
+   */
+
+  void checkpoint_modified_fields_async(const std::string & file_name_in) {
+    checkpoint_fields_async(file_name_in, true);
+  } // checkpoint_modified_fields_async
+
+  void checkpoint_fields_async(const std::string & file_name_in,
+    bool incremental) {
+    execution::timeline_scope_t scope(execution::timeline_kind_t::checkpoint);
+    create_hdf5_comm();
+
+    // Staging does not call HDF5, which may be busy on the I/O thread.
+    start_async();
+    auto & async = *async_;
+
+    // Take the storage of a previous snapshot, once at most one
+    // checkpoint is in flight.
+    staged_checkpoint_t checkpoint;
+    {
+      std::unique_lock<std::mutex> lock(async.mutex);
+      async.cv.wait(
+        lock, [&] { return async.queue.size() + async.busy < 2; });
+      checkpoint = std::move(async.spare);
+    }
+
+    snapshot_all_fields(file_name_in, checkpoint, true, incremental);
+
+    if(!async.threaded) {
+      write_checkpoint(checkpoint, mpi_hdf5_comm, aggregation_);
+      async.spare = std::move(checkpoint);
+      return;
+    } // if
+
+    std::lock_guard<std::mutex> lock(async.mutex);
+    async.queue.push_back(std::move(checkpoint));
+    async.cv.notify_all();
+  } // checkpoint_fields_async
+
+  /*!
+    Wait until all asynchronous checkpoints have been written.
+   */
+
+  void wait_checkpoint() {
+    if(!async_)
+      return;
+
+    auto & async = *async_;
+    std::unique_lock<std::mutex> lock(async.mutex);
+    async.cv.wait(lock, [&] { return async.queue.empty() && !async.busy; });
+  } // wait_checkpoint
+
+  /*!
+    Copy the data of all registered fields into a staging area. If copy
+    is false, dense fields are referenced instead, and must not change
+    until the snapshot is written. If incremental, only the fields that
+    were modified since the last checkpoint are staged, and the snapshot
+    is based on that checkpoint.
+   */
+
+  void snapshot_all_fields(const std::string & file_name_in,
+    staged_checkpoint_t & checkpoint,
+    bool copy = true,
+    bool incremental = false) {
+    // The snapshot must see the results of all launched tasks.
+    execution::mpi_task_scheduler_t::instance().fence();
+
+    auto & context = execution::context_t::instance();
+    const auto & field_data = context.registered_field_data();
+    const auto & sparse_field_data = context.registered_sparse_field_data();
+    const auto & field_info = context.registered_fields();
+
+    checkpoint.file_name = file_name_in + std::to_string(new_color);
+    checkpoint.attributes = {{"version", version},
+      {"world_size", std::uint64_t(world_size)},
+      {"ranks_per_file", std::uint64_t(ranks_per_file)}};
+
+    incremental = incremental && !last_checkpoint_.empty();
+    checkpoint.base = incremental ? last_checkpoint_ : std::string();
+
+    // All ranks of a file must write the same fields.
+    std::vector<int> modified(field_info.size(), 1);
+    if(incremental) {
+      for(size_t i = 0; i < field_info.size(); ++i) {
+        modified[i] =
+          context.field_write_epoch(field_info[i].fid) > last_checkpoint_epoch_;
+      } // for
+
+      MPI_Allreduce(MPI_IN_PLACE, modified.data(), int(modified.size()),
+        MPI_INT, MPI_LOR, mpi_hdf5_comm);
+    } // if
+
+    last_checkpoint_ = file_name_in;
+    last_checkpoint_epoch_ = context.write_epoch();
+
+    size_t f = 0;
+    for(size_t i = 0; i < field_info.size(); ++i) {
+      const auto & info = field_info[i];
+      if(info.storage_class != data::dense &&
+         info.storage_class != data::ragged &&
+         info.storage_class != data::sparse)
+        continue;
+
+      if(!modified[i])
+        continue;
+
+      auto & staged = next_staged(checkpoint, f, dataset_name(info));
+      staged.scalar_type = field_scalar_type(info);
+      staged.attributes = {{"storage_class", info.storage_class},
+        {"entry_size", info.size},
+        {"scalar_type", size_t(info.scalar_type)}};
+      staged.compression = checkpoint_compression(
+        context.field_attribute<data::compression_t>(info),
+        lossy_checkpoints);
+
+      if(info.storage_class != data::dense) {
+        auto & data = sparse_field_data.at(info.fid);
+        serialize_ragged(data.rows, data.num_total, info.fid, staged.buffer);
+        staged.count = staged.buffer.size();
+      }
+      else {
+        auto & data = field_data.at(info.fid);
+        staged.count = data.size() / staged.type_size();
+        if(copy) {
+          staged.buffer.assign(data.begin(), data.end());
+        }
+        else {
+          staged.external = data.data();
+        } // if
+      } // if
+    } // for
+
+    stage_restart_metadata(checkpoint, f);
+    checkpoint.fields.resize(f);
+  } // snapshot_all_fields
+
+  /*!
+    Return the next field of a staging area, whose storage is reused.
+   */
+
+  staged_field_t & next_staged(staged_checkpoint_t & checkpoint,
+    size_t & f,
+    const std::string & dataset_name) {
+    if(checkpoint.fields.size() <= f)
+      checkpoint.fields.resize(f + 1);
+    auto & staged = checkpoint.fields[f++];
+    staged.dataset_name = dataset_name;
+    staged.external = nullptr;
+    staged.attributes.clear();
+    staged.compression = {};
+    return staged;
+  } // next_staged
+
+  /*!
+    Stage the metadata that is needed to restart on a different number
+    of ranks. For each index space with fields, the group of the index
+    space holds the global ids of the local entities, of which the first
+    "owned" ones are exclusive or shared.
+
+    @param checkpoint The staging area.
+    @param f          The index of the next staged field, which is
+                      advanced past the metadata.
+   */
+
+  void stage_restart_metadata(staged_checkpoint_t & checkpoint, size_t & f) {
+    auto & context = execution::context_t::instance();
+
+    for(auto is : checkpointed_index_spaces()) {
+      const auto & color_info = context.coloring_info(is).at(context.color());
+      const auto & index_map = context.index_map(is);
+      const std::string group = index_space_group(is);
+
+      auto & owned = next_staged(checkpoint, f, group + "/owned");
+      const std::uint64_t num_owned = color_info.exclusive + color_info.shared;
+      owned.scalar_type = data::scalar_type_t::uint64;
+      owned.count = 1;
+      owned.buffer.resize(sizeof(std::uint64_t));
+      std::memcpy(owned.buffer.data(), &num_owned, sizeof(std::uint64_t));
+
+      auto & gids = next_staged(checkpoint, f, group + "/gids");
+      gids.scalar_type = data::scalar_type_t::uint64;
+      gids.count = index_map.size();
+      gids.buffer.resize(index_map.size() * sizeof(std::uint64_t));
+      auto gid = reinterpret_cast<std::uint64_t *>(gids.buffer.data());
+      for(const auto & entry : index_map)
+        gid[entry.first] = entry.second;
+    } // for
+  } // stage_restart_metadata
+
+  /*!
+    Return the index spaces that have checkpointed fields.
+   */
+
+  std::set<size_t> checkpointed_index_spaces() {
+    auto & context = execution::context_t::instance();
+    std::set<size_t> index_spaces;
+
+    for(const auto & info : context.registered_fields()) {
+      if(info.storage_class == data::dense ||
+         info.storage_class == data::ragged ||
+         info.storage_class == data::sparse)
+        index_spaces.insert(info.index_space);
+    } // for
+
+    return index_spaces;
+  } // checkpointed_index_spaces
+
+  /*!
+    Allocate the storage of a field if it does not exist yet.
+   */
+
+  void instantiate_field(const execution::context_t::field_info_t & info) {
+    auto & context = execution::context_t::instance();
+    const size_t fid = info.fid;
+    const size_t is = info.index_space;
+    const auto & color_info = context.coloring_info(is).at(context.color());
+
+    if(info.storage_class == data::dense) {
+      auto & field_data = context.registered_field_data();
+      if(field_data.find(fid) == field_data.end()) {
+        size_t size = info.size * (color_info.exclusive + color_info.shared +
+                                    color_info.ghost);
+        context.register_field_data(
+          fid, size, context.field_attribute<data::placement_t>(info));
+      } // if
+    }
+    else {
+      auto & sparse_field_data = context.registered_sparse_field_data();
+      if(sparse_field_data.find(fid) == sparse_field_data.end()) {
+        const auto & is_info = context.sparse_index_space_info_map().at(is);
+        context.register_sparse_field_data(
+          fid, info.size, color_info, is_info.max_entries_per_index);
+      } // if
+    } // if
+  } // instantiate_field
+
+  /*!
+    Write a snapshot to its checkpoint file. Only the aggregators open
+    the file.
+   */
+
+  void write_checkpoint(const staged_checkpoint_t & checkpoint,
+    MPI_Comm comm,
+    const aggregation_t & aggregation) {
+    execution::timeline_scope_t scope(
+      execution::timeline_kind_t::checkpoint_write);
+    hid_t hdf5_file_id = -1;
+    bool return_val = false;
+    const bool aggregator = aggregation.aggregators != MPI_COMM_NULL;
+
+    if(aggregator) {
+      return_val = create_hdf5_file(
+        hdf5_file_id, checkpoint.file_name, aggregation.aggregators);
+      assert(return_val);
+
+      for(const auto & attribute : checkpoint.attributes) {
+        write_attribute(hdf5_file_id, ".", attribute.first, attribute.second);
+      } // for
+
+      if(!checkpoint.base.empty())
+        write_attribute(hdf5_file_id, ".", "base", checkpoint.base);
+    } // if
+
+    for(const auto & staged : checkpoint.fields) {
+      write_field(hdf5_file_id, staged, comm, aggregation);
+    } // for
+
+    if(aggregator) {
+      return_val = close_hdf5_file(hdf5_file_id, aggregation.aggregators);
+      assert(return_val);
+    } // if
+  } // write_checkpoint
+
+  /*!
+    Start the I/O thread, if MPI and HDF5 allow it. HDF5 must be built
+    threadsafe, because the application may use it while a checkpoint is
+    written; the policy itself only calls HDF5 from the main thread after
+    wait_checkpoint().
+   */
+
+  void start_async() {
+    if(async_)
+      return;
+
+    async_.reset(new async_state_t);
+
+    // initialize HDF5 library before any thread uses it
+    herr_t status = H5open();
+    assert(status == 0);
+
+    int provided;
+    MPI_Query_thread(&provided);
+
+    if(provided < MPI_THREAD_MULTIPLE) {
+      clog_tag_guard(io);
+      clog_one(warn) << "MPI_THREAD_MULTIPLE is not available: "
+                     << "asynchronous checkpoints are written synchronously"
+                     << std::endl;
+      return;
+    } // if
+
+    hbool_t threadsafe = false;
+    H5is_library_threadsafe(&threadsafe);
+
+    if(!threadsafe) {
+      clog_tag_guard(io);
+      clog_one(warn) << "HDF5 is not threadsafe: "
+                     << "asynchronous checkpoints are written synchronously"
+                     << std::endl;
+      return;
+    } // if
+
+    async_->threaded = true;
+    MPI_Comm_dup(mpi_hdf5_comm, &async_->comm);
+    async_->aggregation = create_aggregation(async_->comm);
+    async_->thread = std::thread(&mpi_policy_t::drain_async, this);
+  } // start_async
+
+  /*!
+    Wait for the outstanding checkpoints and stop the I/O thread.
+   */
+
+  void stop_async() {
+    if(!async_)
+      return;
+
+    if(async_->threaded) {
+      {
+        std::lock_guard<std::mutex> lock(async_->mutex);
+        async_->done = true;
+        async_->cv.notify_all();
+      }
+
+      async_->thread.join();
+
+      free_aggregation(async_->aggregation);
+      int finalized;
+      MPI_Finalized(&finalized);
+      if(!finalized)
+        MPI_Comm_free(&async_->comm);
+    } // if
+
+    async_.reset();
+  } // stop_async
+
+  /*!
+    Main loop of the I/O thread. The remaining checkpoints are written
+    before the thread stops.
+   */
+
+  void drain_async() {
+    auto & async = *async_;
+    std::unique_lock<std::mutex> lock(async.mutex);
+
+    while(true) {
+      async.cv.wait(lock, [&] { return async.done || !async.queue.empty(); });
+
+      if(async.queue.empty())
+        return;
+
+      auto checkpoint = std::move(async.queue.front());
+      async.queue.pop_front();
+      async.busy = true;
+
+      lock.unlock();
+      write_checkpoint(checkpoint, async.comm, async.aggregation);
+      lock.lock();
+
+      async.spare = std::move(checkpoint);
+      async.busy = false;
+      async.cv.notify_all();
+    } // while
+  } // drain_async
+
+  /*!
+    Return the name of a file of the local checkpoint tier: the file of
+    a rank, or the copy of it held by its partner. The suffixes keep
+    them apart from the HDF5 files of the same checkpoint.
+   */
+
+  std::string local_file_name(const std::string & file_name_in,
+    int comm_rank,
+    bool partner_copy) const {
+    return local_directory + "/" + file_name_in + std::to_string(comm_rank) +
+           (partner_copy ? ".partner" : ".local");
+  } // local_file_name
+
+  static size_t local_padded(size_t bytes) {
+    return (bytes + 7) / 8 * 8;
+  } // local_padded
+
+  /*!
+    Check that a local checkpoint was completely written by the given
+    rank of a run with the same number of ranks.
+   */
+
+  static bool valid_local(const unsigned char * data,
+    size_t size,
+    int comm_size,
+    int comm_rank) {
+    local_header_t header;
+    if(data == nullptr || size < sizeof(header))
+      return false;
+    std::memcpy(&header, data, sizeof(header));
+    return std::memcmp(header.magic, "flecsilt", 8) == 0 &&
+           header.version == version &&
+           header.world_size == std::uint64_t(comm_size) &&
+           header.rank == std::uint64_t(comm_rank) && header.bytes == size &&
+           header.complete == 1;
+  } // valid_local
+
+  /*!
+    Return the partner of a rank, which holds the copy of its local
+    checkpoint, and the rank whose copy it holds in turn. The ranks are
+    ordered by node, and each rank's partner is the rank that follows it
+    in that order by the size of the largest node. This is a rotation,
+    so every rank holds exactly one copy, and the partner is on another
+    node unless a single node has more than half of the ranks. The
+    nodes need not have the same size, nor contiguous ranks.
+   */
+
+  std::pair<int, int> local_partners(int comm_rank, int comm_size) {
+    if(local_partners_.first < 0) {
+      MPI_Comm node_comm;
+      MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
+        MPI_INFO_NULL, &node_comm);
+      int node_size, node_id;
+      MPI_Comm_size(node_comm, &node_size);
+      MPI_Allreduce(&comm_rank, &node_id, 1, MPI_INT, MPI_MIN, node_comm);
+      MPI_Comm_free(&node_comm);
+
+      // Identify each node by its lowest rank.
+      std::vector<int> node_ids(comm_size);
+      MPI_Allgather(
+        &node_id, 1, MPI_INT, node_ids.data(), 1, MPI_INT, MPI_COMM_WORLD);
+      int max_node_size;
+      MPI_Allreduce(
+        &node_size, &max_node_size, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+      std::vector<int> order(comm_size);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(),
+        [&](int a, int b) { return node_ids[a] < node_ids[b]; });
+
+      // If all ranks share a node, the partner is just the next rank.
+      const int shift = max_node_size < comm_size ? max_node_size : 1;
+      const int position =
+        std::find(order.begin(), order.end(), comm_rank) - order.begin();
+      local_partners_ = {order[(position + shift) % comm_size],
+        order[(position - shift + comm_size) % comm_size]};
+
+      clog_assert(2 * max_node_size > comm_size ||
+                    node_ids[local_partners_.first] != node_id,
+        "local checkpoint partner on the same node as " << comm_rank);
+    } // if
+    return local_partners_;
+  } // local_partners
+
+  /*!
+    Post the nonblocking transfer of a buffer, in pieces whose size fits
+    in an MPI count. The pieces of the matching transfer on the peer are
+    posted in the same order, so that they match one to one.
+   */
+
+  static void post_transfer(void * data,
+    size_t bytes,
+    int peer,
+    int tag,
+    MPI_Comm comm,
+    bool send,
+    std::vector<MPI_Request> & requests) {
+    const size_t piece = size_t(1) << 30;
+    unsigned char * p = static_cast<unsigned char *>(data);
+    for(size_t offset = 0; offset < bytes; offset += piece) {
+      const int count = int(std::min(piece, bytes - offset));
+      requests.emplace_back();
+      if(send)
+        MPI_Isend(p + offset, count, MPI_BYTE, peer, tag, comm,
+          &requests.back());
+      else
+        MPI_Irecv(p + offset, count, MPI_BYTE, peer, tag, comm,
+          &requests.back());
+    } // for
+  } // post_transfer
+
+  /*!
+    Post the nonblocking transfer of a local checkpoint.
+   */
+
+  static void post_local_transfer(void * data,
+    size_t bytes,
+    int peer,
+    bool send,
+    std::vector<MPI_Request> & requests) {
+    post_transfer(
+      data, bytes, peer, local_tag, MPI_COMM_WORLD, send, requests);
+  } // post_local_transfer
+
+  /*!
+    The version of the layout of the checkpoint files, which is stored
+    as an attribute of their root group.
+   */
+
+  static constexpr std::uint64_t version = 2;
+
+  /*!
+    The size of the chunks of the datasets, in bytes.
+   */
+
+  hsize_t chunk_bytes = hsize_t(1) << 20;
+
+  /*!
+    Whether lossy field compression is applied to checkpoints. By
+    default, lossy fields are compressed losslessly in checkpoints, so
+    that a restart reproduces the state exactly.
+   */
+
+  bool lossy_checkpoints = false;
+
   int ranks_per_file = 1;
+
+  /*!
+    The number of consecutive ranks of a file whose data are written by
+    one aggregator. With one, all ranks write. With zero, there is one
+    aggregator per shared-memory node.
+   */
+
+  int ranks_per_aggregator = 1;
   int nb_files;
 
   int world_size, rank, new_world_size, new_rank;
@@ -566,7 +2311,39 @@ struct mpi_policy_t {
   int new_color;
   int nb_new_comms;
 
-  MPI_Comm mpi_hdf5_comm;
+  MPI_Comm mpi_hdf5_comm = MPI_COMM_NULL;
+  int hdf5_comm_ranks_per_file = 0;
+  int hdf5_comm_ranks_per_aggregator = 0;
+  aggregation_t aggregation_;
+
+  std::unique_ptr<async_state_t> async_;
+
+  /*!
+    The directory of the files of the local checkpoint tier, which
+    should be on node-local storage.
+   */
+
+  std::string local_directory = "/tmp";
+
+  /*!
+    Every local_flush_interval-th local checkpoint is also written to
+    HDF5 in the background. With zero, local checkpoints are not
+    flushed.
+   */
+
+  int local_flush_interval = 0;
+
+  // The MPI tag of the transfers of local checkpoints.
+  static constexpr int local_tag = 0x10ca1;
+
+  size_t local_checkpoints_ = 0;
+  std::string last_flushed_local_;
+  std::pair<int, int> local_partners_ = {-1, -1};
+  std::vector<std::vector<unsigned char>> local_buffers_;
+
+  // The last checkpoint, and the write epoch of its data.
+  std::string last_checkpoint_;
+  size_t last_checkpoint_epoch_ = 0;
 }; // struct mpi_policy_t
 
 } // namespace io
@@ -0,0 +1,470 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <cinchlog.h>
+#include <hdf5.h>
+#include <mpi.h>
+
+#include <flecsi/data/common/scalar_type.h>
+#include <flecsi/data/dense_accessor.h>
+#include <flecsi/io/hdf5_compression.h>
+#include <flecsi/io/hdf5_type.h>
+#include <flecsi/io/mpi/policy.h>
+#include <flecsi/topology/partition.h>
+
+namespace flecsi {
+namespace io {
+
+/*!
+  The xdmf_writer_u type writes a mesh topology and dense fields on it
+  for visualization. The data are written in parallel to one HDF5 file,
+  which is described by an XDMF file of the same name with the
+  extension ".xmf".
+
+  The vertices and the cells of the mesh are written once. Each step
+  then only appends the fields, which are written from their storage,
+  without copies. The XDMF file is rewritten at the end of each step,
+  so that it describes all steps that are complete.
+
+  Fields are compressed as registered with flecsi_set_field_attribute,
+  including lossy compression, which is meant for such output.
+
+  The methods are collective over the communicator, and must be called
+  by all ranks from the same index task. Each rank writes its owned
+  cells, and all its vertices, including ghost vertices, so that the
+  cells only refer to local vertices. The vertices of a cell must be in
+  the order that XDMF expects.
+
+  @tparam DIMENSION The topological dimension of the cells, i.e., 2 or 3.
+  @tparam DOMAIN    The domain of the cells and vertices.
+ */
+
+template<size_t DIMENSION, size_t DOMAIN = 0>
+class xdmf_writer_u
+{
+  static_assert(DIMENSION == 2 || DIMENSION == 3,
+    "xdmf_writer_u supports two- and three-dimensional meshes");
+
+public:
+  /*!
+    Constructor.
+
+    @param name The name of the files, without extension.
+    @param comm The communicator of the ranks that write.
+   */
+
+  xdmf_writer_u(const std::string & name, MPI_Comm comm = MPI_COMM_WORLD)
+    : name_(name), comm_(comm) {
+    MPI_Comm_rank(comm_, &rank_);
+
+    hid_t file_access_plist_id = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_mpio(file_access_plist_id, comm_, MPI_INFO_NULL);
+    file_ = H5Fcreate((name_ + ".h5").c_str(), H5F_ACC_TRUNC, H5P_DEFAULT,
+      file_access_plist_id);
+    H5Pclose(file_access_plist_id);
+    clog_assert(file_ >= 0, "cannot create " << name_ << ".h5");
+  } // xdmf_writer_u
+
+  /// Copy constructor (disabled)
+  xdmf_writer_u(const xdmf_writer_u &) = delete;
+
+  /// Assignment operator (disabled)
+  xdmf_writer_u & operator=(const xdmf_writer_u &) = delete;
+
+  ~xdmf_writer_u() {
+    H5Fclose(file_);
+  } // ~xdmf_writer_u
+
+  /*!
+    Write the coordinates of the vertices and the connectivity of the
+    cells. The entities of the vertices must provide coordinates().
+   */
+
+  template<typename MESH>
+  void write_mesh(MESH & mesh) {
+    clog_assert(topology_.path.empty(), "the mesh was already written");
+
+    // Number the local vertices of all ranks consecutively.
+    num_vertices_ = mesh.template num_entities<0, DOMAIN>();
+    std::uint64_t first_vertex = 0;
+    std::uint64_t local = num_vertices_;
+    MPI_Exscan(&local, &first_vertex, 1, MPI_UINT64_T, MPI_SUM, comm_);
+    if(rank_ == 0)
+      first_vertex = 0;
+
+    std::vector<double> coordinates;
+    coordinates.reserve(num_vertices_ * DIMENSION);
+    size_t id = 0;
+    for(auto v : mesh.template entities<0, DOMAIN>()) {
+      clog_assert(v.id() == id++, "vertices are not stored in order");
+      const auto & p = v->coordinates();
+      coordinates.insert(coordinates.end(), p.begin(), p.begin() + DIMENSION);
+    } // for
+
+    // The owned cells come first in the storage of cell fields.
+    std::vector<std::uint64_t> cells;
+    std::uint64_t min_vertices = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_vertices = 0;
+    num_cells_ = 0;
+    for(auto c : mesh.template entities<DIMENSION, DOMAIN>(owned)) {
+      clog_assert(c.id() == num_cells_++, "owned cells are not stored first");
+      std::uint64_t count = 0;
+      for(auto v : mesh.template entities<0, DOMAIN>(c)) {
+        cells.push_back(first_vertex + v.id());
+        ++count;
+      } // for
+      min_vertices = std::min(min_vertices, count);
+      max_vertices = std::max(max_vertices, count);
+    } // for
+
+    MPI_Allreduce(
+      MPI_IN_PLACE, &min_vertices, 1, MPI_UINT64_T, MPI_MIN, comm_);
+    MPI_Allreduce(
+      MPI_IN_PLACE, &max_vertices, 1, MPI_UINT64_T, MPI_MAX, comm_);
+
+    geometry_ = write_dataset("mesh/geometry", coordinates.data(),
+      num_vertices_, DIMENSION);
+
+    if(min_vertices == max_vertices) {
+      topology_type_ = topology_type(max_vertices);
+      topology_ = write_dataset(
+        "mesh/topology", cells.data(), num_cells_, max_vertices);
+    }
+    else {
+      // Polygons of different sizes are described by a mixed topology,
+      // in which each cell is preceded by its type and size.
+      clog_assert(DIMENSION == 2,
+        "cells of different types are only supported in two dimensions");
+      std::vector<std::uint64_t> mixed;
+      mixed.reserve(cells.size() + 2 * num_cells_);
+      auto vertex = cells.begin();
+      for(auto c : mesh.template entities<DIMENSION, DOMAIN>(owned)) {
+        const auto count = mesh.template entities<0, DOMAIN>(c).size();
+        mixed.push_back(polygon);
+        mixed.push_back(count);
+        mixed.insert(mixed.end(), vertex, vertex + count);
+        vertex += count;
+      } // for
+
+      topology_type_ = "Mixed";
+      topology_ = write_dataset("mesh/topology", mixed.data(), mixed.size(), 1);
+    } // if
+
+    num_elements_ = num_cells_;
+    MPI_Allreduce(
+      MPI_IN_PLACE, &num_elements_, 1, MPI_UINT64_T, MPI_SUM, comm_);
+  } // write_mesh
+
+  /*!
+    Start a step.
+
+    @param time The simulation time of the step.
+   */
+
+  void begin_step(double time) {
+    clog_assert(!topology_.path.empty(), "the mesh must be written first");
+    steps_.push_back({time, {}});
+  } // begin_step
+
+  /*!
+    Write the values of a field on the owned cells.
+   */
+
+  template<typename T, size_t EP, size_t SP, size_t GP>
+  void write_cell_field(const std::string & name,
+    const dense_accessor_u<T, EP, SP, GP> & field) {
+    clog_assert(field.exclusive_size() + field.shared_size() == num_cells_,
+      "field " << name << " is not defined on the cells");
+    write_field(name, "Cell", field.handle.combined_data, num_cells_,
+      field_compression(field.handle.fid));
+  } // write_cell_field
+
+  /*!
+    Write the values of a field on the vertices, including ghost
+    vertices, whose values must be current.
+   */
+
+  template<typename T, size_t EP, size_t SP, size_t GP>
+  void write_vertex_field(const std::string & name,
+    const dense_accessor_u<T, EP, SP, GP> & field) {
+    clog_assert(field.size() == num_vertices_,
+      "field " << name << " is not defined on the vertices");
+    write_field(name, "Node", field.handle.combined_data, num_vertices_,
+      field_compression(field.handle.fid));
+  } // write_vertex_field
+
+  /*!
+    Finish a step, and describe it in the XDMF file.
+   */
+
+  void end_step() {
+    clog_assert(!steps_.empty(), "no step was started");
+    H5Fflush(file_, H5F_SCOPE_GLOBAL);
+    if(rank_ == 0)
+      write_xdmf();
+  } // end_step
+
+private:
+  /*!
+    A dataset, as described in the XDMF file.
+   */
+
+  struct data_item_t {
+    std::string path;
+    data::scalar_type_t type;
+    hsize_t rows;
+    hsize_t columns;
+  }; // struct data_item_t
+
+  struct attribute_t {
+    std::string name;
+    std::string center;
+    data_item_t data;
+  }; // struct attribute_t
+
+  struct step_t {
+    double time;
+    std::vector<attribute_t> attributes;
+  }; // struct step_t
+
+  // The XDMF identifier of polygons in mixed topologies.
+  static constexpr std::uint64_t polygon = 3;
+
+  // The size of the chunks of compressed datasets, in bytes.
+  static constexpr hsize_t chunk_bytes = hsize_t(1) << 20;
+
+  /*!
+    Return the registered compression of a field.
+   */
+
+  static data::compression_t field_compression(field_id_t fid) {
+    auto & context = execution::context_t::instance();
+    for(const auto & info : context.registered_fields()) {
+      if(info.fid == fid)
+        return context.field_attribute<data::compression_t>(info);
+    } // for
+    return {};
+  } // field_compression
+
+  template<typename T>
+  void write_field(const std::string & name,
+    const char * center,
+    const T * values,
+    hsize_t count,
+    const data::compression_t & compression) {
+    clog_assert(!steps_.empty(), "no step was started");
+    constexpr auto type = data::scalar_type_u<T>::value;
+    static_assert(type != data::scalar_type_t::opaque,
+      "the values of fields must be arithmetic, or arrays thereof");
+
+    const std::string path =
+      "step_" + std::to_string(steps_.size() - 1) + "/" + name;
+    steps_.back().attributes.push_back({name, center,
+      write_dataset(path, values, count,
+        sizeof(T) / data::scalar_type_size(type), compression)});
+  } // write_field
+
+  /*!
+    Write the rows of a dataset that belong to this rank, after the rows
+    of the lower ranks. Compressed datasets are chunked like checkpoint
+    datasets, and filtered as they are written.
+   */
+
+  template<typename T>
+  data_item_t write_dataset(const std::string & path,
+    const T * values,
+    hsize_t rows,
+    hsize_t columns,
+    const data::compression_t & compression = {}) {
+    constexpr auto type = data::scalar_type_u<T>::value;
+
+    std::uint64_t local = rows, first = 0, total = 0;
+    MPI_Exscan(&local, &first, 1, MPI_UINT64_T, MPI_SUM, comm_);
+    if(rank_ == 0)
+      first = 0;
+    MPI_Allreduce(&local, &total, 1, MPI_UINT64_T, MPI_SUM, comm_);
+
+    const int ndims = columns == 1 ? 1 : 2;
+    hsize_t dims[2] = {total, columns};
+    hsize_t offset[2] = {first, 0};
+    hsize_t count[2] = {rows, columns};
+
+    hid_t file_dataspace_id = H5Screate_simple(ndims, dims, NULL);
+    hid_t link_creation_plist_id = H5Pcreate(H5P_LINK_CREATE);
+    H5Pset_create_intermediate_group(link_creation_plist_id, 1);
+
+    hid_t dataset_creation_plist_id = H5Pcreate(H5P_DATASET_CREATE);
+    if(compression.mode != data::compression_t::none && total > 0) {
+      const hsize_t chunk_rows = std::max<hsize_t>(1, chunk_bytes / sizeof(T));
+      hsize_t chunk[2] = {std::min<hsize_t>(total, chunk_rows), columns};
+      H5Pset_chunk(dataset_creation_plist_id, ndims, chunk);
+      set_hdf5_compression(
+        dataset_creation_plist_id, hdf5_type(type), compression);
+    } // if
+
+    hid_t dataset_id = H5Dcreate2(file_, path.c_str(), hdf5_type(type),
+      file_dataspace_id, link_creation_plist_id, dataset_creation_plist_id,
+      H5P_DEFAULT);
+    H5Pclose(link_creation_plist_id);
+    H5Pclose(dataset_creation_plist_id);
+    clog_assert(dataset_id >= 0, "cannot create dataset " << path);
+
+    hid_t mem_dataspace_id = H5Screate_simple(ndims, count, NULL);
+    if(rows == 0) {
+      H5Sselect_none(mem_dataspace_id);
+      H5Sselect_none(file_dataspace_id);
+    }
+    else {
+      H5Sselect_hyperslab(
+        file_dataspace_id, H5S_SELECT_SET, offset, NULL, count, NULL);
+    } // if
+
+    hid_t xfer_plist_id = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(xfer_plist_id, H5FD_MPIO_COLLECTIVE);
+    herr_t status = H5Dwrite(dataset_id, hdf5_type(type), mem_dataspace_id,
+      file_dataspace_id, xfer_plist_id, values);
+    clog_assert(status >= 0, "cannot write dataset " << path);
+
+    H5Pclose(xfer_plist_id);
+    H5Sclose(mem_dataspace_id);
+    H5Sclose(file_dataspace_id);
+    H5Dclose(dataset_id);
+
+    return {path, type, total, columns};
+  } // write_dataset
+
+  static std::string topology_type(std::uint64_t vertices) {
+    if(DIMENSION == 2) {
+      switch(vertices) {
+        case 3:
+          return "Triangle";
+        case 4:
+          return "Quadrilateral";
+        default:
+          return "Polygon";
+      } // switch
+    } // if
+
+    switch(vertices) {
+      case 4:
+        return "Tetrahedron";
+      case 5:
+        return "Pyramid";
+      case 6:
+        return "Wedge";
+      case 8:
+        return "Hexahedron";
+      default:
+        clog_error("unsupported cells with " << vertices << " vertices");
+        return "";
+    } // switch
+  } // topology_type
+
+  static std::string attribute_type(hsize_t columns) {
+    switch(columns) {
+      case 1:
+        return "Scalar";
+      case 3:
+        return "Vector";
+      case 6:
+        return "Tensor6";
+      case 9:
+        return "Tensor";
+      default:
+        return "Matrix";
+    } // switch
+  } // attribute_type
+
+  void write_data_item(std::ostream & stream, const data_item_t & item) {
+    static const char * number_types[] = {"UChar", "Char", "UChar", "Int",
+      "UInt", "Int", "UInt", "Int", "UInt", "Float", "Float"};
+
+    // The HDF5 file is referred to relative to the XDMF file.
+    const std::string file = name_.substr(name_.find_last_of('/') + 1);
+
+    stream << "<DataItem Dimensions=\"" << item.rows;
+    if(item.columns != 1)
+      stream << " " << item.columns;
+    stream << "\" NumberType=\"" << number_types[size_t(item.type)]
+           << "\" Precision=\"" << data::scalar_type_size(item.type)
+           << "\" Format=\"HDF\">" << file << ".h5:/" << item.path
+           << "</DataItem>\n";
+  } // write_data_item
+
+  void write_xdmf() {
+    std::ofstream stream(name_ + ".xmf");
+    stream << "<?xml version=\"1.0\" ?>\n"
+           << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n"
+           << "<Xdmf Version=\"2.0\">\n<Domain>\n"
+           << "<Grid Name=\"mesh\" GridType=\"Collection\" "
+           << "CollectionType=\"Temporal\">\n";
+
+    for(size_t s = 0; s < steps_.size(); ++s) {
+      stream << "<Grid Name=\"step_" << s << "\" GridType=\"Uniform\">\n"
+             << "<Time Value=\"" << steps_[s].time << "\"/>\n"
+             << "<Topology TopologyType=\"" << topology_type_
+             << "\" NumberOfElements=\"" << num_elements_ << "\"";
+      if(topology_type_ != "Mixed")
+        stream << " NodesPerElement=\"" << topology_.columns << "\"";
+      stream << ">\n";
+      write_data_item(stream, topology_);
+      stream << "</Topology>\n"
+             << "<Geometry GeometryType=\"" << (DIMENSION == 2 ? "XY" : "XYZ")
+             << "\">\n";
+      write_data_item(stream, geometry_);
+      stream << "</Geometry>\n";
+
+      for(const auto & attribute : steps_[s].attributes) {
+        stream << "<Attribute Name=\"" << attribute.name
+               << "\" AttributeType=\""
+               << attribute_type(attribute.data.columns) << "\" Center=\""
+               << attribute.center << "\">\n";
+        write_data_item(stream, attribute.data);
+        stream << "</Attribute>\n";
+      } // for
+
+      stream << "</Grid>\n";
+    } // for
+
+    stream << "</Grid>\n</Domain>\n</Xdmf>\n";
+  } // write_xdmf
+
+  std::string name_;
+  MPI_Comm comm_;
+  int rank_;
+  hid_t file_;
+
+  size_t num_vertices_ = 0;
+  size_t num_cells_ = 0;
+  std::uint64_t num_elements_ = 0;
+  std::string topology_type_;
+  data_item_t topology_;
+  data_item_t geometry_;
+  std::vector<step_t> steps_;
+
+}; // class xdmf_writer_u
+
+} // namespace io
+} // namespace flecsi
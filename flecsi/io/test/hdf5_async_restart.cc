@@ -0,0 +1,203 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+///
+/// \file
+/// \date Initial file creation: Oct 19, 2026
+///
+
+#include <chrono>
+#include <cmath>
+#include <string>
+
+#include <cinchtest.h>
+
+#include <flecsi/io/io_interface.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/test_mesh_2d.h>
+
+using namespace flecsi;
+using namespace supplemental;
+using mesh_t = flecsi::supplemental::test_mesh_2d_t;
+
+//---------------------------------------------------------------------------//
+// FleCSI tasks
+//---------------------------------------------------------------------------//
+
+void
+write_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<int, rw, rw, na> f1,
+  sparse_mutator<double> f2) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells(flecsi::owned)) {
+    auto id = map.at(c.id());
+    f1(c) = id;
+    if(id % 2 == 0) {
+      f2(c, 0) = 100 * id;
+      f2(c, 2) = 100 * id + 2;
+    }
+    else {
+      f2(c, 1) = 100 * id + 1;
+    }
+  }
+} // write_task
+
+void
+clear_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<int, rw, rw, na> f1,
+  sparse_mutator<double> f2) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells(flecsi::owned)) {
+    auto id = map.at(c.id());
+    f1(c) = 0;
+    if(id % 2 == 0) {
+      f2.erase(c, 0);
+      f2.erase(c, 2);
+    }
+    else {
+      f2.erase(c, 1);
+    }
+  }
+} // clear_task
+
+void
+read_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<int, ro, ro, ro> f1,
+  sparse_accessor<double, ro, ro, ro> f2) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells()) {
+    auto id = map.at(c.id());
+    ASSERT_EQ(f1(c), id);
+    if(id % 2 == 0) {
+      ASSERT_EQ(f2(c, 0), 100 * id);
+      ASSERT_EQ(f2(c, 2), 100 * id + 2);
+    }
+    else {
+      ASSERT_EQ(f2(c, 1), 100 * id + 1);
+    }
+  }
+} // read_task
+
+flecsi_register_task_simple(write_task, loc, index);
+flecsi_register_task_simple(clear_task, loc, index);
+flecsi_register_task_simple(read_task, loc, index);
+
+//---------------------------------------------------------------------------//
+// Data client registration
+//---------------------------------------------------------------------------//
+flecsi_register_data_client(mesh_t, meshes, mesh1);
+
+//---------------------------------------------------------------------------//
+// Fields
+//---------------------------------------------------------------------------//
+flecsi_register_field(mesh_t, fields, x, int, dense, 1, cells);
+flecsi_register_field(mesh_t, fields, y, double, sparse, 1, cells);
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+namespace flecsi {
+namespace execution {
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  supplemental::do_test_mesh_2d_coloring();
+
+  context_t::sparse_index_space_info_t isi;
+  isi.index_space = index_spaces::cells;
+  isi.max_entries_per_index = 10;
+  isi.exclusive_reserve = 8192;
+  context_t::instance().set_sparse_index_space_info(isi);
+} // specialization_tlt_init
+
+void
+specialization_spmd_init(int argc, char ** argv) {
+  auto mh = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+  flecsi_execute_task(initialize_mesh, flecsi::supplemental, index, mh);
+} // specialization_spmd_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+// Stand-in for the computation that overlaps with a checkpoint.
+double
+compute(size_t n) {
+  double sum = 0.0;
+  for(size_t i = 0; i < n; ++i)
+    sum += std::sqrt(double(i));
+  return sum;
+} // compute
+
+void
+driver(int argc, char ** argv) {
+
+  auto & context = execution::context_t::instance();
+  io::io_interface_t cp_io;
+  cp_io.ranks_per_file = 2;
+  std::string sync_file{"restart_sync.rst."};
+  std::string async_file{"restart_async.rst."};
+
+  auto ch = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+
+  auto hx = flecsi_get_handle(ch, fields, x, int, dense, 0);
+  auto hym = flecsi_get_mutator(ch, fields, y, double, sparse, 0, 2);
+
+  flecsi_execute_task_simple(write_task, index, ch, hx, hym);
+
+  using clock_t = std::chrono::steady_clock;
+  const size_t work = 1 << 24;
+
+  // Synchronous checkpoint followed by computation.
+  auto t0 = clock_t::now();
+  cp_io.checkpoint_all_fields(sync_file);
+  auto t1 = clock_t::now();
+  double sum = compute(work);
+  auto t2 = clock_t::now();
+
+  // Asynchronous checkpoint overlapped with the same computation. The
+  // fields are cleared while the snapshot is being written.
+  cp_io.checkpoint_all_fields_async(async_file);
+  auto t3 = clock_t::now();
+  flecsi_execute_task_simple(clear_task, index, ch, hx, hym);
+  sum += compute(work);
+  auto t4 = clock_t::now();
+  cp_io.wait_checkpoint();
+  auto t5 = clock_t::now();
+
+  auto seconds = [](clock_t::time_point a, clock_t::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+  };
+
+  if(context.color() == 0) {
+    std::cout << "sync checkpoint: " << seconds(t0, t1)
+              << " s, sync total: " << seconds(t0, t2) << " s" << std::endl
+              << "async snapshot: " << seconds(t2, t3)
+              << " s, async wait: " << seconds(t4, t5)
+              << " s, async total: " << seconds(t2, t5) << " s"
+              << " (" << sum << ")" << std::endl;
+  } // if
+
+  // The asynchronous checkpoint holds the values at the time of the
+  // call, not the cleared ones.
+  cp_io.recover_all_fields(async_file);
+
+  auto hy = flecsi_get_handle(ch, fields, y, double, sparse, 0);
+  flecsi_execute_task_simple(read_task, index, ch, hx, hy);
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(async_restart, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
@@ -0,0 +1,132 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+///
+/// \file
+/// \date Initial file creation: Oct 19, 2026
+///
+
+#include <cstdint>
+#include <vector>
+
+#include <cinchtest.h>
+
+#include <flecsi/io/mpi/policy.h>
+
+#include <chrono>
+#include <cmath>
+
+using namespace flecsi;
+
+// The fields of the finite difference tests, on a larger mesh, are
+// written without compression, with lossless compression, and with
+// lossy compression. The throughput and the compression ratio of each
+// are reported.
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+constexpr size_t N = 1024;
+constexpr double error_bound = 1.e-6;
+
+double
+field_value(size_t field, double x, double y) {
+  switch(field) {
+    case 0:
+      return sin(x) * y + 0.5 * cos(2.0 * y);
+    case 1:
+      return cos(x) * y;
+    default:
+      return sin(x) - sin(2.0 * y);
+  } // switch
+} // field_value
+
+} // namespace
+
+TEST(hdf5_compression, finite_difference_fields) {
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // Each rank owns a block of rows of the mesh.
+  const size_t first = N * rank / size;
+  const size_t last = N * (rank + 1) / size;
+  const hsize_t count = (last - first) * N;
+
+  const char * field_names[] = {"f", "fx", "fy"};
+  std::vector<std::vector<double>> fields(3, std::vector<double>(count));
+  for(size_t field = 0; field < 3; ++field) {
+    for(size_t i = first; i < last; ++i) {
+      for(size_t j = 0; j < N; ++j) {
+        double x = (double)j / (double)(N - 1) * 2.0 * pi;
+        double y = (double)i / (double)(N - 1) * 2.0 * pi;
+        fields[field][(i - first) * N + j] = field_value(field, x, y);
+      } // for
+    } // for
+  } // for
+
+  const std::pair<const char *, data::compression_t> modes[] = {
+    {"none", data::compression_t{}},
+    {"lossless", data::compression_t::make_lossless()},
+    {"lossy", data::compression_t::make_lossy(error_bound)}};
+
+  io::mpi_policy_t policy;
+  for(const auto & mode : modes) {
+    const std::string file_name =
+      std::string("compression_") + mode.first + ".h5";
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    auto start = std::chrono::steady_clock::now();
+
+    hid_t file = -1;
+    ASSERT_TRUE(policy.create_hdf5_file(file, file_name, MPI_COMM_WORLD));
+    for(size_t field = 0; field < 3; ++field) {
+      ASSERT_TRUE(policy.create_hdf5_dataset(file, field_names[field],
+        H5T_NATIVE_DOUBLE, N * N, MPI_COMM_WORLD, mode.second));
+      ASSERT_TRUE(policy.write_data_to_hdf5(file, field_names[field],
+        H5T_NATIVE_DOUBLE, fields[field].data(), count, first * N,
+        MPI_COMM_WORLD));
+    } // for
+    ASSERT_TRUE(policy.close_hdf5_file(file, MPI_COMM_WORLD));
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start)
+                       .count();
+
+    ASSERT_TRUE(policy.open_hdf5_file(file, file_name, MPI_COMM_WORLD));
+    hsize_t stored = 0;
+    for(size_t field = 0; field < 3; ++field) {
+      hid_t dataset = H5Dopen2(file, field_names[field], H5P_DEFAULT);
+      stored += H5Dget_storage_size(dataset);
+      H5Dclose(dataset);
+
+      std::vector<double> values(count);
+      ASSERT_TRUE(policy.read_data_from_hdf5(file, field_names[field],
+        H5T_NATIVE_DOUBLE, values.data(), count, first * N, MPI_COMM_WORLD));
+
+      for(hsize_t i = 0; i < count; ++i) {
+        if(mode.second.mode == data::compression_t::lossy) {
+          ASSERT_LE(std::abs(values[i] - fields[field][i]), error_bound);
+        }
+        else {
+          ASSERT_EQ(values[i], fields[field][i]);
+        } // if
+      } // for
+    } // for
+    ASSERT_TRUE(policy.close_hdf5_file(file, MPI_COMM_WORLD));
+
+    const double bytes = 3.0 * N * N * sizeof(double);
+    if(rank == 0) {
+      std::cout << mode.first << ": " << bytes / seconds / (1 << 20)
+                << " MiB/s, ratio " << bytes / stored << std::endl;
+    } // if
+  } // for
+} // TEST
+
+/*~-------------------------------------------------------------------------~-*
+ * Formatting options
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~-------------------------------------------------------------------------~-*/
@@ -0,0 +1,203 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+///
+/// \file
+/// \date Initial file creation: Oct 19, 2026
+///
+
+#include <string>
+
+#include <cinchtest.h>
+#include <hdf5.h>
+
+#include <flecsi/io/io_interface.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/test_mesh_2d.h>
+
+using namespace flecsi;
+using namespace supplemental;
+using mesh_t = flecsi::supplemental::test_mesh_2d_t;
+
+//---------------------------------------------------------------------------//
+// FleCSI tasks
+//---------------------------------------------------------------------------//
+
+void
+write_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<int, rw, rw, na> f1,
+  sparse_mutator<double> f2) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells(flecsi::owned)) {
+    auto id = map.at(c.id());
+    f1(c) = id;
+    if(id % 2 == 0) {
+      f2(c, 0) = 100 * id;
+      f2(c, 2) = 100 * id + 2;
+    }
+    else {
+      f2(c, 1) = 100 * id + 1;
+    }
+  }
+} // write_task
+
+void
+clear_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<int, rw, rw, na> f1,
+  sparse_mutator<double> f2) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells(flecsi::owned)) {
+    auto id = map.at(c.id());
+    f1(c) = 0;
+    if(id % 2 == 0) {
+      f2.erase(c, 0);
+      f2.erase(c, 2);
+    }
+    else {
+      f2.erase(c, 1);
+    }
+  }
+} // clear_task
+
+void
+read_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<int, ro, ro, ro> f1,
+  sparse_accessor<double, ro, ro, ro> f2) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells()) {
+    auto id = map.at(c.id());
+    ASSERT_EQ(f1(c), id);
+    if(id % 2 == 0) {
+      ASSERT_EQ(f2(c, 0), 100 * id);
+      ASSERT_EQ(f2(c, 2), 100 * id + 2);
+    }
+    else {
+      ASSERT_EQ(f2(c, 1), 100 * id + 1);
+    }
+  }
+} // read_task
+
+void
+init_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<double, rw, rw, na> f3) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells(flecsi::owned)) {
+    f3(c) = 0.5 * map.at(c.id());
+  }
+} // init_task
+
+void
+check_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<double, ro, ro, ro> f3) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells()) {
+    ASSERT_EQ(f3(c), 0.5 * map.at(c.id()));
+  }
+} // check_task
+
+flecsi_register_task_simple(write_task, loc, index);
+flecsi_register_task_simple(init_task, loc, index);
+flecsi_register_task_simple(check_task, loc, index);
+flecsi_register_task_simple(clear_task, loc, index);
+flecsi_register_task_simple(read_task, loc, index);
+
+//---------------------------------------------------------------------------//
+// Data client registration
+//---------------------------------------------------------------------------//
+flecsi_register_data_client(mesh_t, meshes, mesh1);
+
+//---------------------------------------------------------------------------//
+// Fields
+//---------------------------------------------------------------------------//
+flecsi_register_field(mesh_t, fields, x, int, dense, 1, cells);
+flecsi_register_field(mesh_t, fields, y, double, sparse, 1, cells);
+flecsi_register_field(mesh_t, fields, z, double, dense, 1, cells);
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+namespace flecsi {
+namespace execution {
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  supplemental::do_test_mesh_2d_coloring();
+
+  context_t::sparse_index_space_info_t isi;
+  isi.index_space = index_spaces::cells;
+  isi.max_entries_per_index = 10;
+  isi.exclusive_reserve = 8192;
+  context_t::instance().set_sparse_index_space_info(isi);
+} // specialization_tlt_init
+
+void
+specialization_spmd_init(int argc, char ** argv) {
+  auto mh = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+  flecsi_execute_task(initialize_mesh, flecsi::supplemental, index, mh);
+} // specialization_spmd_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+
+  io::io_interface_t cp_io;
+  cp_io.ranks_per_file = 2;
+
+  auto ch = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+
+  auto hx = flecsi_get_handle(ch, fields, x, int, dense, 0);
+  auto hym = flecsi_get_mutator(ch, fields, y, double, sparse, 0, 2);
+  auto hz = flecsi_get_handle(ch, fields, z, double, dense, 0);
+
+  // The first checkpoint has all fields, the second only x and y.
+  flecsi_execute_task_simple(init_task, index, ch, hz);
+  flecsi_execute_task_simple(write_task, index, ch, hx, hym);
+  cp_io.checkpoint_modified_fields("incremental_0.rst.");
+
+  flecsi_execute_task_simple(clear_task, index, ch, hx, hym);
+  flecsi_execute_task_simple(write_task, index, ch, hx, hym);
+  cp_io.checkpoint_modified_fields("incremental_1.rst.");
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Barrier(MPI_COMM_WORLD);
+  if(rank == 0) {
+    const std::string group =
+      "index_space_" + std::to_string(index_spaces::cells);
+    hid_t file = H5Fopen("incremental_1.rst.0", H5F_ACC_RDONLY, H5P_DEFAULT);
+    ASSERT_TRUE(
+      cp_io.has_dataset(file, group + "/fid_" + std::to_string(hx.fid)));
+    ASSERT_FALSE(
+      cp_io.has_dataset(file, group + "/fid_" + std::to_string(hz.fid)));
+    H5Fclose(file);
+  } // if
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  flecsi_execute_task_simple(clear_task, index, ch, hx, hym);
+  cp_io.recover_all_fields("incremental_1.rst.");
+
+  auto hy = flecsi_get_handle(ch, fields, y, double, sparse, 0);
+  flecsi_execute_task_simple(read_task, index, ch, hx, hy);
+  flecsi_execute_task_simple(check_task, index, ch, hz);
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(restart, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
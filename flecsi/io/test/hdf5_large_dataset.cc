@@ -0,0 +1,80 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+///
+/// \file
+/// \date Initial file creation: Oct 19, 2026
+///
+
+#include <cstdint>
+#include <vector>
+
+#include <cinchtest.h>
+
+#include <flecsi/io/mpi/policy.h>
+
+using namespace flecsi;
+
+// The datasets are larger than 2^32 bytes, but only a few chunks are
+// written, so that the file is sparse.
+
+TEST(hdf5_large_dataset, extents) {
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  io::mpi_policy_t policy;
+  const std::string file_name = "large_dataset.h5";
+
+  const hsize_t nbytes = (hsize_t(5) << 30) + 3;
+  const hsize_t nwords = (hsize_t(3) << 30) + 5;
+  const hsize_t count = 1000;
+
+  // not aligned with the chunks
+  const hsize_t byte_displ = (hsize_t(1) << 32) + 7 + rank * count;
+  const hsize_t word_displ = (hsize_t(1) << 31) + 3 + rank * count;
+
+  std::vector<unsigned char> bytes(count);
+  std::vector<std::uint64_t> words(count);
+  for(hsize_t i = 0; i < count; ++i) {
+    bytes[i] = (unsigned char)(byte_displ + i);
+    words[i] = word_displ + i;
+  } // for
+
+  hid_t file = -1;
+  ASSERT_TRUE(policy.create_hdf5_file(file, file_name, MPI_COMM_WORLD));
+  ASSERT_TRUE(policy.create_hdf5_dataset(
+    file, "index_space_0/bytes", H5T_NATIVE_UCHAR, nbytes, MPI_COMM_WORLD));
+  ASSERT_TRUE(policy.create_hdf5_dataset(
+    file, "index_space_0/words", H5T_NATIVE_UINT64, nwords, MPI_COMM_WORLD));
+  ASSERT_TRUE(policy.write_data_to_hdf5(file, "index_space_0/bytes",
+    H5T_NATIVE_UCHAR, bytes.data(), count, byte_displ, MPI_COMM_WORLD));
+  ASSERT_TRUE(policy.write_data_to_hdf5(file, "index_space_0/words",
+    H5T_NATIVE_UINT64, words.data(), count, word_displ, MPI_COMM_WORLD));
+  ASSERT_TRUE(policy.close_hdf5_file(file, MPI_COMM_WORLD));
+
+  ASSERT_TRUE(policy.open_hdf5_file(file, file_name, MPI_COMM_WORLD));
+
+  hid_t dataset = H5Dopen2(file, "index_space_0/bytes", H5P_DEFAULT);
+  hid_t space = H5Dget_space(dataset);
+  ASSERT_EQ(nbytes, hsize_t(H5Sget_simple_extent_npoints(space)));
+  H5Sclose(space);
+  H5Dclose(dataset);
+
+  std::vector<unsigned char> bytes_in(count);
+  std::vector<std::uint64_t> words_in(count);
+  ASSERT_TRUE(policy.read_data_from_hdf5(file, "index_space_0/bytes",
+    H5T_NATIVE_UCHAR, bytes_in.data(), count, byte_displ, MPI_COMM_WORLD));
+  ASSERT_TRUE(policy.read_data_from_hdf5(file, "index_space_0/words",
+    H5T_NATIVE_UINT64, words_in.data(), count, word_displ, MPI_COMM_WORLD));
+  ASSERT_TRUE(policy.close_hdf5_file(file, MPI_COMM_WORLD));
+
+  ASSERT_EQ(bytes, bytes_in);
+  ASSERT_EQ(words, words_in);
+} // TEST
+
+/*~-------------------------------------------------------------------------~-*
+ * Formatting options
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~-------------------------------------------------------------------------~-*/
@@ -0,0 +1,139 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+///
+/// \file
+/// \date Initial file creation: Oct 19, 2026
+///
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <cinchtest.h>
+
+#include <flecsi/io/io_interface.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/test_mesh_2d.h>
+
+using namespace flecsi;
+using namespace supplemental;
+using mesh_t = flecsi::supplemental::test_mesh_2d_t;
+
+// Every cell holds a block of just over 32 MiB, so that the 64 cells of
+// the 8x8 mesh are written to a dataset of more than 2^31 bytes.
+using block_t = std::array<std::uint64_t, (size_t(1) << 22) + 1>;
+
+static_assert(64 * sizeof(block_t) > size_t(1) << 31,
+  "the dataset must be larger than 2^31 bytes");
+
+//---------------------------------------------------------------------------//
+// FleCSI tasks
+//---------------------------------------------------------------------------//
+
+void
+write_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<block_t, rw, rw, na> f) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells(flecsi::owned)) {
+    const std::uint64_t id = map.at(c.id());
+    auto & block = f(c);
+    for(size_t i = 0; i < block.size(); ++i)
+      block[i] = id * block.size() + i;
+  }
+} // write_task
+
+void
+clear_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<block_t, rw, rw, na> f) {
+  for(auto c : mesh.cells(flecsi::owned)) {
+    f(c).fill(0);
+  }
+} // clear_task
+
+void
+read_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<block_t, ro, ro, ro> f) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells()) {
+    const std::uint64_t id = map.at(c.id());
+    const auto & block = f(c);
+    size_t mismatches = 0;
+    for(size_t i = 0; i < block.size(); ++i)
+      mismatches += block[i] != id * block.size() + i;
+    ASSERT_EQ(mismatches, 0);
+  }
+} // read_task
+
+flecsi_register_task_simple(write_task, loc, index);
+flecsi_register_task_simple(clear_task, loc, index);
+flecsi_register_task_simple(read_task, loc, index);
+
+//---------------------------------------------------------------------------//
+// Data client registration
+//---------------------------------------------------------------------------//
+flecsi_register_data_client(mesh_t, meshes, mesh1);
+
+//---------------------------------------------------------------------------//
+// Fields
+//---------------------------------------------------------------------------//
+flecsi_register_field(mesh_t, fields, x, block_t, dense, 1, cells);
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+namespace flecsi {
+namespace execution {
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  supplemental::do_test_mesh_2d_coloring();
+} // specialization_tlt_init
+
+void
+specialization_spmd_init(int argc, char ** argv) {
+  auto mh = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+  flecsi_execute_task(initialize_mesh, flecsi::supplemental, index, mh);
+} // specialization_spmd_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+
+  // All ranks write to one file, whose dataset is larger than 2^31 bytes
+  // and has offsets beyond 2^31 bytes.
+  io::io_interface_t cp_io;
+  cp_io.ranks_per_file = 2;
+  std::string outfile{"large_restart.rst."};
+
+  auto ch = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+  auto hx = flecsi_get_handle(ch, fields, x, block_t, dense, 0);
+
+  flecsi_execute_task_simple(write_task, index, ch, hx);
+
+  cp_io.checkpoint_all_fields(outfile);
+
+  flecsi_execute_task_simple(clear_task, index, ch, hx);
+
+  cp_io.recover_all_fields(outfile);
+
+  flecsi_execute_task_simple(read_task, index, ch, hx);
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(large_restart, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
@@ -0,0 +1,185 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+///
+/// \file
+/// \date Initial file creation: Oct 19, 2026
+///
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cinchtest.h>
+#include <hdf5.h>
+
+#include <flecsi/execution/mpi/rebalance.h>
+#include <flecsi/io/io_interface.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/test_mesh_2d.h>
+
+using namespace flecsi;
+using namespace supplemental;
+using mesh_t = flecsi::supplemental::test_mesh_2d_t;
+
+//---------------------------------------------------------------------------//
+// FleCSI tasks
+//---------------------------------------------------------------------------//
+
+void
+write_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<int, rw, rw, na> f1,
+  sparse_mutator<double> f2,
+  dense_accessor<double, rw, rw, na> f3) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells(flecsi::owned)) {
+    f1(c) = map.at(c.id());
+    f2(c, map.at(c.id()) % 2) = 2 * map.at(c.id());
+    f3(c) = 0.5 * map.at(c.id());
+  }
+} // write_task
+
+flecsi_register_task_simple(write_task, loc, index);
+
+//---------------------------------------------------------------------------//
+// Data client registration
+//---------------------------------------------------------------------------//
+flecsi_register_data_client(mesh_t, meshes, mesh1);
+
+//---------------------------------------------------------------------------//
+// Fields
+//---------------------------------------------------------------------------//
+flecsi_register_field(mesh_t, fields, x, int, dense, 1, cells);
+flecsi_register_field(mesh_t, fields, y, double, sparse, 1, cells);
+flecsi_register_field(mesh_t, fields, z, double, dense, 1, cells);
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+namespace flecsi {
+namespace execution {
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  supplemental::do_test_mesh_2d_coloring();
+
+  context_t::sparse_index_space_info_t isi;
+  isi.index_space = index_spaces::cells;
+  isi.max_entries_per_index = 10;
+  isi.exclusive_reserve = 8192;
+  context_t::instance().set_sparse_index_space_info(isi);
+} // specialization_tlt_init
+
+void
+specialization_spmd_init(int argc, char ** argv) {
+  auto mh = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+  flecsi_execute_task(initialize_mesh, flecsi::supplemental, index, mh);
+} // specialization_spmd_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+  constexpr size_t width = 16;
+
+  io::io_interface_t cp_io;
+  cp_io.ranks_per_file = 2;
+
+  auto & context = execution::context_t::instance();
+  const int rank = context.color();
+  int size;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  auto ch = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+
+  auto hx = flecsi_get_handle(ch, fields, x, int, dense, 0);
+  auto hym = flecsi_get_mutator(ch, fields, y, double, sparse, 0, 2);
+  auto hz = flecsi_get_handle(ch, fields, z, double, dense, 0);
+
+  flecsi_execute_task_simple(write_task, index, ch, hx, hym, hz);
+  auto hy = flecsi_get_handle(ch, fields, y, double, sparse, 0);
+  cp_io.checkpoint_modified_fields("rebalance_0.rst.");
+
+  // Hand the owned cells of each rank to the next one. No task writes
+  // the fields after this, but every one of them is laid out anew.
+  const auto & info = context.coloring_info(cells).at(rank);
+  const size_t num_owned = info.exclusive + info.shared;
+
+  coloring::crs_t connectivity;
+  for(size_t i(0); i < num_owned; ++i) {
+    const size_t id = context.index_map(cells).at(i);
+    const size_t row = id / width, col = id % width;
+
+    std::vector<size_t> neighbors;
+    if(col > 0)
+      neighbors.push_back(id - 1);
+    if(col < width - 1)
+      neighbors.push_back(id + 1);
+    if(row > 0)
+      neighbors.push_back(id - width);
+    if(row < width - 1)
+      neighbors.push_back(id + width);
+
+    connectivity.append(neighbors.begin(), neighbors.end());
+  } // for
+
+  rebalance(
+    cells, std::vector<size_t>(num_owned, (rank + 1) % size), connectivity);
+
+  // The incremental checkpoint must hold every migrated field, since the
+  // layout of the base checkpoint no longer matches the storage.
+  cp_io.checkpoint_modified_fields("rebalance_1.rst.");
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  if(rank == 0) {
+    const std::string group =
+      "index_space_" + std::to_string(index_spaces::cells);
+    hid_t file = H5Fopen("rebalance_1.rst.0", H5F_ACC_RDONLY, H5P_DEFAULT);
+    for(auto fid : {hx.fid, hy.fid, hz.fid})
+      ASSERT_TRUE(
+        cp_io.has_dataset(file, group + "/fid_" + std::to_string(fid)));
+    H5Fclose(file);
+  } // if
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  auto & field_data = context.registered_field_data();
+  std::fill(field_data[hx.fid].begin(), field_data[hx.fid].end(), 0);
+  std::fill(field_data[hz.fid].begin(), field_data[hz.fid].end(), 0);
+
+  cp_io.recover_all_fields("rebalance_1.rst.");
+
+  // Check the values in the rebalanced layout, including the ghosts.
+  const auto & map = context.index_map(cells);
+  auto xd = reinterpret_cast<int *>(field_data[hx.fid].data());
+  auto zd = reinterpret_cast<double *>(field_data[hz.fid].data());
+
+  using vector_t = data::row_vector_u<data::sparse_entry_value_u<double>>;
+  auto & yd = context.registered_sparse_field_data()[hy.fid];
+  ASSERT_EQ(yd.num_total, map.size());
+  auto yr = reinterpret_cast<vector_t *>(yd.rows.data());
+
+  for(size_t i(0); i < map.size(); ++i) {
+    const size_t id = map.at(i);
+    EXPECT_EQ(xd[i], id);
+    EXPECT_EQ(zd[i], 0.5 * id);
+    ASSERT_EQ(yr[i].size(), 1);
+    EXPECT_EQ(yr[i][0].entry, id % 2);
+    EXPECT_EQ(yr[i][0].value, 2 * id);
+  } // for
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(restart, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
@@ -0,0 +1,271 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Triad National Security, LLC
+   All rights reserved.
+                                                                              */
+
+#include <flecsi/io/io_hdf5.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <legion.h>
+#include <mpi.h>
+
+#include <cinchtest.h>
+
+#include <flecsi/execution/context.h>
+#include <flecsi/execution/legion/internal_task.h>
+
+using namespace Legion;
+
+namespace flecsi {
+namespace execution { // required by execution/runtime_driver.cc
+
+enum FieldIDs {
+  FID_X,
+  FID_N,
+  FID_G,
+};
+
+void
+fill_task(const Task * task,
+  const std::vector<PhysicalRegion> & regions,
+  Context context,
+  Runtime * runtime) {
+  Rect<1> rect = runtime->get_index_space_domain(
+    context, task->regions[0].region.get_index_space());
+  const FieldAccessor<WRITE_DISCARD, double, 1> acc_x(regions[0], FID_X);
+  const FieldAccessor<WRITE_DISCARD, int64_t, 1> acc_n(regions[0], FID_N);
+  int64_t ct = 0;
+  for(PointInRectIterator<1> pir(rect); pir(); pir++) {
+    acc_x[*pir] = 0.29 + ct;
+    acc_n[*pir] = (int64_t(1) << 40) + ct;
+    ct++;
+  }
+}
+// Register the task. The task id is automatically generated.
+flecsi_internal_register_legion_task(fill_task,
+  processor_type_t::loc,
+  single | leaf);
+
+void
+check_task(const Task * task,
+  const std::vector<PhysicalRegion> & regions,
+  Context context,
+  Runtime * runtime) {
+  Rect<1> rect = runtime->get_index_space_domain(
+    context, task->regions[0].region.get_index_space());
+  const FieldAccessor<READ_ONLY, double, 1> acc_x(regions[0], FID_X);
+  const FieldAccessor<READ_ONLY, int64_t, 1> acc_n(regions[0], FID_N);
+  int64_t ct = 0;
+  for(PointInRectIterator<1> pir(rect); pir(); pir++) {
+    ASSERT_EQ(acc_x[*pir], 0.29 + ct);
+    ASSERT_EQ(acc_n[*pir], (int64_t(1) << 40) + ct);
+    ct++;
+  }
+
+  const FieldAccessor<READ_ONLY, double, 1> acc_g(regions[1], FID_G);
+  ASSERT_EQ(acc_g[0], 3.5);
+}
+// Register the task. The task id is automatically generated.
+flecsi_internal_register_legion_task(check_task,
+  processor_type_t::loc,
+  single | leaf);
+
+void
+driver(int argc, char ** argv) {
+
+  int num_elements = 1 << 20;
+  int num_files = 16;
+  int num_checkpoints = 4;
+
+  // Check for any command line arguments
+  {
+    const InputArgs & command_args = Runtime::get_input_args();
+    for(int i = 1; i < command_args.argc; i++) {
+      if(!strcmp(command_args.argv[i], "-s"))
+        num_elements = atoi(command_args.argv[++i]);
+      if(!strcmp(command_args.argv[i], "-m"))
+        num_files = atoi(command_args.argv[++i]);
+      if(!strcmp(command_args.argv[i], "-c"))
+        num_checkpoints = atoi(command_args.argv[++i]);
+    }
+  }
+
+  Runtime * runtime = Runtime::get_runtime();
+  Context ctx = Runtime::get_context();
+  context_t & flecsi_context = context_t::instance();
+
+  Rect<1> elem_rect(0, num_elements - 1);
+  IndexSpace is = runtime->create_index_space(ctx, elem_rect);
+  IndexSpace global_is = runtime->create_index_space(ctx, Rect<1>(0, 0));
+  FieldSpace input_fs = runtime->create_field_space(ctx);
+  {
+    FieldAllocator allocator = runtime->create_field_allocator(ctx, input_fs);
+    allocator.allocate_field(sizeof(double), FID_X);
+    allocator.allocate_field(sizeof(int64_t), FID_N);
+  }
+  FieldSpace global_fs = runtime->create_field_space(ctx);
+  {
+    FieldAllocator allocator = runtime->create_field_allocator(ctx, global_fs);
+    allocator.allocate_field(sizeof(double), FID_G);
+  }
+
+  Rect<1> file_color_bounds(0, num_files - 1);
+  IndexSpace file_is = runtime->create_index_space(ctx, file_color_bounds);
+  IndexPartition file_ip = runtime->create_equal_partition(ctx, is, file_is);
+
+  LogicalRegion input_lr = runtime->create_logical_region(ctx, is, input_fs);
+  LogicalRegion output_lr = runtime->create_logical_region(ctx, is, input_fs);
+  LogicalRegion input_global_lr =
+    runtime->create_logical_region(ctx, global_is, global_fs);
+  LogicalRegion output_global_lr =
+    runtime->create_logical_region(ctx, global_is, global_fs);
+
+  LogicalPartition input_lp =
+    runtime->get_logical_partition(ctx, input_lr, file_ip);
+  LogicalPartition output_lp =
+    runtime->get_logical_partition(ctx, output_lr, file_ip);
+
+  auto regions = [&](LogicalRegion lr, LogicalPartition lp,
+                   LogicalRegion global_lr) {
+    std::vector<io::hdf5_region_t> hdf5_region_vector;
+    io::hdf5_region_t data(lr, lp, "data");
+    data.field_string_map[FID_X] = "FID_X";
+    data.field_string_map[FID_N] = "FID_N";
+    hdf5_region_vector.push_back(data);
+    io::hdf5_region_t global(global_lr, LogicalPartition::NO_PART, "global");
+    global.field_string_map[FID_G] = "FID_G";
+    hdf5_region_vector.push_back(global);
+    return hdf5_region_vector;
+  };
+
+  std::vector<io::hdf5_region_t> cp_vector =
+    regions(input_lr, input_lp, input_global_lr);
+  std::vector<io::hdf5_region_t> re_vector =
+    regions(output_lr, output_lp, output_global_lr);
+
+  // The attached regions of the policy are destroyed with it, before the
+  // regions and index spaces of the test.
+  {
+    int my_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    io::io_interface_t cp_io;
+    io::hdf5_t attach_task_file =
+      cp_io.init_hdf5_file("attach_task_checkpoint.dat", num_files);
+    io::hdf5_t leaf_task_file =
+      cp_io.init_hdf5_file("leaf_task_checkpoint.dat", num_files);
+    io::hdf5_t attached_file =
+      cp_io.init_hdf5_file("attached_checkpoint.dat", num_files);
+    for(io::hdf5_t * file :
+      {&attach_task_file, &leaf_task_file, &attached_file}) {
+      cp_io.add_regions(*file, cp_vector);
+      if(my_rank == 0) {
+        cp_io.generate_hdf5_files(*file);
+      }
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    const auto tid_fill =
+      flecsi_context.task_id<flecsi_internal_task_key(fill_task)>();
+
+    {
+      RegionRequirement req(input_lr, WRITE_DISCARD, EXCLUSIVE, input_lr);
+      req.add_field(FID_X);
+      req.add_field(FID_N);
+
+      TaskLauncher fill_launcher(tid_fill, TaskArgument(nullptr, 0));
+      fill_launcher.add_region_requirement(req);
+      auto f = runtime->execute_task(ctx, fill_launcher);
+      f.wait();
+    }
+    runtime->fill_field<double>(
+      ctx, input_global_lr, input_global_lr, FID_G, 3.5);
+
+    auto time = [&](auto && checkpoint) {
+      auto start = std::chrono::steady_clock::now();
+      for(int c = 0; c < num_checkpoints; ++c) {
+        checkpoint();
+      }
+      std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+      return elapsed.count() / num_checkpoints;
+    };
+
+    double attach_task_time = time([&]() {
+      cp_io.checkpoint_data(attach_task_file, file_is, cp_vector, true);
+    });
+    double leaf_task_time = time([&]() {
+      cp_io.checkpoint_data(leaf_task_file, file_is, cp_vector, false);
+    });
+    double attached_time = time([&]() {
+      cp_io.checkpoint_data_attached(attached_file, file_is, cp_vector);
+    });
+
+    if(my_rank == 0) {
+      const double mib = num_elements * (sizeof(double) + sizeof(int64_t)) /
+                         double(1 << 20);
+      std::cout << "checkpoint of " << mib << " MiB in " << num_files
+                << " files" << std::endl
+                << "  attach task:      " << attach_task_time << " s, "
+                << mib / attach_task_time << " MiB/s" << std::endl
+                << "  leaf task:        " << leaf_task_time << " s, "
+                << mib / leaf_task_time << " MiB/s" << std::endl
+                << "  attached regions: " << attached_time << " s, "
+                << mib / attached_time << " MiB/s" << std::endl;
+    }
+
+    const auto tid_check =
+      flecsi_context.task_id<flecsi_internal_task_key(check_task)>();
+
+    auto check = [&]() {
+      RegionRequirement req(output_lr, READ_ONLY, EXCLUSIVE, output_lr);
+      req.add_field(FID_X);
+      req.add_field(FID_N);
+      RegionRequirement global_req(
+        output_global_lr, READ_ONLY, EXCLUSIVE, output_global_lr);
+      global_req.add_field(FID_G);
+
+      TaskLauncher check_launcher(tid_check, TaskArgument(nullptr, 0));
+      check_launcher.add_region_requirement(req);
+      check_launcher.add_region_requirement(global_req);
+      auto f = runtime->execute_task(ctx, check_launcher);
+      f.wait();
+    };
+
+    cp_io.recover_data_attached(attached_file, file_is, re_vector);
+    check();
+    cp_io.recover_data(leaf_task_file, file_is, re_vector, false);
+    check();
+    cp_io.recover_data(attach_task_file, file_is, re_vector, true);
+    check();
+  }
+
+  runtime->destroy_logical_region(ctx, input_lr);
+  runtime->destroy_logical_region(ctx, output_lr);
+  runtime->destroy_logical_region(ctx, input_global_lr);
+  runtime->destroy_logical_region(ctx, output_global_lr);
+  runtime->destroy_field_space(ctx, input_fs);
+  runtime->destroy_field_space(ctx, global_fs);
+  runtime->destroy_index_space(ctx, file_is);
+  runtime->destroy_index_space(ctx, is);
+  runtime->destroy_index_space(ctx, global_is);
+
+} // driver
+
+TEST(io_hdf5_attach, readwrite) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
@@ -0,0 +1,150 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <cinchtest.h>
+
+#include <flecsi/io/mpi/xdmf_writer.h>
+#include <flecsi/supplemental/coloring/add_colorings.h>
+#include <flecsi/supplemental/mesh/test_mesh_2d.h>
+
+using namespace flecsi;
+using namespace supplemental;
+using mesh_t = flecsi::supplemental::test_mesh_2d_t;
+
+//---------------------------------------------------------------------------//
+// FleCSI tasks
+//---------------------------------------------------------------------------//
+
+void
+init_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<double, rw, rw, na> f,
+  dense_accessor<double, rw, rw, rw> x) {
+  auto & context = execution::context_t::instance();
+  const auto & map = context.index_map(cells);
+  for(auto c : mesh.cells(flecsi::owned)) {
+    f(c) = map.at(c.id());
+  }
+  for(auto v : mesh.vertices()) {
+    x(v) = v->coordinates()[0];
+  }
+} // init_task
+
+void
+output_task(data_client_handle_u<mesh_t, ro> mesh,
+  dense_accessor<double, ro, ro, ro> f,
+  dense_accessor<double, ro, ro, ro> x) {
+  io::xdmf_writer_u<2> writer("xdmf_writer");
+  writer.write_mesh(mesh);
+
+  for(size_t step = 0; step < 2; ++step) {
+    writer.begin_step(0.5 * step);
+    writer.write_cell_field("f", f);
+    writer.write_vertex_field("x", x);
+    writer.end_step();
+  }
+} // output_task
+
+flecsi_register_task_simple(init_task, loc, index);
+flecsi_register_task_simple(output_task, loc, index);
+
+//---------------------------------------------------------------------------//
+// Data client registration
+//---------------------------------------------------------------------------//
+flecsi_register_data_client(mesh_t, meshes, mesh1);
+
+//---------------------------------------------------------------------------//
+// Fields
+//---------------------------------------------------------------------------//
+flecsi_register_field(mesh_t, fields, f, double, dense, 1, cells);
+flecsi_register_field(mesh_t, fields, x, double, dense, 1, vertices);
+
+//----------------------------------------------------------------------------//
+// Specialization driver.
+//----------------------------------------------------------------------------//
+
+namespace flecsi {
+namespace execution {
+
+void
+specialization_tlt_init(int argc, char ** argv) {
+  supplemental::do_test_mesh_2d_coloring();
+} // specialization_tlt_init
+
+void
+specialization_spmd_init(int argc, char ** argv) {
+  auto mh = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+  flecsi_execute_task(initialize_mesh, flecsi::supplemental, index, mh);
+} // specialization_spmd_init
+
+//----------------------------------------------------------------------------//
+// User driver.
+//----------------------------------------------------------------------------//
+
+void
+driver(int argc, char ** argv) {
+
+  auto ch = flecsi_get_client_handle(mesh_t, meshes, mesh1);
+
+  auto hf = flecsi_get_handle(ch, fields, f, double, dense, 0);
+  auto hx = flecsi_get_handle(ch, fields, x, double, dense, 0);
+
+  flecsi_execute_task_simple(init_task, index, ch, hf, hx);
+  flecsi_execute_task_simple(output_task, index, ch, hf, hx);
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Barrier(MPI_COMM_WORLD);
+  if(rank == 0) {
+    hid_t file = H5Fopen("xdmf_writer.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    ASSERT_GE(file, 0);
+
+    // 16x16 quadrilaterals
+    hsize_t dims[2];
+    hid_t dataset = H5Dopen2(file, "mesh/topology", H5P_DEFAULT);
+    hid_t space = H5Dget_space(dataset);
+    ASSERT_EQ(H5Sget_simple_extent_dims(space, dims, NULL), 2);
+    ASSERT_EQ(dims[0], hsize_t(256));
+    ASSERT_EQ(dims[1], hsize_t(4));
+    H5Sclose(space);
+    H5Dclose(dataset);
+
+    std::vector<double> f(256);
+    dataset = H5Dopen2(file, "step_1/f", H5P_DEFAULT);
+    H5Dread(
+      dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, f.data());
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    // Every cell is written once.
+    std::sort(f.begin(), f.end());
+    for(size_t i = 0; i < f.size(); ++i) {
+      ASSERT_EQ(f[i], double(i));
+    }
+
+    std::ifstream xmf("xdmf_writer.xmf");
+    std::stringstream contents;
+    contents << xmf.rdbuf();
+    ASSERT_NE(contents.str().find("TopologyType=\"Quadrilateral\""),
+      std::string::npos);
+    ASSERT_NE(contents.str().find("xdmf_writer.h5:/step_1/x"),
+      std::string::npos);
+  } // if
+
+} // driver
+
+//----------------------------------------------------------------------------//
+// TEST.
+//----------------------------------------------------------------------------//
+
+TEST(xdmf_writer, testname) {} // TEST
+
+} // namespace execution
+} // namespace flecsi
+
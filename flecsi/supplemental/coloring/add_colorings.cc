@@ -73,6 +73,13 @@ add_colorings(coloring_map_t map) {
   // Create the primary coloring.
   cells.primary = colorer->color(dcrs);
 
+  // Compute the edge cut of the primary coloring for the coloring report.
+  if(!context_.coloring_report().empty()) {
+    context_.set_edge_cut(map.cells,
+      flecsi::coloring::edge_cut(dcrs,
+        flecsi::coloring::partitioning_from_primary(dcrs, cells.primary)));
+  } // if
+
   {
     clog_tag_guard(coloring);
     clog_container_one(info, "primary coloring", cells.primary, clog::space);
@@ -81,7 +88,11 @@ add_colorings(coloring_map_t map) {
   // Compute the dependency closure of the primary cell coloring
   // through vertex intersections (specified by last argument "0").
   // To specify edge or face intersections, use 1 (edges) or 2 (faces).
-  auto closure = flecsi::topology::entity_neighbors<2, 2, 0>(sd, cells.primary);
+  // The intermediate sets are flat, so that the set algebra below is a
+  // linear merge of sorted vectors.
+  const flecsi::utils::flat_set_u<size_t> primary(cells.primary);
+  flecsi::utils::flat_set_u<size_t> closure =
+    flecsi::topology::entity_neighbors<2, 2, 0>(sd, primary);
 
   {
     clog_tag_guard(coloring);
@@ -91,8 +102,7 @@ add_colorings(coloring_map_t map) {
   // Subtracting out the initial set leaves just the nearest
   // neighbors. This is similar to the image of the adjacency
   // graph of the initial indices.
-  auto nearest_neighbors =
-    flecsi::utils::set_difference(closure, cells.primary);
+  auto nearest_neighbors = flecsi::utils::set_difference(closure, primary);
 
   {
     clog_tag_guard(coloring);
@@ -122,7 +132,7 @@ add_colorings(coloring_map_t map) {
   // here we add the next nearest neighbors. For most mesh types
   // we actually need information about the ownership of these indices
   // so that we can deterministically assign rank ownership to vertices.
-  auto nearest_neighbor_closure =
+  flecsi::utils::flat_set_u<size_t> nearest_neighbor_closure =
     flecsi::topology::entity_neighbors<2, 2, 0>(sd, nearest_neighbors);
 
   {
@@ -179,33 +189,36 @@ add_colorings(coloring_map_t map) {
     remote_info_map[i.id] = i;
   } // for
 
-  // Populate exclusive and shared cell information.
+  // Populate exclusive and shared cell information. The cells are
+  // collected first and inserted into the sorted sets all at once.
   {
+    std::vector<flecsi::coloring::entity_info_t> shared, exclusive;
+
     size_t offset(0);
     for(auto i : std::get<0>(cell_nn_info)) {
       if(i.size()) {
-        cells.shared.insert(flecsi::coloring::entity_info_t(
-          primary_indices_map[offset], rank, offset, i));
+        shared.emplace_back(primary_indices_map[offset], rank, offset, i);
 
         // Collect all colors with whom we require communication
         // to send shared information.
-        cell_color_info.shared_users =
-          flecsi::utils::set_union(cell_color_info.shared_users, i);
+        cell_color_info.shared_users.insert(i.begin(), i.end());
       }
       else {
-        cells.exclusive.insert(flecsi::coloring::entity_info_t(
-          primary_indices_map[offset], rank, offset, i));
+        exclusive.emplace_back(primary_indices_map[offset], rank, offset, i);
       } // if
       ++offset;
     } // for
+
+    cells.shared.insert(shared.begin(), shared.end());
+    cells.exclusive.insert(exclusive.begin(), exclusive.end());
   } // scope
 
   // Populate ghost cell information.
   {
-    size_t offset(0);
-    for(auto i : std::get<1>(cell_nn_info)) {
-      cells.ghost.insert(i);
+    auto & ghosts = std::get<1>(cell_nn_info);
+    cells.ghost.insert(ghosts.begin(), ghosts.end());
 
+    for(auto i : ghosts) {
       // Collect all colors with whom we require communication
       // to receive ghost information.
       cell_color_info.ghost_owners.insert(i.rank);
@@ -242,7 +255,7 @@ add_colorings(coloring_map_t map) {
 
   // Assign vertex ownership
   std::vector<std::set<size_t>> vertex_requests(size);
-  std::set<flecsi::coloring::entity_info_t> vertex_info;
+  flecsi::utils::flat_set_u<flecsi::coloring::entity_info_t> vertex_info;
 
   size_t offset(0);
   for(auto i: vertex_closure) {
@@ -309,27 +322,36 @@ add_colorings(coloring_map_t map) {
   flecsi::coloring::index_coloring_t vertices;
   coloring::coloring_info_t vertex_color_info;
 
+  {
+  std::vector<flecsi::coloring::entity_info_t> shared, exclusive;
+
   for(auto i: vertex_info) {
     if(i.shared.size()) {
-      vertices.shared.insert(i);
+      shared.push_back(i);
 
       // Collect all colors with whom we require communication
       // to send shared information.
-      vertex_color_info.shared_users = flecsi::utils::set_union(
-        vertex_color_info.shared_users, i.shared);
+      vertex_color_info.shared_users.insert(i.shared.begin(), i.shared.end());
     }
     else {
-      vertices.exclusive.insert(i);
+      exclusive.push_back(i);
     } // if
   } // for
 
+  vertices.shared.insert(shared.begin(), shared.end());
+  vertices.exclusive.insert(exclusive.begin(), exclusive.end());
+  } // scope
+
   {
+  // The requests are sorted per rank, but not overall.
+  std::vector<flecsi::coloring::entity_info_t> ghosts;
+
   size_t r(0);
   for(auto i: vertex_requests) {
 
     auto offset(vertex_offset_info[r].begin());
     for(auto s: i) {
-      vertices.ghost.insert(flecsi::coloring::entity_info_t(s, r, *offset));
+      ghosts.emplace_back(s, r, *offset);
       ++offset;
 
       // Collect all colors with whom we require communication
@@ -339,6 +361,8 @@ add_colorings(coloring_map_t map) {
 
     ++r;
   } // for
+
+  vertices.ghost.insert(ghosts.begin(), ghosts.end());
   } // scope
 
   {
@@ -64,7 +64,7 @@ color_entity(topology::mesh_definition_u<DIMENSION> const & md,
 
   // Assign entity ownership
   std::vector<std::set<size_t>> entity_requests(comm_size);
-  std::set<entity_info_t> entity_info;
+  utils::flat_set_u<entity_info_t> entity_info;
 
   {
     size_t offset(0);
@@ -138,8 +138,7 @@ color_entity(topology::mesh_definition_u<DIMENSION> const & md,
       entities.shared.insert(i);
       // Collect all colors with whom we require communication
       // to send shared information.
-      entity_color_info.shared_users =
-        flecsi::utils::set_union(entity_color_info.shared_users, i.shared);
+      entity_color_info.shared_users.insert(i.shared.begin(), i.shared.end());
     }
     // otherwise, its exclusive
     else
@@ -147,12 +146,16 @@ color_entity(topology::mesh_definition_u<DIMENSION> const & md,
   } // for
 
   {
+    // The requests are sorted per rank, but not overall, so collect the
+    // ghosts first and insert them all at once.
+    std::vector<entity_info_t> ghosts;
+
     size_t r(0);
     for(auto i : entity_requests) {
 
       auto offset(entity_offset_info[r].begin());
       for(auto s : i) {
-        entities.ghost.insert(entity_info_t(s, r, *offset));
+        ghosts.emplace_back(entity_info_t(s, r, *offset));
         // Collect all colors with whom we require communication
         // to receive ghost information.
         entity_color_info.ghost_owners.insert(r);
@@ -162,6 +165,8 @@ color_entity(topology::mesh_definition_u<DIMENSION> const & md,
 
       ++r;
     } // for
+
+    entities.ghost.insert(ghosts.begin(), ghosts.end());
   } // scope
 
 #if 0
@@ -65,14 +65,17 @@ generic_coloring(typename COLORING_POLICY::mesh_definition_t & md,
   // Create a communicator instance to get neighbor information.
   auto communicator = std::make_shared<flecsi::coloring::mpi_communicator_t>();
 
-  std::set<size_t> aggregate_near_neighbors;
-  auto core = primary;
+  // The intermediate sets are flat, so that the set algebra below is a
+  // linear merge of sorted vectors.
+  const flat_set_u<size_t> flat_primary(primary);
+  flat_set_u<size_t> aggregate_near_neighbors;
+  auto core = flat_primary;
 
   // Collect neighbors up to depth deep
   for(size_t i{0}; i < depth; ++i) {
 
     // Form the closure of the current core
-    auto closure =
+    flat_set_u<size_t> closure =
       entity_neighbors<dimension, dimension, thru_dimension>(md, core);
 
     // Subtract off just the new nearest neighbors
@@ -87,12 +90,13 @@ generic_coloring(typename COLORING_POLICY::mesh_definition_t & md,
   } // for
 
   // Form the closure of the collected neighbors
-  auto near_neighbor_closure =
+  flat_set_u<size_t> near_neighbor_closure =
     entity_neighbors<dimension, dimension, thru_dimension>(
       md, aggregate_near_neighbors);
 
   // Clean primaries from closure to get all neighbors
-  auto aggregate_neighbors = set_difference(near_neighbor_closure, primary);
+  auto aggregate_neighbors =
+    set_difference(near_neighbor_closure, flat_primary);
 
   if(rank == 0) {
     std::cout << "aggregate near neighbors" << std::endl;
@@ -157,8 +161,7 @@ generic_coloring(typename COLORING_POLICY::mesh_definition_t & md,
 
         // Collect all colors with whom we require communication
         // to send shared information.
-        primary_coloring_info.shared_users =
-          flecsi::utils::set_union(primary_coloring_info.shared_users, i);
+        primary_coloring_info.shared_users.insert(i.begin(), i.end());
       }
       else {
         primary_coloring.exclusive.insert(flecsi::coloring::entity_info_t(
@@ -205,7 +208,7 @@ generic_coloring(typename COLORING_POLICY::mesh_definition_t & md,
 
     // Assign entity ownership
     std::vector<std::set<size_t>> entity_requests(size);
-    std::set<entity_info_t> entity_info;
+    flecsi::utils::flat_set_u<entity_info_t> entity_info;
 
     {
       size_t offset{0};
@@ -272,8 +275,8 @@ generic_coloring(typename COLORING_POLICY::mesh_definition_t & md,
         aux_coloring[idx].shared.insert(i);
         // Collect all colors with whom we require communication
         // to send shared information.
-        aux_coloring_info[idx].shared_users = flecsi::utils::set_union(
-          aux_coloring_info[idx].shared_users, i.shared);
+        aux_coloring_info[idx].shared_users.insert(
+          i.shared.begin(), i.shared.end());
       }
       // otherwise, its exclusive
       else
@@ -281,12 +284,16 @@ generic_coloring(typename COLORING_POLICY::mesh_definition_t & md,
     } // for
 
     {
+      // The requests are sorted per rank, but not overall, so collect the
+      // ghosts first and insert them all at once.
+      std::vector<entity_info_t> ghosts;
+
       size_t r(0);
       for(auto i : entity_requests) {
 
         auto offset(entity_offset_info[r].begin());
         for(auto s : i) {
-          aux_coloring[idx].ghost.insert(entity_info_t(s, r, *offset));
+          ghosts.emplace_back(entity_info_t(s, r, *offset));
           // Collect all colors with whom we require communication
           // to receive ghost information.
           aux_coloring_info[idx].ghost_owners.insert(r);
@@ -296,6 +303,8 @@ generic_coloring(typename COLORING_POLICY::mesh_definition_t & md,
 
         ++r;
       } // for
+
+      aux_coloring[idx].ghost.insert(ghosts.begin(), ghosts.end());
     } // scope
   }; // color_entity
 
@@ -1542,7 +1542,7 @@ public:
     if(SORTED || sorted_) {
       auto id = id_(item);
       auto itr = std::upper_bound(v_->begin(), v_->end(), id);
-      v_->insert(itr, index);
+      v_->insert(itr, id);
     }
     else {
       v_->push_back(id_(item));
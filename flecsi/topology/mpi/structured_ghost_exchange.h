@@ -0,0 +1,154 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+/*! @file */
+
+#include <flecsi/topology/structured_mesh_topology.h>
+#include <flecsi/utils/mpi_type_traits.h>
+
+#include <cinchlog.h>
+#include <mpi.h>
+
+#include <map>
+#include <vector>
+
+namespace flecsi {
+namespace topology {
+
+/*!
+  The structured_ghost_exchange_u type updates the ghost cells of
+  structured fields. Each halo is described by an MPI subarray type over
+  the padded field storage, so that the strided faces are sent and
+  received in place, without packing. The types are created once per
+  value type and reused for every exchange.
+
+  @tparam D The number of dimensions of the mesh.
+ */
+
+template<size_t D>
+class structured_ghost_exchange_u
+{
+public:
+  using box_t = coloring::box_t<D>;
+
+  /*!
+    Constructor.
+
+    @param local The local box of the fields.
+    @param halos The halos of the mesh.
+    @param comm  The communicator of the coloring.
+   */
+
+  structured_ghost_exchange_u(const box_t & local,
+    const std::vector<structured_halo_t<D>> & halos,
+    MPI_Comm comm = MPI_COMM_WORLD)
+    : local_(local), halos_(halos), comm_(comm) {}
+
+  template<typename MT>
+  explicit structured_ghost_exchange_u(
+    const structured_mesh_topology_u<MT> & mesh,
+    MPI_Comm comm = MPI_COMM_WORLD)
+    : structured_ghost_exchange_u(mesh.local(), mesh.halos(), comm) {}
+
+  /// Copy constructor (disabled)
+  structured_ghost_exchange_u(const structured_ghost_exchange_u &) = delete;
+
+  /// Assignment operator (disabled)
+  structured_ghost_exchange_u & operator=(
+    const structured_ghost_exchange_u &) = delete;
+
+  ~structured_ghost_exchange_u() {
+    for(auto & t : types_) {
+      for(auto & h : t.second) {
+        MPI_Type_free(&h.send);
+        MPI_Type_free(&h.recv);
+      } // for
+    } // for
+  } // ~structured_ghost_exchange_u
+
+  /*!
+    Copy the owned values that the neighbors need into their ghost
+    cells, and receive the values of our own ghost cells.
+   */
+
+  template<typename T>
+  void exchange(structured_field_u<T, D> & field) {
+    for(size_t d = 0; d < D; ++d) {
+      clog_assert(field.box().lowerbnd[d] == local_.lowerbnd[d] &&
+                    field.box().upperbnd[d] == local_.upperbnd[d],
+        "field does not cover the local box of the mesh");
+    } // for
+
+    const auto & types = halo_types(utils::mpi_typetraits_u<T>::type());
+
+    std::vector<MPI_Request> requests(2 * halos_.size());
+
+    for(size_t h = 0; h < halos_.size(); ++h) {
+      MPI_Irecv(field.data(), 1, types[h].recv, int(halos_[h].color),
+        halos_[h].recv_tag, comm_, &requests[h]);
+    } // for
+
+    for(size_t h = 0; h < halos_.size(); ++h) {
+      MPI_Isend(field.data(), 1, types[h].send, int(halos_[h].color),
+        halos_[h].send_tag, comm_, &requests[halos_.size() + h]);
+    } // for
+
+    MPI_Waitall(int(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+  } // exchange
+
+private:
+  struct halo_types_t {
+    MPI_Datatype send;
+    MPI_Datatype recv;
+  }; // struct halo_types_t
+
+  const std::vector<halo_types_t> & halo_types(MPI_Datatype base) {
+    auto it = types_.find(base);
+    if(it != types_.end())
+      return it->second;
+
+    auto & types = types_[base];
+    for(const auto & halo : halos_) {
+      types.push_back({subarray(halo.send, base), subarray(halo.recv, base)});
+    } // for
+
+    return types;
+  } // halo_types
+
+  MPI_Datatype subarray(const box_t & box, MPI_Datatype base) const {
+    int sizes[D], subsizes[D], starts[D];
+    for(size_t d = 0; d < D; ++d) {
+      sizes[d] = int(local_.upperbnd[d] + 1 - local_.lowerbnd[d]);
+      subsizes[d] = int(box.upperbnd[d] + 1 - box.lowerbnd[d]);
+      starts[d] = int(box.lowerbnd[d] - local_.lowerbnd[d]);
+    } // for
+
+    // The first dimension is contiguous, i.e., Fortran order.
+    MPI_Datatype type;
+    MPI_Type_create_subarray(
+      int(D), sizes, subsizes, starts, MPI_ORDER_FORTRAN, base, &type);
+    MPI_Type_commit(&type);
+    return type;
+  } // subarray
+
+  box_t local_;
+  std::vector<structured_halo_t<D>> halos_;
+  MPI_Comm comm_;
+  std::map<MPI_Datatype, std::vector<halo_types_t>> types_;
+
+}; // class structured_ghost_exchange_u
+
+} // namespace topology
+} // namespace flecsi
@@ -15,20 +15,267 @@
 
 /*! @file */
 
+#include <flecsi/coloring/box_types.h>
+
+#include <cinchlog.h>
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
 namespace flecsi {
 namespace topology {
 
-///
-// \class structured_mesh_topology_u structured_mesh_topology.h
-// \brief structured_mesh_topology_u provides...
-///
+/*!
+  Return the number of indices in each dimension of a box.
+ */
+
+template<size_t D>
+std::array<size_t, D>
+box_extents(const coloring::box_t<D> & box) {
+  std::array<size_t, D> extents;
+  for(size_t d = 0; d < D; ++d)
+    extents[d] = box.upperbnd[d] + 1 - box.lowerbnd[d];
+  return extents;
+} // box_extents
+
+/*!
+  Return the number of indices in a box.
+ */
+
+template<size_t D>
+size_t
+box_size(const coloring::box_t<D> & box) {
+  size_t size = 1;
+  for(auto e : box_extents(box))
+    size *= e;
+  return size;
+} // box_size
+
+/*!
+  Call a function on every index of a box. The first dimension varies
+  fastest, i.e., this visits the indices in the order in which they are
+  laid out in a \ref structured_field_u.
+ */
+
+template<size_t D, typename FUNCTION>
+void
+for_each_index(const coloring::box_t<D> & box, FUNCTION && f) {
+  if(box_size(box) == 0)
+    return;
+
+  std::array<size_t, D> index;
+  for(size_t d = 0; d < D; ++d)
+    index[d] = box.lowerbnd[d];
+
+  while(true) {
+    f(const_cast<const std::array<size_t, D> &>(index));
+
+    size_t d = 0;
+    for(; d < D; ++d) {
+      if(index[d] < box.upperbnd[d]) {
+        ++index[d];
+        break;
+      } // if
+      index[d] = box.lowerbnd[d];
+    } // for
+
+    if(d == D)
+      return;
+  } // while
+} // for_each_index
+
+/*!
+  A dense field on a structured mesh, stored as an N-dimensional array
+  that covers the local box of a color, i.e., its primary box padded
+  with the ghost and domain halos. The field is addressed with global
+  logical indices; the first dimension is contiguous in memory.
+
+  @tparam T The value type of the field.
+  @tparam D The number of dimensions of the mesh.
+ */
+
+template<typename T, size_t D>
+class structured_field_u
+{
+public:
+  using index_t = std::array<size_t, D>;
+  using box_t = coloring::box_t<D>;
+
+  structured_field_u() {}
+
+  /*!
+    Constructor.
+
+    @param box   The global indices covered by the field.
+    @param value The initial value of the field.
+   */
+
+  explicit structured_field_u(const box_t & box, const T & value = T())
+    : box_(box), extents_(box_extents(box)) {
+    size_t stride = 1;
+    for(size_t d = 0; d < D; ++d) {
+      strides_[d] = stride;
+      stride *= extents_[d];
+    } // for
+
+    data_.assign(stride, value);
+  } // structured_field_u
+
+  /*!
+    Return the storage offset of a global index.
+   */
+
+  size_t offset(const index_t & index) const {
+    size_t off = 0;
+    for(size_t d = 0; d < D; ++d)
+      off += (index[d] - box_.lowerbnd[d]) * strides_[d];
+    return off;
+  } // offset
+
+  T & operator()(const index_t & index) {
+    return data_[offset(index)];
+  } // operator ()
+
+  const T & operator()(const index_t & index) const {
+    return data_[offset(index)];
+  } // operator ()
+
+  template<typename... INDICES,
+    typename = std::enable_if_t<sizeof...(INDICES) == D>>
+  T & operator()(INDICES... indices) {
+    return data_[offset({{size_t(indices)...}})];
+  } // operator ()
+
+  template<typename... INDICES,
+    typename = std::enable_if_t<sizeof...(INDICES) == D>>
+  const T & operator()(INDICES... indices) const {
+    return data_[offset({{size_t(indices)...}})];
+  } // operator ()
+
+  //! The global indices covered by the field.
+  const box_t & box() const {
+    return box_;
+  }
+
+  //! The number of values in each dimension.
+  const std::array<size_t, D> & extents() const {
+    return extents_;
+  }
+
+  //! The distance in memory between neighbors in each dimension.
+  const std::array<size_t, D> & strides() const {
+    return strides_;
+  }
+
+  size_t size() const {
+    return data_.size();
+  }
+
+  T * data() {
+    return data_.data();
+  }
+
+  const T * data() const {
+    return data_.data();
+  }
+
+private:
+  box_t box_;
+  std::array<size_t, D> extents_;
+  std::array<size_t, D> strides_;
+  std::vector<T> data_;
+
+}; // class structured_field_u
+
+/*!
+  One entry of the ghost exchange of a structured mesh: the owned
+  indices that are sent to a neighboring color, and the ghost indices
+  that are received from it.
+ */
+
+template<size_t D>
+struct structured_halo_t {
+  //! The neighboring color.
+  size_t color;
+
+  //! The owned indices that the neighbor needs.
+  coloring::box_t<D> send;
+
+  //! The ghost indices that the neighbor owns.
+  coloring::box_t<D> recv;
+
+  //! The message tag for sending.
+  int send_tag;
+
+  //! The message tag for receiving.
+  int recv_tag;
+}; // struct structured_halo_t
+
+/*!
+  The structured_mesh_topology_u type provides a Cartesian mesh with
+  implicit entity ids and adjacencies. Nothing is stored per entity:
+  ids, adjacencies and field offsets are computed arithmetically from
+  logical indices, and the distribution of the mesh is taken from a
+  \ref coloring::simple_box_colorer_t box coloring of its cells.
+
+  Logical indices are global and include the domain halo, i.e., they
+  use the numbering of the box colorer. Cell ids number the cells of
+  the padded domain with the first dimension varying fastest. Vertex
+  ids do the same for the vertices, of which there is one more than
+  cells in each dimension.
+
+  @tparam MT The mesh type, which must define num_dimensions.
+
+  @ingroup topology
+ */
+
 template<typename MT>
 class structured_mesh_topology_u
 {
 public:
+  static constexpr size_t num_dimensions = MT::num_dimensions;
+  static constexpr size_t num_corners = size_t(1) << num_dimensions;
+
+  using index_t = std::array<size_t, num_dimensions>;
+  using box_t = coloring::box_t<num_dimensions>;
+  using coloring_t = coloring::box_coloring_info_t<num_dimensions>;
+  using halo_t = structured_halo_t<num_dimensions>;
+
+  template<typename T>
+  using field_u = structured_field_u<T, num_dimensions>;
+
   /// Default constructor
   structured_mesh_topology_u() {}
 
+  /*!
+    Constructor.
+
+    @param grid_size The number of cells in each dimension, not counting
+                     the domain halo.
+    @param coloring  The box coloring of the cells for this color.
+   */
+
+  structured_mesh_topology_u(const size_t (&grid_size)[num_dimensions],
+    const coloring_t & coloring)
+    : coloring_(coloring) {
+    const auto & primary = coloring_.primary;
+
+    for(size_t d = 0; d < num_dimensions; ++d) {
+      extents_[d] = grid_size[d] + 2 * primary.nhalo_domain;
+
+      local_.lowerbnd[d] = primary.box.lowerbnd[d] -
+                           (primary.onbnd[2 * d] ? primary.nhalo_domain
+                                                 : primary.nhalo);
+      local_.upperbnd[d] = primary.box.upperbnd[d] +
+                           (primary.onbnd[2 * d + 1] ? primary.nhalo_domain
+                                                     : primary.nhalo);
+    } // for
+
+    build_halos();
+  } // structured_mesh_topology_u
+
   /// Copy constructor (disabled)
   structured_mesh_topology_u(const structured_mesh_topology_u &) = delete;
 
@@ -39,11 +286,247 @@ public:
   /// Destructor
   ~structured_mesh_topology_u() {}
 
-  size_t num_entities(size_t dim, size_t domain = 0) {
-    return MT::num_entities(dim, domain);
+  /*!
+    Return the global number of entities of a dimension, including the
+    domain halo. Only cells and vertices are supported.
+   */
+
+  size_t num_entities(size_t dim, size_t domain = 0) const {
+    clog_assert(domain == 0, "structured meshes have a single domain");
+    clog_assert(dim == 0 || dim == num_dimensions,
+      "only cells and vertices are supported");
+
+    size_t count = 1;
+    for(auto e : extents_)
+      count *= dim == 0 ? e + 1 : e;
+    return count;
   } // num_entities
 
+  //-------------------------------------------------------------------------//
+  // Boxes
+  //-------------------------------------------------------------------------//
+
+  //! The global number of cells in each dimension, including the halo.
+  const index_t & extents() const {
+    return extents_;
+  }
+
+  //! The box coloring of this color.
+  const coloring_t & coloring() const {
+    return coloring_;
+  }
+
+  //! The cells owned by this color.
+  const box_t & owned() const {
+    return coloring_.primary.box;
+  }
+
+  //! The owned cells that are not needed by any other color.
+  const box_t & exclusive() const {
+    return coloring_.exclusive.box;
+  }
+
+  //! The owned cells plus the ghost and domain halos, i.e., the cells
+  //! covered by a field.
+  const box_t & local() const {
+    return local_;
+  }
+
+  //! The ghost exchange with the neighboring colors.
+  const std::vector<halo_t> & halos() const {
+    return halos_;
+  }
+
+  //-------------------------------------------------------------------------//
+  // Ids
+  //-------------------------------------------------------------------------//
+
+  //! Return the id of the cell with the given logical index.
+  size_t cell_id(const index_t & index) const {
+    return linearize(index, 0);
+  }
+
+  //! Return the logical index of the cell with the given id.
+  index_t cell_index(size_t id) const {
+    return delinearize(id, 0);
+  }
+
+  //! Return the id of the vertex with the given logical index.
+  size_t vertex_id(const index_t & index) const {
+    return linearize(index, 1);
+  }
+
+  //! Return the logical index of the vertex with the given id.
+  index_t vertex_index(size_t id) const {
+    return delinearize(id, 1);
+  }
+
+  //-------------------------------------------------------------------------//
+  // Adjacencies
+  //-------------------------------------------------------------------------//
+
+  /*!
+    Return the logical index of the cell that is \e shift cells away
+    along \e axis. The result is not bounds checked.
+   */
+
+  index_t neighbor(index_t index, size_t axis, long shift) const {
+    index[axis] = size_t(long(index[axis]) + shift);
+    return index;
+  } // neighbor
+
+  /*!
+    Return the ids of the vertices of a cell. Vertex \e c is offset from
+    the lower corner by bit \e d of \e c in dimension \e d.
+   */
+
+  std::array<size_t, num_corners> vertices(const index_t & cell) const {
+    std::array<size_t, num_corners> ids;
+    for(size_t c = 0; c < num_corners; ++c) {
+      index_t v = cell;
+      for(size_t d = 0; d < num_dimensions; ++d)
+        v[d] += (c >> d) & 1;
+      ids[c] = vertex_id(v);
+    } // for
+    return ids;
+  } // vertices
+
+  /*!
+    Return the ids of the cells that share a vertex. Vertices on the
+    boundary of the padded domain have fewer than 2^D cells.
+   */
+
+  std::vector<size_t> cells(const index_t & vertex) const {
+    std::vector<size_t> ids;
+    ids.reserve(num_corners);
+
+    for(size_t c = 0; c < num_corners; ++c) {
+      index_t cell = vertex;
+      bool valid = true;
+
+      for(size_t d = 0; d < num_dimensions; ++d) {
+        if((c >> d) & 1) {
+          if(cell[d] == 0) {
+            valid = false;
+            break;
+          } // if
+          --cell[d];
+        }
+        else if(cell[d] == extents_[d]) {
+          valid = false;
+          break;
+        } // if
+      } // for
+
+      if(valid)
+        ids.push_back(cell_id(cell));
+    } // for
+
+    return ids;
+  } // cells
+
+  //-------------------------------------------------------------------------//
+  // Fields
+  //-------------------------------------------------------------------------//
+
+  //! Create a cell field covering the local box.
+  template<typename T>
+  field_u<T> make_field(const T & value = T()) const {
+    return field_u<T>(local_, value);
+  } // make_field
+
 private:
+  size_t linearize(const index_t & index, size_t pad) const {
+    size_t id = 0;
+    for(size_t d = num_dimensions; d-- > 0;)
+      id = id * (extents_[d] + pad) + index[d];
+    return id;
+  } // linearize
+
+  index_t delinearize(size_t id, size_t pad) const {
+    index_t index;
+    for(size_t d = 0; d < num_dimensions; ++d) {
+      index[d] = id % (extents_[d] + pad);
+      id /= extents_[d] + pad;
+    } // for
+    return index;
+  } // delinearize
+
+  //! Encode a neighbor direction in {-1, 0, 1}^D as a message tag.
+  static int direction_tag(const std::array<int, num_dimensions> & dir) {
+    int tag = 0;
+    for(size_t d = num_dimensions; d-- > 0;)
+      tag = 3 * tag + dir[d] + 1;
+    return tag;
+  } // direction_tag
+
+  /*
+    Every ghost box of the coloring lies in one direction from the
+    primary box, and has a single owner. That owner needs the mirror
+    image of the box from us: the strip of our primary box of the same
+    width on the opposite side.
+
+    The mirror is only correct when every color uses the same halo width
+    on every side, as the box colorer does. Colorings that violate this
+    are rejected rather than exchanged incorrectly.
+   */
+
+  void build_halos() {
+    const auto & pbox = coloring_.primary.box;
+    const size_t nhalo = coloring_.primary.nhalo;
+
+    for(const auto & ghost : coloring_.ghost) {
+      clog_assert(ghost.colors.size() == 1,
+        "structured ghost boxes must have exactly one owner");
+
+      halo_t halo;
+      halo.color = ghost.colors[0];
+      halo.recv = ghost.box;
+
+      std::array<int, num_dimensions> dir, mirror;
+
+      for(size_t d = 0; d < num_dimensions; ++d) {
+        const size_t width = ghost.box.upperbnd[d] + 1 - ghost.box.lowerbnd[d];
+        const bool offset = ghost.box.upperbnd[d] < pbox.lowerbnd[d] ||
+                            ghost.box.lowerbnd[d] > pbox.upperbnd[d];
+
+        clog_assert(!offset || width == nhalo,
+          "structured ghost boxes must have the halo width on every side");
+        clog_assert(!offset || width <= pbox.upperbnd[d] + 1 - pbox.lowerbnd[d],
+          "the halo must not be wider than the primary box");
+
+        if(ghost.box.upperbnd[d] < pbox.lowerbnd[d]) {
+          dir[d] = -1;
+          halo.send.lowerbnd[d] = pbox.lowerbnd[d];
+          halo.send.upperbnd[d] = pbox.lowerbnd[d] + width - 1;
+        }
+        else if(ghost.box.lowerbnd[d] > pbox.upperbnd[d]) {
+          dir[d] = 1;
+          halo.send.lowerbnd[d] = pbox.upperbnd[d] + 1 - width;
+          halo.send.upperbnd[d] = pbox.upperbnd[d];
+        }
+        else {
+          dir[d] = 0;
+          halo.send.lowerbnd[d] = ghost.box.lowerbnd[d];
+          halo.send.upperbnd[d] = ghost.box.upperbnd[d];
+        } // if
+
+        mirror[d] = -dir[d];
+      } // for
+
+      // The receiver sees us in the opposite direction.
+      halo.recv_tag = direction_tag(dir);
+      halo.send_tag = direction_tag(mirror);
+
+      halos_.push_back(halo);
+    } // for
+  } // build_halos
+
+  coloring_t coloring_;
+  index_t extents_;
+  box_t local_;
+  std::vector<halo_t> halos_;
+
 }; // class structured_mesh_topology_u
 
 } // namespace topology
@@ -5,6 +5,12 @@
 
 #include <cinchtest.h>
 
+#include <flecsi/topology/structured_mesh_topology.h>
+
+#include <algorithm>
+
+using namespace flecsi;
+
 template<size_t>
 struct domain_ {};
 template<size_t D, size_t NM>
@@ -28,7 +34,102 @@ struct structured_mesh_type_t {
     std::pair<domain_<1>, structured_corner_t>>;
 }; // struct structured_mesh_type_t
 
-TEST(structured, testname) {} // TEST
+using mesh_t = topology::structured_mesh_topology_u<structured_mesh_type_t>;
+
+// A single color owning a 4x3 grid with a domain halo of one cell.
+coloring::box_coloring_info_t<2>
+single_color() {
+  coloring::box_coloring_info_t<2> colbox;
+  colbox.primary.box = {{1, 1}, {4, 3}};
+  colbox.primary.nhalo = 1;
+  colbox.primary.nhalo_domain = 1;
+  colbox.primary.thru_dim = 0;
+  colbox.primary.onbnd.set();
+  colbox.exclusive.box = colbox.primary.box;
+  colbox.exclusive.colors.push_back(0);
+  return colbox;
+} // single_color
+
+TEST(structured, ids) {
+  size_t grid_size[2] = {4, 3};
+  mesh_t mesh(grid_size, single_color());
+
+  ASSERT_EQ(6, mesh.extents()[0]);
+  ASSERT_EQ(5, mesh.extents()[1]);
+  ASSERT_EQ(30, mesh.num_entities(2));
+  ASSERT_EQ(42, mesh.num_entities(0));
+
+  for(size_t id(0); id < mesh.num_entities(2); ++id) {
+    ASSERT_EQ(id, mesh.cell_id(mesh.cell_index(id)));
+  } // for
+
+  for(size_t id(0); id < mesh.num_entities(0); ++id) {
+    ASSERT_EQ(id, mesh.vertex_id(mesh.vertex_index(id)));
+  } // for
+
+  // The first dimension varies fastest.
+  ASSERT_EQ(1, mesh.cell_id({{1, 0}}));
+  ASSERT_EQ(6, mesh.cell_id({{0, 1}}));
+  ASSERT_EQ(7, mesh.vertex_id({{0, 1}}));
+} // TEST
+
+TEST(structured, adjacencies) {
+  size_t grid_size[2] = {4, 3};
+  mesh_t mesh(grid_size, single_color());
+
+  auto n = mesh.neighbor({{2, 2}}, 1, -1);
+  ASSERT_EQ(2, n[0]);
+  ASSERT_EQ(1, n[1]);
+
+  // The vertices of a cell, and the cells of those vertices.
+  auto verts = mesh.vertices({{2, 1}});
+  ASSERT_EQ(mesh.vertex_id({{2, 1}}), verts[0]);
+  ASSERT_EQ(mesh.vertex_id({{3, 1}}), verts[1]);
+  ASSERT_EQ(mesh.vertex_id({{2, 2}}), verts[2]);
+  ASSERT_EQ(mesh.vertex_id({{3, 2}}), verts[3]);
+
+  for(auto v : verts) {
+    auto cells = mesh.cells(mesh.vertex_index(v));
+    ASSERT_EQ(4, cells.size());
+    ASSERT_NE(cells.end(),
+      std::find(cells.begin(), cells.end(), mesh.cell_id({{2, 1}})));
+  } // for
+
+  // Vertices on the corners of the padded domain have a single cell.
+  ASSERT_EQ(1, mesh.cells({{0, 0}}).size());
+  ASSERT_EQ(1, mesh.cells({{6, 5}}).size());
+  ASSERT_EQ(2, mesh.cells({{3, 0}}).size());
+} // TEST
+
+TEST(structured, fields) {
+  size_t grid_size[2] = {4, 3};
+  mesh_t mesh(grid_size, single_color());
+
+  ASSERT_TRUE(mesh.halos().empty());
+  ASSERT_EQ(0, mesh.local().lowerbnd[0]);
+  ASSERT_EQ(5, mesh.local().upperbnd[0]);
+  ASSERT_EQ(4, mesh.local().upperbnd[1]);
+
+  auto f = mesh.make_field<double>(-1.0);
+  ASSERT_EQ(30, f.size());
+  ASSERT_EQ(1, f.strides()[0]);
+  ASSERT_EQ(6, f.strides()[1]);
+
+  // Visiting a box follows the storage order.
+  size_t count = 0;
+  topology::for_each_index(mesh.local(), [&](const mesh_t::index_t & i) {
+    ASSERT_EQ(count++, f.offset(i));
+  });
+  ASSERT_EQ(f.size(), count);
+
+  topology::for_each_index(mesh.owned(),
+    [&](const mesh_t::index_t & i) { f(i) = mesh.cell_id(i); });
+
+  ASSERT_EQ(mesh.cell_id({{3, 2}}), f(3, 2));
+  ASSERT_EQ(-1.0, f(0, 2));
+  ASSERT_EQ(&f(3, 2) + 1, &f(4, 2));
+  ASSERT_EQ(&f(3, 2) + 6, &f(3, 3));
+} // TEST
 
 /*----------------------------------------------------------------------------*
  * Cinch test Macros
@@ -0,0 +1,76 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2014 Los Alamos National Security, LLC
+ * All rights reserved.
+ *~-------------------------------------------------------------------------~~*/
+
+#include <cinchtest.h>
+
+#include <flecsi/coloring/simple_box_colorer.h>
+#include <flecsi/topology/mpi/structured_ghost_exchange.h>
+
+using namespace flecsi;
+
+template<size_t D>
+struct structured_type_u {
+  static constexpr size_t num_dimensions = D;
+}; // struct structured_type_u
+
+// Fill the owned cells with their ids, update the ghosts, and check that
+// every ghost cell received the id of its cell.
+template<size_t D>
+void
+check_exchange(size_t (&grid_size)[D], size_t (&ncolors)[D], size_t nhalo) {
+  using mesh_t = topology::structured_mesh_topology_u<structured_type_u<D>>;
+
+  coloring::simple_box_colorer_t<D> colorer;
+  auto colbox = colorer.color(grid_size, nhalo, 1, 0, ncolors);
+
+  mesh_t mesh(grid_size, colbox);
+  topology::structured_ghost_exchange_u<D> exchange(mesh);
+
+  auto f = mesh.template make_field<long>(-1);
+  topology::for_each_index(mesh.owned(),
+    [&](const typename mesh_t::index_t & i) { f(i) = mesh.cell_id(i); });
+
+  exchange.exchange(f);
+
+  ASSERT_EQ(colbox.ghost.size(), mesh.halos().size());
+
+  for(const auto & ghost : colbox.ghost) {
+    topology::for_each_index(
+      ghost.box, [&](const typename mesh_t::index_t & i) {
+        ASSERT_EQ(long(mesh.cell_id(i)), f(i));
+      });
+  } // for
+
+  // A second exchange reuses the cached types.
+  topology::for_each_index(mesh.owned(),
+    [&](const typename mesh_t::index_t & i) { f(i) = -f(i); });
+
+  exchange.exchange(f);
+
+  for(const auto & ghost : colbox.ghost) {
+    topology::for_each_index(
+      ghost.box, [&](const typename mesh_t::index_t & i) {
+        ASSERT_EQ(-long(mesh.cell_id(i)), f(i));
+      });
+  } // for
+} // check_exchange
+
+TEST(structured_ghost_exchange, exchange2d) {
+  size_t grid_size[2] = {10, 9};
+  size_t ncolors[2] = {2, 2};
+  check_exchange(grid_size, ncolors, 1);
+  check_exchange(grid_size, ncolors, 2);
+} // TEST
+
+TEST(structured_ghost_exchange, exchange3d) {
+  size_t grid_size[3] = {6, 7, 5};
+  size_t ncolors[3] = {2, 1, 2};
+  check_exchange(grid_size, ncolors, 1);
+} // TEST
+
+/*~------------------------------------------------------------------------~--*
+ * Formatting options for vim.
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~------------------------------------------------------------------------~--*/
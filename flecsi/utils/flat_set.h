@@ -0,0 +1,389 @@
+/*
+    @@@@@@@@  @@           @@@@@@   @@@@@@@@ @@
+   /@@/////  /@@          @@////@@ @@////// /@@
+   /@@       /@@  @@@@@  @@    // /@@       /@@
+   /@@@@@@@  /@@ @@///@@/@@       /@@@@@@@@@/@@
+   /@@////   /@@/@@@@@@@/@@       ////////@@/@@
+   /@@       /@@/@@//// //@@    @@       /@@/@@
+   /@@       @@@//@@@@@@ //@@@@@@  @@@@@@@@ /@@
+   //       ///  //////   //////  ////////  //
+
+   Copyright (c) 2016, Los Alamos National Security, LLC
+   All rights reserved.
+                                                                              */
+#pragma once
+
+//! @file
+
+#include <flecsi/utils/type_traits.h>
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace flecsi {
+namespace utils {
+
+//! Tag type to construct a flat_set_u from data that is already sorted and
+//! free of duplicates.
+struct sorted_unique_t {};
+
+//! Tag value to construct a flat_set_u from data that is already sorted and
+//! free of duplicates.
+constexpr sorted_unique_t sorted_unique{};
+
+//=============================================================================
+//! \brief A sorted set stored in a contiguous std::vector.
+//!
+//! This class provides the interface of std::set, but stores its values
+//! in a single sorted vector instead of a tree of individually allocated
+//! nodes. This uses much less memory, iterates and searches faster, and
+//! supports O(1) positional access. The price is that inserting a value
+//! anywhere but at the end is O(n). Inserting values in increasing order,
+//! or inserting whole ranges at once, is cheap.
+//!
+//! As with std::set, the values cannot be modified through iterators.
+//! Any insertion or erasure invalidates all iterators.
+//!
+//! \tparam T        The value type of the set
+//! \tparam COMPARE  The ordering of the set
+//=============================================================================
+template<typename T, typename COMPARE = std::less<T>>
+class flat_set_u
+{
+
+public:
+  //---------------------------------------------------------------------------
+  // public typedefs
+  //---------------------------------------------------------------------------
+
+  using vector_t = std::vector<T>;
+
+  using key_type = T;
+  using value_type = T;
+  using size_type = typename vector_t::size_type;
+  using difference_type = typename vector_t::difference_type;
+  using key_compare = COMPARE;
+  using value_compare = COMPARE;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+  using pointer = const value_type *;
+  using const_pointer = const value_type *;
+  using iterator = typename vector_t::const_iterator;
+  using const_iterator = typename vector_t::const_iterator;
+  using reverse_iterator = typename vector_t::const_reverse_iterator;
+  using const_reverse_iterator = typename vector_t::const_reverse_iterator;
+
+  //---------------------------------------------------------------------------
+  // Constructors
+  //---------------------------------------------------------------------------
+
+  //! default constructor
+  flat_set_u() {}
+
+  //! constructor with comparison object
+  explicit flat_set_u(const COMPARE & comp) : comp_(comp) {}
+
+  //! constructor with iterators
+  //! \tparam InputIt  the input iterator type
+  //! \param first  the beginning iterator
+  //! \param last   the ending iterator
+  template<class InputIt,
+    typename = typename std::enable_if_t<is_iterator_v<InputIt>>>
+  flat_set_u(InputIt first, InputIt last, const COMPARE & comp = COMPARE())
+    : comp_(comp) {
+    insert(first, last);
+  }
+
+  //! constructor with initializer list
+  flat_set_u(std::initializer_list<T> init, const COMPARE & comp = COMPARE())
+    : comp_(comp) {
+    insert(init.begin(), init.end());
+  }
+
+  //! Implicit conversion from a std::set with the same ordering. The
+  //! values are already sorted, so this is O(n).
+  flat_set_u(const std::set<T, COMPARE> & s)
+    : data_(s.begin(), s.end()), comp_(s.key_comp()) {}
+
+  //! constructor from values that are already sorted and unique
+  //! \param values  the values, which are taken over without sorting
+  flat_set_u(sorted_unique_t, vector_t values, const COMPARE & comp = COMPARE())
+    : data_(std::move(values)), comp_(comp) {}
+
+  //! assigment operator with initializer list
+  flat_set_u & operator=(std::initializer_list<T> init) {
+    clear();
+    insert(init.begin(), init.end());
+    return *this;
+  }
+
+  //---------------------------------------------------------------------------
+  // Iterators
+  //---------------------------------------------------------------------------
+
+  const_iterator begin() const noexcept {
+    return data_.cbegin();
+  }
+  const_iterator cbegin() const noexcept {
+    return data_.cbegin();
+  }
+  const_iterator end() const noexcept {
+    return data_.cend();
+  }
+  const_iterator cend() const noexcept {
+    return data_.cend();
+  }
+  const_reverse_iterator rbegin() const noexcept {
+    return data_.crbegin();
+  }
+  const_reverse_iterator crbegin() const noexcept {
+    return data_.crbegin();
+  }
+  const_reverse_iterator rend() const noexcept {
+    return data_.crend();
+  }
+  const_reverse_iterator crend() const noexcept {
+    return data_.crend();
+  }
+
+  //---------------------------------------------------------------------------
+  // Capacity
+  //---------------------------------------------------------------------------
+
+  bool empty() const noexcept {
+    return data_.empty();
+  }
+  size_type size() const noexcept {
+    return data_.size();
+  }
+  size_type max_size() const noexcept {
+    return data_.max_size();
+  }
+  size_type capacity() const noexcept {
+    return data_.capacity();
+  }
+  void reserve(size_type n) {
+    data_.reserve(n);
+  }
+  void shrink_to_fit() {
+    data_.shrink_to_fit();
+  }
+
+  //---------------------------------------------------------------------------
+  // Positional access
+  //---------------------------------------------------------------------------
+
+  //! return the i-th smallest value
+  const_reference operator[](size_type i) const {
+    return data_[i];
+  }
+
+  //! return a pointer to the sorted values
+  const_pointer data() const noexcept {
+    return data_.data();
+  }
+
+  //! return the underlying sorted vector
+  const vector_t & vector() const noexcept {
+    return data_;
+  }
+
+  //! move the underlying sorted vector out of the set, leaving it empty
+  vector_t extract() {
+    vector_t values;
+    values.swap(data_);
+    return values;
+  }
+
+  //---------------------------------------------------------------------------
+  // Modifiers
+  //---------------------------------------------------------------------------
+
+  void clear() noexcept {
+    data_.clear();
+  }
+
+  std::pair<iterator, bool> insert(const value_type & value) {
+    return insert_(value);
+  }
+
+  std::pair<iterator, bool> insert(value_type && value) {
+    return insert_(std::move(value));
+  }
+
+  //! insert with a hint, which is used if it is the correct position
+  iterator insert(const_iterator hint, const value_type & value) {
+    return insert_hint_(hint, value);
+  }
+
+  iterator insert(const_iterator hint, value_type && value) {
+    return insert_hint_(hint, std::move(value));
+  }
+
+  //! Insert a range of values. This sorts the new values and merges them
+  //! into the existing ones, i.e., it is O((n + m) log(m)) rather than the
+  //! O(n * m) of inserting them one at a time. As with std::set, values
+  //! that are already present are not replaced.
+  template<class InputIt,
+    typename = typename std::enable_if_t<is_iterator_v<InputIt>>>
+  void insert(InputIt first, InputIt last) {
+    const auto old_size = data_.size();
+    data_.insert(data_.end(), first, last);
+
+    if(data_.size() == old_size)
+      return;
+
+    auto mid = data_.begin() + old_size;
+
+    // stable, so that the first of several equivalent values is kept
+    std::stable_sort(mid, data_.end(), comp_);
+
+    if(old_size && comp_(*mid, data_[old_size - 1]))
+      std::inplace_merge(data_.begin(), mid, data_.end(), comp_);
+
+    data_.erase(std::unique(data_.begin(), data_.end(),
+                  [this](const value_type & a, const value_type & b) {
+                    return !comp_(a, b) && !comp_(b, a);
+                  }),
+      data_.end());
+  }
+
+  void insert(std::initializer_list<value_type> init) {
+    insert(init.begin(), init.end());
+  }
+
+  template<typename... ARGS>
+  std::pair<iterator, bool> emplace(ARGS &&... args) {
+    return insert_(value_type(std::forward<ARGS>(args)...));
+  }
+
+  template<typename... ARGS>
+  iterator emplace_hint(const_iterator hint, ARGS &&... args) {
+    return insert_hint_(hint, value_type(std::forward<ARGS>(args)...));
+  }
+
+  iterator erase(const_iterator pos) {
+    return data_.erase(pos);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return data_.erase(first, last);
+  }
+
+  size_type erase(const key_type & key) {
+    auto it = find(key);
+    if(it == end())
+      return 0;
+    data_.erase(it);
+    return 1;
+  }
+
+  void swap(flat_set_u & other) noexcept {
+    using std::swap;
+    data_.swap(other.data_);
+    swap(comp_, other.comp_);
+  }
+
+  //---------------------------------------------------------------------------
+  // Lookup
+  //---------------------------------------------------------------------------
+
+  size_type count(const key_type & key) const {
+    return find(key) != end();
+  }
+
+  bool contains(const key_type & key) const {
+    return find(key) != end();
+  }
+
+  const_iterator find(const key_type & key) const {
+    auto it = lower_bound(key);
+    return (it != end() && !comp_(key, *it)) ? it : end();
+  }
+
+  const_iterator lower_bound(const key_type & key) const {
+    return std::lower_bound(data_.begin(), data_.end(), key, comp_);
+  }
+
+  const_iterator upper_bound(const key_type & key) const {
+    return std::upper_bound(data_.begin(), data_.end(), key, comp_);
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(
+    const key_type & key) const {
+    return std::equal_range(data_.begin(), data_.end(), key, comp_);
+  }
+
+  //---------------------------------------------------------------------------
+  // Observers
+  //---------------------------------------------------------------------------
+
+  key_compare key_comp() const {
+    return comp_;
+  }
+
+  value_compare value_comp() const {
+    return comp_;
+  }
+
+  //---------------------------------------------------------------------------
+  // Comparison
+  //---------------------------------------------------------------------------
+
+  bool operator==(const flat_set_u & other) const {
+    return data_ == other.data_;
+  }
+
+  bool operator!=(const flat_set_u & other) const {
+    return data_ != other.data_;
+  }
+
+  bool operator<(const flat_set_u & other) const {
+    return std::lexicographical_compare(
+      begin(), end(), other.begin(), other.end(), comp_);
+  }
+
+private:
+  template<typename U>
+  std::pair<iterator, bool> insert_(U && value) {
+    // fast path for values inserted in order
+    if(data_.empty() || comp_(data_.back(), value)) {
+      data_.emplace_back(std::forward<U>(value));
+      return {std::prev(data_.cend()), true};
+    }
+
+    auto it = lower_bound(value);
+    if(it != end() && !comp_(value, *it))
+      return {it, false};
+
+    return {data_.insert(it, std::forward<U>(value)), true};
+  }
+
+  template<typename U>
+  iterator insert_hint_(const_iterator hint, U && value) {
+    // the hint is correct if value belongs right before it
+    if((hint == end() || comp_(value, *hint)) &&
+       (hint == begin() || comp_(*std::prev(hint), value)))
+      return data_.insert(hint, std::forward<U>(value));
+
+    return insert_(std::forward<U>(value)).first;
+  }
+
+  vector_t data_;
+  COMPARE comp_;
+
+}; // class flat_set_u
+
+template<typename T, typename COMPARE>
+void
+swap(flat_set_u<T, COMPARE> & a, flat_set_u<T, COMPARE> & b) noexcept {
+  a.swap(b);
+}
+
+} // namespace utils
+} // namespace flecsi
@@ -16,7 +16,11 @@
 /*! @file */
 
 #include <algorithm>
+#include <iterator>
 #include <set>
+#include <vector>
+
+#include <flecsi/utils/flat_set.h>
 
 namespace flecsi {
 namespace utils {
@@ -84,5 +88,71 @@ set_difference(const std::set<T> & s1, const std::set<T> & s2) {
   return difference;
 } // set_difference
 
+//!
+//! Flat version of set_intersection. Since the inputs are sorted vectors,
+//! this is a single linear merge into preallocated storage.
+//!
+//! \param s1 The first set of the intersection.
+//! \param s2 The second set of the intersection.
+//!
+//! \return A flat set containing the intersection of s1 with s2.
+//!
+template<class T, class C>
+inline flat_set_u<T, C>
+set_intersection(const flat_set_u<T, C> & s1, const flat_set_u<T, C> & s2) {
+  std::vector<T> intersection;
+  intersection.reserve(std::min(s1.size(), s2.size()));
+
+  std::set_intersection(s1.begin(), s1.end(), s2.begin(), s2.end(),
+    std::back_inserter(intersection), s1.key_comp());
+
+  return flat_set_u<T, C>(
+    sorted_unique, std::move(intersection), s1.key_comp());
+} // set_intersection
+
+//!
+//! Flat version of set_union. Since the inputs are sorted vectors, this is
+//! a single linear merge into preallocated storage.
+//!
+//! \param s1 The first set of the union.
+//! \param s2 The second set of the union.
+//!
+//! \return A flat set containing the union of s1 with s2.
+//!
+template<class T, class C>
+inline flat_set_u<T, C>
+set_union(const flat_set_u<T, C> & s1, const flat_set_u<T, C> & s2) {
+  std::vector<T> sunion;
+  sunion.reserve(s1.size() + s2.size());
+
+  std::set_union(s1.begin(), s1.end(), s2.begin(), s2.end(),
+    std::back_inserter(sunion), s1.key_comp());
+
+  return flat_set_u<T, C>(
+    sorted_unique, std::move(sunion), s1.key_comp());
+} // set_union
+
+//!
+//! Flat version of set_difference. Since the inputs are sorted vectors,
+//! this is a single linear merge into preallocated storage.
+//!
+//! \param s1 The first set of the difference.
+//! \param s2 The second set of the difference.
+//!
+//! \return A flat set containing the difference of s1 with s2.
+//!
+template<class T, class C>
+inline flat_set_u<T, C>
+set_difference(const flat_set_u<T, C> & s1, const flat_set_u<T, C> & s2) {
+  std::vector<T> difference;
+  difference.reserve(s1.size());
+
+  std::set_difference(s1.begin(), s1.end(), s2.begin(), s2.end(),
+    std::back_inserter(difference), s1.key_comp());
+
+  return flat_set_u<T, C>(
+    sorted_unique, std::move(difference), s1.key_comp());
+} // set_difference
+
 } // namespace utils
 } // namespace flecsi
@@ -0,0 +1,143 @@
+/*~-------------------------------------------------------------------------~~*
+ * Copyright (c) 2017 Los Alamos National Security, LLC
+ * All rights reserved
+ *~-------------------------------------------------------------------------~~*/
+
+// includes: flecsi
+#include <flecsi/utils/flat_set.h>
+#include <flecsi/utils/set_utils.h>
+
+// includes: C++
+#include <set>
+#include <vector>
+
+// includes: other
+#include <cinchtest.h>
+
+using flat_set = flecsi::utils::flat_set_u<int>;
+
+// compare a flat set with the equivalent std::set
+inline bool
+same(const flat_set & f, const std::set<int> & s) {
+  return std::vector<int>(f.begin(), f.end()) ==
+         std::vector<int>(s.begin(), s.end());
+}
+
+// =============================================================================
+// Test construction of flat sets
+// =============================================================================
+
+TEST(flat_set, construction) {
+  flat_set a;
+  ASSERT_TRUE(a.empty());
+
+  flat_set b = {5, 1, 3, 1, 5};
+  ASSERT_EQ(3, b.size());
+  ASSERT_TRUE(same(b, {1, 3, 5}));
+
+  std::vector<int> v = {9, 7, 9, 8};
+  flat_set c(v.begin(), v.end());
+  ASSERT_TRUE(same(c, {7, 8, 9}));
+
+  std::set<int> s = {4, 2, 6};
+  flat_set d = s;
+  ASSERT_TRUE(same(d, s));
+
+  flat_set e(flecsi::utils::sorted_unique, {1, 2, 3});
+  ASSERT_EQ(3, e.size());
+  ASSERT_EQ(2, e[1]);
+} // TEST
+
+// =============================================================================
+// Test that insertion and erasure behave like std::set
+// =============================================================================
+
+TEST(flat_set, modifiers) {
+  flat_set f;
+  std::set<int> s;
+
+  // a mix of in-order and out-of-order insertions, with duplicates
+  for(int i : {3, 5, 7, 1, 5, 9, 0, 3, 4, 11, 10}) {
+    auto fr = f.insert(i);
+    auto sr = s.insert(i);
+    ASSERT_EQ(fr.second, sr.second);
+    ASSERT_EQ(*fr.first, *sr.first);
+  } // for
+  ASSERT_TRUE(same(f, s));
+
+  // range insertion merges and removes duplicates
+  std::vector<int> more = {20, 2, 6, 4, 2, 13};
+  f.insert(more.begin(), more.end());
+  s.insert(more.begin(), more.end());
+  ASSERT_TRUE(same(f, s));
+
+  // hinted insertion, with correct and incorrect hints
+  f.insert(f.end(), 30);
+  f.insert(f.begin(), 8);
+  s.insert(30);
+  s.insert(8);
+  ASSERT_TRUE(same(f, s));
+
+  ASSERT_EQ(1, f.erase(5));
+  ASSERT_EQ(0, f.erase(5));
+  s.erase(5);
+  f.erase(f.find(0));
+  s.erase(0);
+  ASSERT_TRUE(same(f, s));
+
+  auto r = f.emplace(12);
+  ASSERT_TRUE(r.second);
+  ASSERT_EQ(12, *r.first);
+} // TEST
+
+// =============================================================================
+// Test lookup
+// =============================================================================
+
+TEST(flat_set, lookup) {
+  flat_set f = {1, 3, 5, 7};
+
+  ASSERT_EQ(1, f.count(3));
+  ASSERT_EQ(0, f.count(4));
+  ASSERT_TRUE(f.contains(7));
+  ASSERT_EQ(f.end(), f.find(8));
+  ASSERT_EQ(2, std::distance(f.begin(), f.find(5)));
+  ASSERT_EQ(5, *f.lower_bound(4));
+  ASSERT_EQ(7, *f.upper_bound(5));
+
+  flat_set g = {1, 3, 5, 7};
+  ASSERT_EQ(f, g);
+  g.insert(9);
+  ASSERT_NE(f, g);
+  ASSERT_TRUE(f < g);
+} // TEST
+
+// =============================================================================
+// Test the merge-based set algebra
+// =============================================================================
+
+TEST(flat_set, set_utils) {
+  std::set<int> a = {1, 3, 5, 7, 10, 11};
+  std::set<int> b = {2, 3, 6, 7, 10, 12};
+  flat_set fa = a;
+  flat_set fb = b;
+  flat_set fe;
+
+  ASSERT_TRUE(same(flecsi::utils::set_intersection(fa, fb),
+    flecsi::utils::set_intersection(a, b)));
+  ASSERT_TRUE(
+    same(flecsi::utils::set_union(fa, fb), flecsi::utils::set_union(a, b)));
+  ASSERT_TRUE(same(flecsi::utils::set_difference(fa, fb),
+    flecsi::utils::set_difference(a, b)));
+  ASSERT_TRUE(same(flecsi::utils::set_difference(fb, fa),
+    flecsi::utils::set_difference(b, a)));
+
+  ASSERT_TRUE(flecsi::utils::set_intersection(fa, fe).empty());
+  ASSERT_EQ(flecsi::utils::set_union(fa, fe), fa);
+  ASSERT_EQ(flecsi::utils::set_difference(fa, fe), fa);
+} // TEST
+
+/*~-------------------------------------------------------------------------~-*
+ * Formatting options
+ * vim: set tabstop=2 shiftwidth=2 expandtab :
+ *~-------------------------------------------------------------------------~-*/
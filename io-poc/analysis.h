@@ -1,14 +1,25 @@
 #pragma once
 
 #include <io-poc/control/control.h>
+#include <io-poc/fields.h>
 #include <unistd.h>
 
 using namespace io_poc;
 
 int
 poynting_flux(int argc, char ** argv) {
-  usleep(200000);
-  std::cout << "analyze: poynting_flux" << std::endl;
+  // The flux is computed in situ from a snapshot, while the next phases
+  // of the step run.
+  auto & control = control_t::instance();
+  control.pipeline().submit(
+    snapshot_fields(), [](const field_snapshot_t & snapshot) {
+      usleep(200000);
+      double energy = 0.0;
+      for(auto e : snapshot.electric)
+        energy += e * e;
+      std::cout << "analyze: poynting_flux step " << snapshot.step
+                << " energy " << energy << std::endl;
+    });
   return 0;
 } // poynting_flux
 
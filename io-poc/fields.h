@@ -2,13 +2,44 @@
 
 #include <io-poc/control/control.h>
 #include <unistd.h>
+#include <vector>
 
 using namespace io_poc;
 
+namespace io_poc {
+
+/*!
+  The electric field, which the analysis and I/O actions work on.
+ */
+
+inline std::vector<double> &
+electric_field() {
+  static std::vector<double> field;
+  return field;
+} // electric_field
+
+/*!
+  The state of the fields at a step, which in situ actions take a
+  snapshot of.
+ */
+
+struct field_snapshot_t {
+  size_t step;
+  std::vector<double> electric;
+}; // struct field_snapshot_t
+
+inline field_snapshot_t
+snapshot_fields() {
+  return {control_t::instance().step(), electric_field()};
+} // snapshot_fields
+
+} // namespace io_poc
+
 int
 init_fields(int argc, char ** argv) {
   usleep(200000);
   std::cout << "initialize: init_fields" << std::endl;
+  electric_field().assign(1024, 0.0);
   return 0;
 } // init_fields
 
@@ -35,6 +66,9 @@ update_fields(int argc, char ** argv) {
     std::cout << "\tadvancing whole" << std::endl;
   } // if
 
+  for(auto & e : electric_field())
+    e += 1.0;
+
   return 0;
 } // update_fields
 
@@ -11,14 +11,23 @@
 #endif
 
 #include <io-poc/control/control.h>
+#include <io-poc/fields.h>
 #include <unistd.h>
 
 using namespace io_poc;
 
 int
 restart_dump(int argc, char ** argv) {
-  usleep(200000);
-  std::cout << "io: restart_dump" << std::endl;
+  // The restart is written in situ from a snapshot, while the next
+  // phases of the step run.
+  auto & control = control_t::instance();
+  control.pipeline().submit(
+    snapshot_fields(), [](const field_snapshot_t & snapshot) {
+      usleep(200000);
+      std::cout << "io: restart_dump step " << snapshot.step << " ("
+                << snapshot.electric.size() * sizeof(double) << " bytes)"
+                << std::endl;
+    });
   return 0;
 } // restart_dump
 